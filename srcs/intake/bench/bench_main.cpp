@@ -0,0 +1,212 @@
+// Benchmark driver for the intake pipeline's real workloads. Each benchmark
+// runs until it has accumulated enough wall time for a stable mean, then
+// reports JSON lines to bench_output.txt (already in .gitignore) and compares
+// against the committed baseline so a perf change is quantified before it
+// ships to an event.
+//
+// Usage: intake_bench [output-path] [baseline-path]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "intake/blake2b.hpp"
+#include "intake/columnar_cache.hpp"
+#include "intake/mmap_file.hpp"
+#include "intake/pdf_extractor.hpp"
+#include "intake/thread_pool.hpp"
+#include "intake/validator.hpp"
+#include "intake/xlsx_reader.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct BenchResult {
+    std::string name;
+    std::uint64_t iterations = 0;
+    double ns_per_iter = 0;
+    double mb_per_sec = 0; // 0 when the benchmark has no byte count
+};
+
+using BenchFn = std::function<std::uint64_t()>; // returns bytes processed
+
+BenchResult run_bench(const std::string& name, const BenchFn& fn,
+                      double min_seconds = 0.5) {
+    using clock = std::chrono::steady_clock;
+    // Warm-up iteration: page caches, allocator pools.
+    std::uint64_t bytes_per_iter = fn();
+
+    std::uint64_t iters = 0;
+    const auto start = clock::now();
+    double elapsed = 0;
+    while (elapsed < min_seconds) {
+        fn();
+        ++iters;
+        elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    }
+
+    BenchResult r;
+    r.name = name;
+    r.iterations = iters;
+    r.ns_per_iter = elapsed * 1e9 / static_cast<double>(iters);
+    if (bytes_per_iter != 0)
+        r.mb_per_sec = static_cast<double>(bytes_per_iter) *
+                       static_cast<double>(iters) / elapsed / 1e6;
+    return r;
+}
+
+std::string repo_root() {
+    // The binary runs from anywhere; resources/ sits beside srcs/.
+    fs::path p = fs::current_path();
+    while (!p.empty() && !fs::exists(p / "resources" / "reports.xlsx")) {
+        if (p == p.root_path())
+            return ".";
+        p = p.parent_path();
+    }
+    return p.string();
+}
+
+// Synthetic 200-fork tree matching the README layout.
+std::string make_fork_batch(const std::string& canvas_pdf) {
+    const fs::path base = fs::temp_directory_path() / "intake_bench_forks";
+    if (fs::exists(base / "fork_000" / "srcs" / "main.py"))
+        return base.string(); // reuse between runs
+    std::error_code ec;
+    fs::remove_all(base, ec);
+    for (int i = 0; i < 200; ++i) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "fork_%03d", i);
+        const fs::path fork = base / name;
+        fs::create_directories(fork / "srcs" / "module");
+        fs::create_directories(fork / "pitch");
+        std::ofstream(fork / "srcs" / "main.py") << "print('hi')\n";
+        std::ofstream(fork / "srcs" / "module" / "util.py") << "x = 1\n";
+        fs::copy_file(canvas_pdf, fork / "canvas.pdf",
+                      fs::copy_options::overwrite_existing);
+        fs::copy_file(canvas_pdf, fork / "pitch" / "deck.pdf",
+                      fs::copy_options::overwrite_existing);
+    }
+    return base.string();
+}
+
+std::map<std::string, double> load_baseline(const std::string& path) {
+    std::map<std::string, double> out;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        // {"name":"...","ns_per_iter":N,...}
+        const std::size_t name_at = line.find("\"name\":\"");
+        const std::size_t ns_at = line.find("\"ns_per_iter\":");
+        if (name_at == std::string::npos || ns_at == std::string::npos)
+            continue;
+        const std::size_t name_start = name_at + 8;
+        const std::size_t name_end = line.find('"', name_start);
+        out[line.substr(name_start, name_end - name_start)] =
+            std::strtod(line.c_str() + ns_at + 14, nullptr);
+    }
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::string root = repo_root();
+    const std::string out_path =
+        argc > 1 ? argv[1] : root + "/bench_output.txt";
+    const std::string baseline_path =
+        argc > 2 ? argv[2] : root + "/srcs/intake/bench/baseline.json";
+
+    const std::string reports = root + "/resources/reports.xlsx";
+    const std::string canvas =
+        root + "/resources/Digi_Edu_Hack_Solution_Canvas_2025.pdf";
+    const std::string guidelines =
+        root + "/resources/DigiEduHack_solution_guidelines.pdf";
+
+    intake::ThreadPool pool;
+    std::vector<BenchResult> results;
+
+    results.push_back(run_bench("xlsx_scan_reports", [&] {
+        intake::XlsxReader reader(reports);
+        std::uint64_t cells = 0;
+        for (const std::string& sheet : reader.sheet_names())
+            reader.for_each_row(sheet,
+                                [&](std::uint32_t,
+                                    std::span<const intake::CellView> cs) {
+                                    cells += cs.size();
+                                });
+        return fs::file_size(reports);
+    }));
+
+    for (const auto& [name, path] :
+         {std::pair<const char*, const std::string&>{"pdf_extract_canvas",
+                                                     canvas},
+          {"pdf_extract_guidelines", guidelines}}) {
+        results.push_back(run_bench(name, [&, path = path] {
+            intake::PdfExtractor ex(pool);
+            std::uint64_t bytes = 0;
+            ex.extract_file(path, [&](std::uint32_t, std::string_view t) {
+                bytes += t.size();
+            });
+            return fs::file_size(path);
+        }));
+    }
+
+    const std::string forks = make_fork_batch(canvas);
+    results.push_back(run_bench("validate_200_forks", [&] {
+        intake::SubmissionValidator validator(pool);
+        std::vector<intake::ForkRef> refs;
+        for (int i = 0; i < 200; ++i) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "fork_%03d", i);
+            refs.push_back({forks + "/" + name, "team-" + std::to_string(i)});
+        }
+        auto reports_out = validator.validate_batch(refs);
+        return static_cast<std::uint64_t>(reports_out.size());
+    }));
+
+    results.push_back(run_bench("blake2b_hash_pitch_corpus", [&] {
+        intake::MmapFile a(canvas), b(guidelines);
+        intake::Blake2b::hash(a.view());
+        intake::Blake2b::hash(b.view());
+        return a.size() + b.size();
+    }));
+
+    results.push_back(run_bench("columnar_cache_reopen", [&] {
+        auto cache = intake::ColumnarCache::open_or_build(
+            reports, (fs::temp_directory_path() / "bench.colcache").string());
+        return fs::file_size(reports);
+    }));
+
+    // Report + machine-readable output + baseline comparison.
+    const std::map<std::string, double> baseline = load_baseline(baseline_path);
+    std::ofstream out(out_path, std::ios::trunc);
+    std::printf("%-28s %12s %12s %10s %9s\n", "benchmark", "iters", "ns/iter",
+                "MB/s", "vs base");
+    for (const BenchResult& r : results) {
+        out << "{\"name\":\"" << r.name << "\",\"iterations\":" << r.iterations
+            << ",\"ns_per_iter\":" << static_cast<std::uint64_t>(r.ns_per_iter)
+            << ",\"mb_per_sec\":" << static_cast<std::uint64_t>(r.mb_per_sec)
+            << "}\n";
+        std::string delta = "n/a";
+        auto it = baseline.find(r.name);
+        if (it != baseline.end() && it->second > 0) {
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "%+.1f%%",
+                          (r.ns_per_iter - it->second) / it->second * 100.0);
+            delta = buf;
+        }
+        std::printf("%-28s %12llu %12.0f %10.1f %9s\n", r.name.c_str(),
+                    static_cast<unsigned long long>(r.iterations),
+                    r.ns_per_iter, r.mb_per_sec, delta.c_str());
+    }
+    std::printf("\nresults written to %s\n", out_path.c_str());
+    return 0;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "intake/columnar_cache.hpp"
+
+namespace intake::agg {
+
+// Aggregation kernels over the columnar cache's numeric columns. The cache
+// stores a column as a contiguous f64 vector with NaN for empty cells, so
+// the kernels run straight over the mapping: AVX2 where the CPU has it
+// (the ordered-compare mask drops NaN lanes without a branch), scalar
+// elsewhere. Dispatch happens once at load via cpuid, like xmlscan.
+
+struct Summary {
+    std::uint64_t count = 0; // non-empty cells
+    double sum = 0.0;
+    double min = 0.0; // meaningless when count == 0
+    double max = 0.0;
+
+    double mean() const { return count ? sum / static_cast<double>(count) : 0.0; }
+};
+
+// One pass: count, sum, min, max of the non-NaN values.
+Summary summarize(const double* values, std::size_t n);
+
+inline Summary summarize(std::span<const double> values) {
+    return summarize(values.data(), values.size());
+}
+
+// q-quantile (0 <= q <= 1, linear interpolation) of the non-NaN values;
+// NaN when the column is empty. Selection is nth_element over a scratch
+// copy — percentiles are dashboard-refresh work, not per-score work.
+double quantile(std::span<const double> values, double q);
+
+// Per-team score aggregation with incremental updates: built once from a
+// sheet's (team, score) column pair, then add_score() folds a single new
+// score in and re-ranks just that team — the leaderboard never recomputes
+// the sheet. Means are exact under increments; ranking is mean-descending
+// with count as tiebreak.
+class Leaderboard {
+public:
+    struct Entry {
+        std::string_view team; // view into the cache's string table for
+                               // sheet teams, into names_ for new ones
+        double sum = 0.0;
+        std::uint64_t count = 0;
+
+        double mean() const {
+            return count ? sum / static_cast<double>(count) : 0.0;
+        }
+    };
+
+    // Aggregates `score_col` grouped by `team_col` over the sheet's data
+    // rows. Throws std::runtime_error when the sheet or columns are
+    // missing or of the wrong type.
+    Leaderboard(const ColumnarCache& cache, std::string_view sheet,
+                std::string_view team_col, std::string_view score_col);
+
+    // Folds one new score in; unknown teams are appended. The ranking is
+    // repaired by swapping the team toward its new position.
+    void add_score(std::string_view team, double value);
+
+    // Entries in rank order (best mean first).
+    const Entry& at_rank(std::size_t rank) const {
+        return entries_[ranking_[rank]];
+    }
+    std::size_t team_count() const { return entries_.size(); }
+
+    // Current rank of a team, or npos if unknown.
+    std::size_t rank_of(std::string_view team) const;
+
+private:
+    void repair_rank(std::size_t entry_index);
+    static bool ranks_before(const Entry& a, const Entry& b);
+
+    std::vector<Entry> entries_;
+    std::vector<std::uint32_t> ranking_;    // entry indexes, best first
+    std::vector<std::uint32_t> rank_of_;    // entry index -> rank
+    std::unordered_map<std::string_view, std::uint32_t> by_team_;
+    std::vector<std::unique_ptr<std::string>> names_; // backing for new teams
+};
+
+} // namespace intake::agg
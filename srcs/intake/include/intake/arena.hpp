@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace intake {
+
+// Per-task bump allocator for the parsing hot paths. Allocation is a pointer
+// bump; nothing is freed individually — reset() drops everything at once
+// when the document or directory walk completes. String views handed out by
+// copy()/concat() stay valid until the next reset, which is exactly the
+// task lifetime the parsers need.
+class Arena {
+public:
+    explicit Arena(std::size_t first_block = 64 * 1024)
+        : first_block_size_(first_block) {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    Arena(Arena&&) = default;
+    Arena& operator=(Arena&&) = default;
+
+    void* allocate(std::size_t size,
+                   std::size_t align = alignof(std::max_align_t)) {
+        if (!blocks_.empty()) {
+            Block& b = blocks_.back();
+            const std::size_t aligned = (b.used + align - 1) & ~(align - 1);
+            if (aligned + size <= b.size) {
+                b.used = aligned + size;
+                return b.data.get() + aligned;
+            }
+        }
+        return allocate_slow(size, align);
+    }
+
+    template <typename T> T* allocate_array(std::size_t count) {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // Copies `s` into the arena; the view lives until reset().
+    std::string_view copy(std::string_view s) {
+        if (s.empty())
+            return {};
+        char* p = static_cast<char*>(allocate(s.size(), 1));
+        memcpy(p, s.data(), s.size());
+        return {p, s.size()};
+    }
+
+    std::string_view concat(std::string_view a, std::string_view b) {
+        char* p = static_cast<char*>(allocate(a.size() + b.size(), 1));
+        memcpy(p, a.data(), a.size());
+        memcpy(p + a.size(), b.data(), b.size());
+        return {p, a.size() + b.size()};
+    }
+
+    // Drops every allocation, keeping the largest block for reuse so a
+    // steady-state task loop stops touching malloc entirely.
+    void reset() {
+        if (blocks_.empty())
+            return;
+        std::size_t largest = 0;
+        for (std::size_t i = 1; i < blocks_.size(); ++i)
+            if (blocks_[i].size > blocks_[largest].size)
+                largest = i;
+        Block keep = std::move(blocks_[largest]);
+        keep.used = 0;
+        blocks_.clear();
+        blocks_.push_back(std::move(keep));
+        bytes_used_ = 0;
+    }
+
+    std::size_t bytes_reserved() const {
+        std::size_t total = 0;
+        for (const Block& b : blocks_)
+            total += b.size;
+        return total;
+    }
+
+private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        std::size_t size = 0;
+        std::size_t used = 0;
+    };
+
+    void* allocate_slow(std::size_t size, std::size_t align) {
+        std::size_t block_size =
+            blocks_.empty() ? first_block_size_ : blocks_.back().size * 2;
+        if (block_size < size + align)
+            block_size = size + align; // oversized request: dedicated block
+        Block b;
+        b.data = std::make_unique<char[]>(block_size);
+        b.size = block_size;
+        blocks_.push_back(std::move(b));
+        Block& nb = blocks_.back();
+        // Fresh char[] storage is aligned for max_align_t; offset within the
+        // block keeps that for any align <= max_align_t.
+        const std::uintptr_t base =
+            reinterpret_cast<std::uintptr_t>(nb.data.get());
+        const std::size_t aligned =
+            ((base + align - 1) & ~(align - 1)) - base;
+        nb.used = aligned + size;
+        bytes_used_ += size;
+        return nb.data.get() + aligned;
+    }
+
+    std::size_t first_block_size_;
+    std::vector<Block> blocks_;
+    std::size_t bytes_used_ = 0;
+};
+
+// Grow-in-place string builder over an arena: appends extend the last
+// allocation when nothing else allocated in between, so assembling a
+// multi-run shared string costs no copies beyond the bytes themselves.
+class ArenaStringBuilder {
+public:
+    explicit ArenaStringBuilder(Arena& arena) : arena_(arena) {}
+
+    void clear() {
+        data_ = nullptr;
+        size_ = 0;
+        capacity_ = 0;
+    }
+
+    void append(std::string_view s) {
+        if (size_ + s.size() > capacity_)
+            grow(size_ + s.size());
+        memcpy(data_ + size_, s.data(), s.size());
+        size_ += s.size();
+    }
+
+    void push_back(char c) { append(std::string_view(&c, 1)); }
+
+    std::string_view view() const { return {data_, size_}; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    void grow(std::size_t need) {
+        std::size_t cap = capacity_ == 0 ? 64 : capacity_ * 2;
+        if (cap < need)
+            cap = need;
+        char* p = static_cast<char*>(arena_.allocate(cap, 1));
+        if (size_ != 0)
+            memcpy(p, data_, size_);
+        data_ = p;
+        capacity_ = cap;
+    }
+
+    Arena& arena_;
+    char* data_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t capacity_ = 0;
+};
+
+} // namespace intake
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace intake {
+
+// 256-bit content digest used as the blob-store key.
+struct Digest {
+    std::array<std::uint8_t, 32> bytes{};
+
+    std::string hex() const;
+    static std::optional<Digest> from_hex(std::string_view hex);
+
+    bool operator==(const Digest&) const = default;
+};
+
+// BLAKE2b-256 (RFC 7693). Self-contained so the intake boxes need no extra
+// crypto dependency; incremental interface for streamed inputs.
+class Blake2b {
+public:
+    Blake2b();
+    void update(const void* data, std::size_t len);
+    void update(std::string_view data) { update(data.data(), data.size()); }
+    Digest finish();
+
+    static Digest hash(std::string_view data);
+
+private:
+    void compress(const std::uint8_t* block, bool last);
+
+    std::array<std::uint64_t, 8> h_{};
+    std::array<std::uint64_t, 2> t_{};
+    std::array<std::uint8_t, 128> buf_{};
+    std::size_t buf_len_ = 0;
+};
+
+} // namespace intake
+
+template <> struct std::hash<intake::Digest> {
+    std::size_t operator()(const intake::Digest& d) const noexcept {
+        std::size_t v;
+        __builtin_memcpy(&v, d.bytes.data(), sizeof(v));
+        return v;
+    }
+};
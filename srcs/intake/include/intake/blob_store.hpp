@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "intake/blake2b.hpp"
+#include "intake/mmap_file.hpp"
+
+namespace intake {
+
+// Content-addressed blob store the intake pipeline writes through. Objects
+// live under <root>/objects/<hh>/<rest-of-hex>; a blob whose digest already
+// exists is never rewritten, so re-pushed pitch decks and the data samples
+// mirrored into every fork cost one hash instead of one copy. Writes land in
+// a temp file and rename into place, which keeps concurrent writers of the
+// same blob safe and the store crash-consistent.
+class BlobStore {
+public:
+    struct Stats {
+        std::atomic<std::uint64_t> blobs_added{0};
+        std::atomic<std::uint64_t> bytes_added{0};
+        std::atomic<std::uint64_t> duplicates_skipped{0};
+        std::atomic<std::uint64_t> bytes_deduplicated{0};
+    };
+
+    // Creates the store layout under `root` if needed. Throws
+    // std::runtime_error when the directories cannot be created.
+    explicit BlobStore(std::string root);
+
+    // Hashes and stores the file / bytes; returns the digest either way.
+    Digest put_file(const std::string& path);
+    Digest put_bytes(std::string_view data);
+
+    bool contains(const Digest& digest) const;
+    std::string object_path(const Digest& digest) const;
+
+    // Maps a stored blob read-only. Throws if the digest is not present.
+    MmapFile open(const Digest& digest) const;
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    Digest store(std::string_view data);
+
+    std::string root_;
+    Stats stats_;
+};
+
+} // namespace intake
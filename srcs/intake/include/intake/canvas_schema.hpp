@@ -0,0 +1,128 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace intake::canvas {
+
+// The solution canvas is a fixed form per edition, so the field layout is a
+// constexpr table instead of anything discovered per document. Extraction
+// compiles down to anchor matching over the page text: the schema loop is
+// unrolled at compile time, field indices resolve with consteval, and a new
+// edition is a new schema struct plus a recompile.
+
+enum class FieldKind : std::uint8_t {
+    Short, // one-line answer (team name, title, ...)
+    Long,  // free-text section
+};
+
+struct Field {
+    std::string_view name;   // stable key used by downstream consumers
+    std::string_view anchor; // label text as it appears in the extracted page
+    FieldKind kind;
+    std::uint32_t page; // 1-based, matching PdfExtractor's page numbers
+    bool required;
+};
+
+// Layout of Digi_Edu_Hack_Solution_Canvas_2025.pdf. Anchors are the exact
+// label runs the extractor produces for that file.
+struct Schema2025 {
+    static constexpr std::string_view edition = "2025";
+    static constexpr std::array<Field, 5> fields = {{
+        {"title", "Title of the solution:", FieldKind::Short, 1, true},
+        {"challenge", "Challenge addressed:", FieldKind::Short, 1, true},
+        {"team_name", "Team name:", FieldKind::Short, 1, true},
+        {"challenge_category", "Challenge category:", FieldKind::Short, 1,
+         true},
+        {"team_background", "Background of the team:", FieldKind::Long, 1,
+         false},
+    }};
+};
+
+// Compile-time field lookup; a bad name fails the build, not the event.
+template <typename Schema>
+consteval std::size_t field_index(std::string_view name) {
+    for (std::size_t i = 0; i < Schema::fields.size(); ++i)
+        if (Schema::fields[i].name == name)
+            return i;
+    throw "no such canvas field"; // not constant-evaluable -> compile error
+}
+
+// One submission's canvas, filled by feeding extracted page text through
+// the schema. A field's value is the text between its anchor and the next
+// anchor on the page — on a blank form that is empty, which is exactly what
+// required-field validation wants to see.
+template <typename Schema> class CanvasForm {
+public:
+    static constexpr std::size_t field_count = Schema::fields.size();
+
+    // Feed one extracted page (PdfExtractor page numbers). Pages without
+    // schema fields are ignored; feeding pages out of order is fine.
+    void feed_page(std::uint32_t page, std::string_view text) {
+        // Anchor positions on this page, schema loop unrolled at compile
+        // time. npos marks fields whose anchor is missing from the text.
+        std::array<std::size_t, field_count> at;
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            ((at[I] = Schema::fields[I].page == page
+                          ? text.find(Schema::fields[I].anchor)
+                          : std::string_view::npos),
+             ...);
+        }(std::make_index_sequence<field_count>{});
+
+        for (std::size_t i = 0; i < field_count; ++i) {
+            if (at[i] == std::string_view::npos)
+                continue;
+            found_[i] = true;
+            std::size_t begin = at[i] + Schema::fields[i].anchor.size();
+            // Value runs until the nearest following anchor.
+            std::size_t end = text.size();
+            for (std::size_t j = 0; j < field_count; ++j)
+                if (j != i && at[j] != std::string_view::npos &&
+                    at[j] >= begin && at[j] < end)
+                    end = at[j];
+            values_[i] = trim(text.substr(begin, end - begin));
+        }
+    }
+
+    // Compile-time indexed access: form.get<field_index<Schema>("title")>().
+    template <std::size_t I> std::string_view get() const {
+        static_assert(I < field_count);
+        return values_[I];
+    }
+
+    std::string_view value(std::size_t index) const { return values_[index]; }
+    bool anchor_found(std::size_t index) const { return found_[index]; }
+
+    // Names of required fields that are absent or empty — the canvas-level
+    // complement to the file-level submission checks.
+    std::vector<std::string_view> missing_required() const {
+        std::vector<std::string_view> out;
+        for (std::size_t i = 0; i < field_count; ++i)
+            if (Schema::fields[i].required && values_[i].empty())
+                out.push_back(Schema::fields[i].name);
+        return out;
+    }
+
+private:
+    static std::string trim(std::string_view s) {
+        std::size_t b = 0, e = s.size();
+        while (b < e && (s[b] == ' ' || s[b] == '\n' || s[b] == '\r' ||
+                         s[b] == '\t'))
+            ++b;
+        while (e > b && (s[e - 1] == ' ' || s[e - 1] == '\n' ||
+                         s[e - 1] == '\r' || s[e - 1] == '\t'))
+            --e;
+        return std::string(s.substr(b, e - b));
+    }
+
+    std::array<std::string, field_count> values_;
+    std::array<bool, field_count> found_{};
+};
+
+using Canvas2025 = CanvasForm<Schema2025>;
+
+} // namespace intake::canvas
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "intake/blake2b.hpp"
+#include "intake/mmap_file.hpp"
+
+namespace intake {
+
+// One-time conversion of a judging workbook into a memory-mappable columnar
+// cache that every scoring worker opens read-only. Layout (little-endian,
+// 8-byte aligned sections):
+//
+//   FileHeader
+//   per sheet: SheetRec, then one ColRec per column
+//   column payloads: f64 vectors (NaN = empty) or u32 string ids
+//   interned string table: u64 count, u64 offsets[count+1], bytes
+//
+// The header records the source xlsx's size, mtime and BLAKE2b digest;
+// open_or_build() revalidates by size+mtime first and only re-hashes when
+// the mtime moved, so a cold worker reaches first query in milliseconds.
+class ColumnarCache {
+public:
+    enum class ColumnType : std::uint32_t { Number = 0, String = 1 };
+
+    struct Column {
+        ColumnType type;
+        std::string_view name;        // from the xlsx header row
+        const double* numbers;        // valid when type == Number
+        const std::uint32_t* strings; // valid when type == String
+    };
+
+    struct Sheet {
+        std::string_view name;
+        std::uint64_t rows = 0; // includes the header row (row 0)
+        std::vector<Column> columns;
+    };
+
+    // Opens the cache at `cache_path`, rebuilding it from `xlsx_path` when
+    // missing or stale. Throws std::runtime_error on unreadable inputs.
+    static ColumnarCache open_or_build(const std::string& xlsx_path,
+                                       const std::string& cache_path);
+
+    // Opens an existing cache without staleness checks (for replicas and
+    // snapshots). Throws if the file is missing or malformed.
+    static ColumnarCache open(const std::string& cache_path);
+
+    const std::vector<Sheet>& sheets() const { return sheets_; }
+    const Sheet* sheet(std::string_view name) const;
+
+    std::string_view string_at(std::uint32_t id) const;
+    std::uint64_t string_count() const { return string_count_; }
+
+    // Cache generation: digest of the source workbook, usable as an ETag.
+    const Digest& source_digest() const { return source_digest_; }
+
+    static constexpr std::uint32_t kNoString = 0; // id 0 interns ""
+
+private:
+    ColumnarCache() = default;
+    void attach(MmapFile file);
+
+    MmapFile file_;
+    std::vector<Sheet> sheets_;
+    const std::uint64_t* string_offsets_ = nullptr;
+    const char* string_bytes_ = nullptr;
+    std::uint64_t string_count_ = 0;
+    Digest source_digest_;
+};
+
+} // namespace intake
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "intake/blake2b.hpp"
+
+namespace intake {
+
+// Async download engine for mirroring the challenge data samples. One epoll
+// loop drives every connection; large files split into parallel HTTP range
+// requests once the first response reveals the total size, completed ranges
+// are journaled to a sidecar so an interrupted mirror resumes where it
+// stopped, and finished files verify against the manifest digest. TLS goes
+// through OpenSSL in non-blocking mode on the same loop.
+class Downloader {
+public:
+    struct Options {
+        std::size_t max_connections = 8;   // across all files
+        std::size_t chunk_size = 8 << 20;  // range size for parallel fetch
+        int max_redirects = 5;
+        int max_retries = 3;
+        bool verify_tls = true;
+    };
+
+    struct Item {
+        std::string url;  // http:// or https://
+        std::string dest; // local path; "<dest>.progress" journals resume
+        std::optional<Digest> digest; // verify after completion when set
+    };
+
+    struct Result {
+        std::string url;
+        std::string dest;
+        bool ok = false;
+        std::uint64_t bytes = 0; // bytes transferred this run (resume skips)
+        std::string error;       // set when !ok
+    };
+
+    Downloader() : Downloader(Options{}) {}
+    explicit Downloader(Options options);
+
+    // Runs the event loop on the calling thread until every item finishes
+    // or fails. Items download concurrently up to max_connections.
+    std::vector<Result> fetch(std::span<const Item> items);
+
+private:
+    Options options_;
+};
+
+} // namespace intake
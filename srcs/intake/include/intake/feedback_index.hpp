@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "intake/columnar_cache.hpp"
+
+namespace intake {
+
+// Substring index over one sheet of a columnar cache, built for the
+// judging-floor query "show all feedback mentioning X". The cache's
+// interned string ids are the unit of indexing: each distinct string is
+// shingled into case-folded trigrams once, postings are flat sorted id
+// arrays, and a query intersects its trigram postings before verifying the
+// handful of surviving candidates. Rebuild cost is one pass over the sheet,
+// so refreshing on workbook change is invisible.
+//
+// All tables are flat, sorted and position-independent, so an index can
+// either own them (built from the cache) or view them inside a mapped warm
+// snapshot — the snapshot constructor touches no table pages, leaving the
+// kernel to fault them in on first query.
+class FeedbackIndex {
+public:
+    struct Match {
+        std::uint32_t row; // data row in the sheet (0 = first row below header)
+        std::uint32_t col;
+        std::string_view text; // view into the cache's string table
+    };
+
+    // Indexes every string column of `sheet_name`. Throws std::runtime_error
+    // if the sheet does not exist in the cache. The cache must outlive the
+    // index — postings reference its string table.
+    FeedbackIndex(const ColumnarCache& cache, std::string_view sheet_name);
+
+    // Reattaches an index serialized by serialize() — tables stay views into
+    // `blob`, which must outlive the index (it is a slice of a mapped warm
+    // snapshot). Throws std::runtime_error when the blob is malformed or was
+    // built against a cache with a different string table size.
+    FeedbackIndex(const ColumnarCache& cache, const void* blob,
+                  std::size_t len);
+
+    // Appends the index's tables to `out` in the mmap-able layout the blob
+    // constructor expects (five u64 counts, then the arrays, 8-byte aligned).
+    void serialize(std::string& out) const;
+
+    // Case-insensitive substring search; matches come back in row order.
+    // Queries shorter than one trigram fall back to a scan of the distinct
+    // strings, which is still far smaller than a sheet re-scan.
+    std::vector<Match> search(std::string_view query) const;
+
+    std::size_t distinct_strings() const { return indexed_ids_.size(); }
+    std::size_t trigram_count() const { return grams_.size(); }
+
+private:
+    // Occurrences of one string id inside the sheet, flattened.
+    struct Occurrence {
+        std::uint32_t row;
+        std::uint32_t col;
+    };
+
+    // Trigram key (3 folded bytes, little-endian packed) -> slice of
+    // posting_ids_. Sorted by gram; lookups binary-search.
+    struct GramRange {
+        std::uint32_t gram;
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
+
+    // String id -> slice of occurrences_. Sorted by id.
+    struct OccRange {
+        std::uint32_t id;
+        std::uint32_t offset;
+        std::uint32_t length;
+    };
+
+    void collect_candidates(std::string_view folded,
+                            std::vector<std::uint32_t>& out) const;
+    void append_matches(std::uint32_t id, std::vector<Match>& out) const;
+
+    const ColumnarCache& cache_;
+
+    // Owned storage when built from the cache; empty when the spans view a
+    // mapped snapshot. Moving the vectors keeps their buffers, so a moved
+    // index stays valid either way.
+    std::vector<std::uint32_t> own_ids_;
+    std::vector<GramRange> own_grams_;
+    std::vector<std::uint32_t> own_posting_ids_;
+    std::vector<OccRange> own_occ_ranges_;
+    std::vector<Occurrence> own_occurrences_;
+
+    std::span<const std::uint32_t> indexed_ids_; // distinct ids, ascending
+    std::span<const GramRange> grams_;
+    std::span<const std::uint32_t> posting_ids_; // flat, sorted per trigram
+    std::span<const OccRange> occ_ranges_;
+    std::span<const Occurrence> occurrences_;
+};
+
+} // namespace intake
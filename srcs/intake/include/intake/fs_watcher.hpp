@@ -0,0 +1,89 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <mutex>
+
+namespace intake {
+
+// Inotify watcher over the mirrored fork checkouts. Watches are installed
+// recursively on each root, new subdirectories picked up as they appear,
+// and events are coalesced per directory: a directory only leaves the
+// pending set once it has been quiet for `debounce` (capped at `max_delay`
+// since its first event, so a steady editor save storm still flushes).
+// A `git checkout` touching a thousand files therefore surfaces as one
+// batch of dirty directories, not a thousand re-index jobs. This replaces
+// the 60-second polling rescan.
+//
+// The batch callback runs on the watcher's own thread; it should hand the
+// directories to the scheduler, not re-index inline.
+class FsWatcher {
+public:
+    struct Options {
+        std::vector<std::string> roots; // e.g. {"mirror/srcs", "mirror/pitch"}
+        std::chrono::milliseconds debounce{200};
+        std::chrono::milliseconds max_delay{2000}; // flush cap under churn
+    };
+
+    // Directories with pending changes, relative paths as watched (root
+    // prefix included). Views are valid for the duration of the call.
+    using BatchFn = std::function<void(std::span<const std::string> dirs)>;
+
+    struct Stats {
+        std::uint64_t events = 0;      // inotify events consumed
+        std::uint64_t batches = 0;     // callback invocations
+        std::uint64_t directories = 0; // dirty directories flushed
+        std::uint64_t overflows = 0;   // kernel queue overflows (full rescan)
+    };
+
+    // Installs the watches and starts the event thread. Throws
+    // std::runtime_error when a root cannot be watched.
+    FsWatcher(Options options, BatchFn on_batch);
+    ~FsWatcher(); // stops and joins
+
+    FsWatcher(const FsWatcher&) = delete;
+    FsWatcher& operator=(const FsWatcher&) = delete;
+
+    // Stops the event thread after flushing anything pending. Idempotent.
+    void stop();
+
+    Stats stats() const;
+
+private:
+    struct Pending {
+        std::chrono::steady_clock::time_point first;
+        std::chrono::steady_clock::time_point last;
+    };
+
+    void watch_tree(const std::string& dir);
+    int add_watch(const std::string& dir);
+    void event_loop();
+    void consume_events();
+    void mark_dirty(std::string dir, std::chrono::steady_clock::time_point now);
+    void flush_due(std::chrono::steady_clock::time_point now, bool force);
+
+    Options options_;
+    BatchFn on_batch_;
+
+    int inotify_fd_ = -1;
+    int wake_fd_ = -1; // eventfd, poked by stop()
+
+    std::unordered_map<int, std::string> dir_by_wd_;
+    std::unordered_map<std::string, int> wd_by_dir_;
+    std::unordered_map<std::string, Pending> pending_;
+
+    mutable std::mutex stats_mu_;
+    Stats stats_;
+
+    bool stopped_ = false;
+    std::thread thread_; // started last, touches everything above
+};
+
+} // namespace intake
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "intake/validator.hpp"
+
+namespace intake {
+
+// One file pulled out of a fork, straight from packfile buffers. `data` is
+// only populated for the blobs the validator inspects byte-wise (the PDFs);
+// tree-only paths carry an empty body with `has_data == false`.
+struct RemoteFile {
+    std::string path; // repo-relative, e.g. "pitch/deck.pdf"
+    std::string data;
+    bool has_data = false;
+};
+
+// A fork tip materialized without a working tree: the commit that was
+// fetched, and the paths the intake rules care about.
+struct RemoteForkSnapshot {
+    std::string branch;
+    std::string commit_hex;
+    std::vector<RemoteFile> files;
+};
+
+// Partial-clone fetch engine for validating forks without full checkouts.
+// Speaks git wire protocol v2 over the plain git:// transport: ls-refs to
+// resolve the branch tip, a blob:none filtered fetch for the commit and
+// trees, then a second targeted fetch for just the blobs validation reads
+// (the PDFs). Everything stays in memory — no object database, no checkout.
+class GitFetchEngine {
+public:
+    struct Options {
+        std::uint16_t port = 9418;
+        int timeout_ms = 30000; // per socket operation
+    };
+
+    GitFetchEngine() : GitFetchEngine(Options{}) {}
+    explicit GitFetchEngine(Options options);
+
+    // Fetches the tip of `branch` from git://host:port/repo. `repo` is the
+    // daemon-side path, e.g. "/team-fork.git". Throws std::runtime_error on
+    // protocol or transport failure.
+    RemoteForkSnapshot fetch_fork(const std::string& host,
+                                  const std::string& repo,
+                                  const std::string& branch);
+
+    // Applies the same submission rules as SubmissionValidator, but against
+    // the in-memory snapshot instead of a working tree.
+    static ValidationReport validate_snapshot(const RemoteForkSnapshot& snap);
+
+private:
+    Options options_;
+};
+
+} // namespace intake
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "intake/columnar_cache.hpp"
+
+namespace intake {
+
+// Embedded HTTP/1.1 server for the judging dashboard: C++20 coroutines over
+// a single-threaded epoll reactor, serving views straight out of the mmap'd
+// columnar cache. Responses are rendered once per cache generation and the
+// source digest doubles as the ETag, so a dashboard refresh loop that hits
+// unchanged data gets a bodyless 304 — the steady state for 30 judges
+// polling between score updates.
+//
+// Routes:
+//   /sheets            sheet names in the cache
+//   /sheet/<name>      any sheet as column-named JSON rows
+//   /attendance        alias for Attendance_checklist
+//   /feedback          alias for Feedback_Forms
+//   /scoring           alias for Examples of Reports
+class HttpServer {
+public:
+    struct Options {
+        std::uint16_t port = 8080; // 0 binds an ephemeral port
+        int backlog = 128;
+    };
+
+    HttpServer(const ColumnarCache& cache) : HttpServer(cache, Options{}) {}
+    // Binds and listens immediately; throws std::runtime_error on failure.
+    HttpServer(const ColumnarCache& cache, Options options);
+    ~HttpServer();
+
+    HttpServer(const HttpServer&) = delete;
+    HttpServer& operator=(const HttpServer&) = delete;
+
+    // Runs the reactor loop on the calling thread until stop() is called.
+    void run();
+    // Thread-safe; wakes the loop and lets run() return.
+    void stop();
+
+    std::uint16_t port() const;            // actual bound port
+    std::uint64_t requests_served() const; // includes 304s
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace intake
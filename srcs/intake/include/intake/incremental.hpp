@@ -0,0 +1,72 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "intake/blake2b.hpp"
+#include "intake/thread_pool.hpp"
+#include "intake/validator.hpp"
+
+namespace intake {
+
+// Per-fork manifest of content hashes from the previous validation run.
+// Plain text, one "hex<TAB>size<TAB>path" line per file, written atomically.
+class FileManifest {
+public:
+    struct Entry {
+        Digest digest;
+        std::uint64_t size = 0;
+    };
+
+    // Returns an empty manifest when the file does not exist; throws only on
+    // a present-but-corrupt file.
+    static FileManifest load(const std::string& path);
+    void save(const std::string& path) const;
+
+    const Entry* find(std::string_view rel_path) const;
+    void set(std::string rel_path, Entry entry);
+
+    const std::map<std::string, Entry, std::less<>>& entries() const {
+        return entries_;
+    }
+
+private:
+    std::map<std::string, Entry, std::less<>> entries_;
+};
+
+// Result of an incremental run. When nothing changed the full validation is
+// skipped entirely and `validation_ran` is false.
+struct DeltaReport {
+    std::vector<std::string> changed; // new or content-changed paths
+    std::vector<std::string> removed;
+    bool canvas_changed = false; // root canvas PDF differs byte-wise
+    bool validation_ran = false;
+    ValidationReport validation; // meaningful when validation_ran
+
+    bool unchanged() const { return changed.empty() && removed.empty(); }
+};
+
+// Re-validation driver for pull request updates. Hashes the fork's tree in
+// parallel, diffs against the stored manifest, and only runs the full
+// validator when content actually moved — a push that touches nothing turns
+// the 30-second full pass into a hash-and-compare delta check. The
+// `canvas_changed` flag lets callers skip PDF re-extraction for
+// byte-identical canvases.
+class IncrementalValidator {
+public:
+    IncrementalValidator(ThreadPool& pool, std::string manifest_dir);
+
+    DeltaReport revalidate(const ForkRef& fork);
+
+    // Where the manifest for `fork` lives (keyed by a digest of root+branch).
+    std::string manifest_path(const ForkRef& fork) const;
+
+private:
+    ThreadPool& pool_;
+    SubmissionValidator validator_;
+    std::string manifest_dir_;
+};
+
+} // namespace intake
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "intake/arena.hpp"
+#include "intake/thread_pool.hpp"
+#include "intake/zip_reader.hpp"
+
+namespace intake {
+
+// Concurrent DEFLATE inflation for independent container parts — zip
+// entries and PDF streams don't share dictionary state, so each part can
+// inflate on its own pool worker. Output buffers come from the caller's
+// arena: parts with a known uncompressed size (zip entries carry it) are
+// carved out up front on the calling thread, so workers write straight into
+// arena memory with no allocation and no arena contention. Unknown-size
+// parts inflate into worker-local scratch and land in the arena after the
+// join.
+class ParallelInflater {
+public:
+    struct Part {
+        // Input: raw compressed bytes and format.
+        const unsigned char* data = nullptr;
+        std::size_t compressed_size = 0;
+        bool raw_deflate = true; // true for zip entries, false for zlib/gzip
+        // Known uncompressed size, or 0 to grow dynamically.
+        std::size_t uncompressed_size = 0;
+
+        // Output: inflated bytes (arena-backed) or the failure message.
+        std::string_view out;
+        std::string error;
+
+        bool ok() const { return error.empty(); }
+    };
+
+    explicit ParallelInflater(ThreadPool& pool) : pool_(pool) {}
+
+    // Inflates every part, fanning out across the pool; the calling thread
+    // helps drain. Views in `parts[i].out` stay valid until `arena` resets.
+    void inflate_all(std::span<Part> parts, Arena& arena);
+
+    // Convenience for the common container: inflates several zip entries
+    // concurrently. Stored entries come back as zero-copy views into the
+    // archive mapping without touching the pool.
+    void read_entries(const MmapFile& archive,
+                      std::span<const ZipReader::Entry* const> entries,
+                      std::span<std::string_view> out, Arena& arena);
+
+private:
+    ThreadPool& pool_;
+};
+
+} // namespace intake
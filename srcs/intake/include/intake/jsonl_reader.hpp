@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "intake/arena.hpp"
+#include "intake/mmap_file.hpp"
+
+namespace intake {
+
+// One top-level field of a JSONL record, as views into the mapped file.
+// Object and array values are kept as raw balanced slices — the event-log
+// replays only ever touch scalar fields, so nothing nested is tokenized
+// until someone asks.
+struct JsonField {
+    enum class Type : std::uint8_t {
+        String,
+        Number,
+        Bool,
+        Null,
+        Object, // raw slice including braces
+        Array,  // raw slice including brackets
+    };
+
+    std::string_view key; // escaped form, as written
+    std::string_view raw; // value bytes, quotes stripped for strings
+    Type type;
+};
+
+// A parsed record: flat field table over one line, simdjson-tape style.
+// Views live as long as the reader's mapping (raw fields) or until the next
+// record (unescaped strings, which come from the reader's arena).
+class JsonRecord {
+public:
+    std::span<const JsonField> fields() const { return fields_; }
+
+    const JsonField* find(std::string_view key) const;
+
+    // Unescaped string value; empty view when absent or not a string.
+    // Escape-free strings (the common case) come back zero-copy.
+    std::string_view string(std::string_view key) const;
+    double number(std::string_view key) const; // 0.0 when absent
+    bool boolean(std::string_view key) const;  // false when absent
+
+private:
+    friend class JsonlReader;
+    std::vector<JsonField> fields_;
+    Arena* arena_ = nullptr;
+};
+
+// Structure-aware reader for append-only JSONL event logs. The file is
+// mmap'd, record boundaries come from the SIMD newline scanner, and each
+// line is tokenized into a flat field table only when the callback runs —
+// no DOM, no allocation beyond escape materialization. for_each_record
+// returns the offset just past the last complete line, so a tailer re-opens
+// the grown file and resumes from there, paying only for the new bytes.
+class JsonlReader {
+public:
+    using RecordCallback =
+        std::function<void(std::size_t line_no, const JsonRecord& record)>;
+
+    // Throws std::runtime_error if the file cannot be mapped.
+    explicit JsonlReader(const std::string& path);
+
+    // Scans records starting at byte offset `from` (0 = whole log). Lines
+    // that are not a JSON object are skipped. Returns the resume offset.
+    std::size_t for_each_record(std::size_t from, const RecordCallback& cb);
+
+    std::size_t size() const { return file_.size(); }
+
+private:
+    MmapFile file_;
+    Arena arena_;       // escape materialization, reset per record
+    JsonRecord record_; // reused across callback invocations
+};
+
+} // namespace intake
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace intake {
+
+// Read-only memory mapping of a file. All views handed out by readers built
+// on top of a MmapFile point into the mapping and must not outlive it.
+class MmapFile {
+public:
+    MmapFile() = default;
+    // Throws std::runtime_error if the file cannot be opened or mapped.
+    explicit MmapFile(const std::string& path);
+    ~MmapFile();
+
+    MmapFile(MmapFile&& other) noexcept;
+    MmapFile& operator=(MmapFile&& other) noexcept;
+    MmapFile(const MmapFile&) = delete;
+    MmapFile& operator=(const MmapFile&) = delete;
+
+    const unsigned char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    std::string_view view() const {
+        return {reinterpret_cast<const char*>(data_), size_};
+    }
+    bool valid() const { return data_ != nullptr; }
+
+private:
+    void reset() noexcept;
+
+    const unsigned char* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+} // namespace intake
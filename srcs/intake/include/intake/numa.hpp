@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "intake/columnar_cache.hpp"
+#include "intake/thread_pool.hpp"
+
+namespace intake::numa {
+
+// Topology comes straight from /sys/devices/system/node — no libnuma
+// dependency; policy calls (mbind, get_mempolicy) go through raw syscalls
+// and degrade to no-ops on kernels or boxes without NUMA. On a single-node
+// machine everything below collapses to the plain pool/arena behavior.
+
+// Number of online NUMA nodes (>= 1).
+std::size_t node_count();
+
+// CPUs belonging to `node`, parsed from its cpulist.
+const std::vector<int>& cpus_of_node(std::size_t node);
+
+// Node owning the page behind `addr` (get_mempolicy MPOL_F_NODE|ADDR);
+// 0 when the kernel can't say.
+std::size_t node_of_address(const void* addr);
+
+// Node the calling thread is currently executing on.
+std::size_t current_node();
+
+// Restricts the calling thread to `node`'s CPUs. Returns false when the
+// affinity call is rejected (leaving placement to the OS).
+bool bind_current_thread(std::size_t node);
+
+// Arena variant whose blocks are mmap'd and bound to one node, so parser
+// scratch and task outputs stay local to the socket that processes them.
+// Same bump-allocation contract as Arena; not thread-safe.
+class NodeArena {
+public:
+    explicit NodeArena(std::size_t node, std::size_t first_block = 256 * 1024);
+    ~NodeArena();
+
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    void* allocate(std::size_t size,
+                   std::size_t align = alignof(std::max_align_t));
+    void reset(); // drops all blocks except the largest
+
+    std::size_t node() const { return node_; }
+    std::size_t bytes_reserved() const;
+
+private:
+    struct Block {
+        unsigned char* data;
+        std::size_t size;
+        std::size_t used;
+    };
+
+    void* allocate_slow(std::size_t size, std::size_t align);
+    Block map_block(std::size_t size) const;
+
+    std::size_t node_;
+    std::size_t first_block_size_;
+    std::vector<Block> blocks_;
+};
+
+// One thread pool per node, each pool's workers bound to that node's CPUs.
+// submit_for() routes a task to the node that owns its input buffer, so a
+// scan touches only local memory once the producer placed it.
+class NumaPoolSet {
+public:
+    // threads_per_node = 0 sizes each pool to its node's CPU count.
+    explicit NumaPoolSet(std::size_t threads_per_node = 0);
+
+    std::size_t nodes() const { return pools_.size(); }
+    ThreadPool& pool(std::size_t node) { return *pools_[node]; }
+
+    // Submits to the pool of the node owning `input`'s backing page.
+    void submit_for(const void* input, std::function<void()> fn);
+
+    void wait_idle();
+
+private:
+    std::vector<std::unique_ptr<ThreadPool>> pools_;
+};
+
+// Read-mostly cache replicated once per node: each replica is a memfd copy
+// of the cache file whose pages are first-touched by a thread bound to the
+// target node, so every socket scans a local copy instead of pulling half
+// its rows across the interconnect.
+class ReplicatedCache {
+public:
+    explicit ReplicatedCache(const std::string& cache_path);
+
+    const ColumnarCache& on(std::size_t node) const { return *replicas_[node]; }
+    // Replica local to the calling thread's current node.
+    const ColumnarCache& local() const { return on(current_node()); }
+    std::size_t replica_count() const { return replicas_.size(); }
+
+private:
+    std::vector<std::unique_ptr<ColumnarCache>> replicas_;
+};
+
+} // namespace intake::numa
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "intake/arena.hpp"
+#include "intake/mmap_file.hpp"
+
+namespace intake {
+
+// One commit's metadata as flat fields. String views point into the index's
+// arena and stay valid for the index's lifetime; parents are indexes into
+// commits() (kMissingParent for a parent outside the fetched packs, e.g.
+// past a shallow cutoff).
+struct CommitRecord {
+    std::int64_t author_time = 0; // unix seconds
+    std::int64_t commit_time = 0;
+    std::int32_t tz_minutes = 0;  // author timezone offset
+    std::uint32_t parent_begin = 0;
+    std::uint32_t parent_count = 0;
+    std::string_view author; // "Name <email>"
+    std::string_view oid_hex;
+};
+
+// Packfile indexer for submission history analytics. Fetched packs are
+// mmapped (or taken as in-memory buffers straight from the fetch engine),
+// every object inflates into an arena with deltas resolved against earlier
+// entries, and commits come out as flat arrays — per-team cadence questions
+// ("who worked when", last-minute push volume) become array scans instead
+// of one `git log` process per fork. Blob payloads are indexed but never
+// copied out, so a blob:none history pack for 200 forks fits comfortably.
+class PackIndex {
+public:
+    static constexpr std::uint32_t kMissingParent = 0xffffffffu;
+
+    PackIndex() = default;
+
+    PackIndex(const PackIndex&) = delete;
+    PackIndex& operator=(const PackIndex&) = delete;
+
+    // Indexes one pack. The file variant maps it for the call's duration;
+    // nothing references the mapping afterwards. Throws std::runtime_error
+    // on a corrupt pack.
+    void add_pack_file(const std::string& path);
+    void add_pack(std::string_view pack);
+
+    // Every commit across the added packs, in pack order.
+    std::span<const CommitRecord> commits() const { return commits_; }
+
+    // Flat parent table; CommitRecord::parent_begin/parent_count slice it.
+    std::span<const std::uint32_t> parents() const { return parents_; }
+
+    // Commit index for a 40-char hex id, or kMissingParent when absent.
+    std::uint32_t find(std::string_view hex) const;
+
+    // Commits reachable from `tip`, newest commit_time first. The walk
+    // stops at missing parents, so shallow histories just end early.
+    std::vector<std::uint32_t> history(std::uint32_t tip) const;
+
+    // Cadence of one reachable history: total commits, time span, and how
+    // many landed within `final_window_s` seconds of the newest commit —
+    // the last-minute push volume.
+    struct Cadence {
+        std::uint64_t total = 0;
+        std::int64_t first_time = 0;
+        std::int64_t last_time = 0;
+        std::uint64_t final_window = 0;
+    };
+    Cadence cadence(std::uint32_t tip, std::int64_t final_window_s) const;
+
+private:
+    struct Object {
+        std::uint8_t type = 0;    // pack object type, 1..4
+        std::string_view data;    // arena-backed
+    };
+
+    std::string_view inflate_into(std::string_view pack, std::size_t& pos,
+                                  std::size_t expected);
+    std::uint32_t record_commit(std::string_view raw, std::string_view data);
+    void link_parents();
+
+    Arena arena_;
+    std::vector<Object> objects_;
+    std::unordered_map<std::string, std::uint32_t> object_by_oid_; // raw 20B
+    std::vector<CommitRecord> commits_;
+    std::vector<std::uint32_t> parents_;
+    std::unordered_map<std::string_view, std::uint32_t> commit_by_hex_;
+    std::vector<std::pair<std::uint32_t, std::string>> unresolved_; // slot,oid
+};
+
+} // namespace intake
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "intake/thread_pool.hpp"
+
+namespace intake {
+
+// Streaming text extractor for submitted canvas and pitch PDFs. The file is
+// memory-mapped and the xref parsed incrementally (classic tables and 1.5+
+// xref/object streams, /Prev chains); page content streams inflate and parse
+// as independent pool tasks, so a batch of documents is bounded by core
+// count and peak memory is per worker, not per document.
+//
+// Text decoding uses each font's /ToUnicode CMap when present and falls back
+// to treating single-byte codes as Latin text otherwise; that covers the
+// office-suite producers the canvas and pitch decks come from.
+class PdfExtractor {
+public:
+    // Called once per page as its extraction completes. Pages of one
+    // document may complete out of order; `page` is the 1-based page number.
+    using PageCallback =
+        std::function<void(std::uint32_t page, std::string_view text)>;
+    using BatchCallback = std::function<void(
+        const std::string& path, std::uint32_t page, std::string_view text)>;
+    // Called when a document in a batch cannot be parsed.
+    using ErrorCallback =
+        std::function<void(const std::string& path, const std::string& error)>;
+
+    explicit PdfExtractor(ThreadPool& pool) : pool_(pool) {}
+
+    // Extracts one document; page tasks run on the pool. Throws
+    // std::runtime_error on a malformed document.
+    void extract_file(const std::string& path, const PageCallback& cb);
+
+    // Extracts a batch, one document task per file, pages nested under it.
+    // Parse failures are reported through `on_error` instead of throwing so
+    // one corrupt upload cannot abort a deadline batch.
+    void extract_batch(std::span<const std::string> paths,
+                       const BatchCallback& cb, const ErrorCallback& on_error);
+
+private:
+    ThreadPool& pool_;
+};
+
+} // namespace intake
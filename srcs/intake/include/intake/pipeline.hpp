@@ -0,0 +1,60 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "intake/blob_store.hpp"
+#include "intake/incremental.hpp"
+#include "intake/pdf_extractor.hpp"
+#include "intake/scheduler.hpp"
+#include "intake/thread_pool.hpp"
+#include "intake/validator.hpp"
+
+namespace intake {
+
+// Everything one submission produced on its way through the pipeline.
+struct SubmissionOutcome {
+    ForkRef fork;
+    DeltaReport delta;
+    std::vector<Digest> stored_pdfs; // canvas + pitch blobs written through
+    std::vector<std::pair<std::uint32_t, std::string>> canvas_pages;
+    std::string error; // non-empty if a stage failed hard
+
+    bool ok() const {
+        return error.empty() &&
+               (!delta.validation_ran || delta.validation.ok());
+    }
+};
+
+// Wires one submission through hash -> validate -> extract -> done as a task
+// DAG on the scheduler, replacing the old stage-by-stage batch scripts. The
+// hash and validate stages run in parallel per submission; extraction waits
+// on validation so byte-identical canvases are skipped; the completion task
+// fires when both branches are in. Many submissions enqueue independently,
+// so the deadline burst keeps every core busy instead of idling between
+// stages.
+class IntakePipeline {
+public:
+    using DoneFn = std::function<void(std::shared_ptr<SubmissionOutcome>)>;
+
+    IntakePipeline(Scheduler& scheduler, ThreadPool& pool, BlobStore& blobs,
+                   IncrementalValidator& validator, PdfExtractor& extractor)
+        : scheduler_(scheduler), pool_(pool), blobs_(blobs),
+          validator_(validator), extractor_(extractor) {}
+
+    // Enqueues the submission's DAG; `on_done` runs as the final task.
+    // Returns the completion task for dependency chaining.
+    Scheduler::TaskId enqueue(ForkRef fork, DoneFn on_done);
+
+private:
+    Scheduler& scheduler_;
+    ThreadPool& pool_;
+    BlobStore& blobs_;
+    IncrementalValidator& validator_;
+    PdfExtractor& extractor_;
+};
+
+} // namespace intake
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace intake {
+
+// Cold-cache readahead for batch scans. The pipeline publishes each DAG's
+// input file list before submitting its tasks; a single prefetch thread
+// walks the lists in publish order and issues posix_fadvise(WILLNEED) per
+// file, so the kernel pulls the pages in while earlier DAGs execute and the
+// tasks fault on warm cache instead of cold NVMe. A byte budget bounds how
+// far ahead of execution the thread runs — retire() releases a list's bytes
+// once its DAG has started reading, keeping the prefetched window just in
+// front of the workers instead of churning the page cache with the whole
+// batch.
+//
+// Advice is best-effort by design: a missing file or an unsupported
+// filesystem is counted and skipped, never an error — the task itself will
+// report real I/O problems.
+class Prefetcher {
+public:
+    struct Options {
+        std::uint64_t budget_bytes = 256ull << 20; // prefetched-ahead cap
+        std::uint64_t max_file_bytes = 64ull << 20; // advise at most this much
+    };
+
+    using Ticket = std::uint64_t;
+
+    Prefetcher() : Prefetcher(Options{}) {}
+    explicit Prefetcher(Options options);
+    ~Prefetcher(); // stops the thread; outstanding advice stays in cache
+
+    Prefetcher(const Prefetcher&) = delete;
+    Prefetcher& operator=(const Prefetcher&) = delete;
+
+    // Queues one DAG's inputs. Lists are prefetched strictly in publish
+    // order — publish in submission order and the data front stays just
+    // ahead of the execution front.
+    Ticket publish(std::vector<std::string> files);
+
+    // Marks the DAG as started (or done): its bytes leave the budget and
+    // the thread moves deeper into the queue. Out-of-order retires are
+    // fine; unknown tickets are ignored.
+    void retire(Ticket ticket);
+
+    // Blocks until every published list has been advised.
+    void drain();
+
+    struct Stats {
+        std::uint64_t lists = 0;
+        std::uint64_t files = 0;
+        std::uint64_t bytes = 0;   // bytes advised
+        std::uint64_t skipped = 0; // unreadable or vanished files
+        std::uint64_t stalls = 0;  // waits on the byte budget
+    };
+    Stats stats() const;
+
+private:
+    struct List {
+        Ticket ticket = 0;
+        std::vector<std::string> files;
+        std::uint64_t bytes = 0; // filled in as the list is advised
+        bool advised = false;
+        bool retired = false;
+    };
+
+    void run();
+    std::uint64_t advise_file(const std::string& path);
+
+    Options options_;
+
+    mutable std::mutex mu_;
+    std::condition_variable work_cv_;  // wakes the prefetch thread
+    std::condition_variable drain_cv_; // wakes drain()/budget waiters
+    std::deque<List> lists_; // publish order; advised prefix, queued suffix
+    Ticket next_ticket_ = 1;
+    std::uint64_t inflight_bytes_ = 0; // advised but not yet retired
+    Stats stats_;
+    bool stopping_ = false;
+
+    std::thread thread_;
+};
+
+} // namespace intake
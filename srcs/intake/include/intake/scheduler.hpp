@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace intake {
+
+// DAG scheduler for the intake pipeline. Ready tasks sit in lock-free
+// structures: each worker owns a Chase-Lev deque (LIFO pop for the owner,
+// FIFO steal for everyone else) and external submissions land in a bounded
+// Vyukov MPMC ring. Dependencies are counted per task; the last completing
+// dependency enqueues the dependent, so a submission's
+// hash -> validate -> extract -> index chain flows without any stage-level
+// barrier and 200 submissions keep every core busy.
+//
+// Tasks are owned by the scheduler until reset() or destruction; TaskIds
+// stay valid for waits until then.
+class Scheduler {
+public:
+    using TaskFn = std::function<void()>;
+
+    struct Task; // opaque
+    using TaskId = Task*;
+
+    explicit Scheduler(std::size_t threads = 0); // 0 = hardware concurrency
+    ~Scheduler();
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    // Submits a task that is ready to run immediately.
+    TaskId submit(TaskFn fn);
+
+    // Submits a task that becomes ready once every dependency has finished.
+    // Dependencies that already completed count as satisfied.
+    TaskId submit_after(std::span<const TaskId> deps, TaskFn fn);
+
+    // Blocks until `task` completes, helping to run queued tasks meanwhile
+    // (safe to call from inside a task).
+    void wait(TaskId task);
+
+    // Blocks until every submitted task has completed.
+    void wait_all();
+
+    // Reclaims completed task storage. Callers must not hold TaskIds across
+    // a reset. Requires an idle scheduler (call wait_all() first).
+    void reset();
+
+    std::size_t thread_count() const { return workers_.size(); }
+
+private:
+    struct Deque;
+    struct InjectQueue;
+
+    void worker_loop(std::size_t index);
+    Task* find_work(std::size_t index);
+    void run_task(Task* task);
+    void make_ready(Task* task, std::size_t hint);
+    Task* allocate(TaskFn fn);
+
+    std::vector<std::unique_ptr<Deque>> deques_;
+    std::unique_ptr<InjectQueue> inject_;
+    std::vector<std::thread> workers_;
+
+    std::mutex alloc_mu_;
+    std::vector<std::unique_ptr<Task>> tasks_;
+
+    std::atomic<std::size_t> unfinished_{0};
+    std::atomic<bool> stopping_{false};
+    std::mutex wake_mu_;
+    std::condition_variable wake_cv_;
+    std::condition_variable idle_cv_;
+
+    static thread_local std::size_t tls_worker_index_;
+};
+
+} // namespace intake
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace intake {
+
+// One judge's score for one team and criterion. Later appends for the same
+// (team, judge, criterion) key overwrite earlier ones — judges can revise.
+struct Score {
+    std::string team;
+    std::string judge;
+    std::string criterion;
+    double value = 0.0;
+    std::uint64_t ts_ns = 0; // caller-supplied timestamp
+};
+
+// Live scoring store: appends go to a binary write-ahead log with group
+// commit — concurrent writers queue their records and one leader writes and
+// fsyncs the whole batch, so an individual append costs microseconds while
+// a crash loses at most the batch being written. compact() folds the log
+// into a columnar snapshot (one column per score field, interned strings)
+// and truncates the WAL; startup maps the snapshot and replays the tail.
+// Export to xlsx is an offline consumer of scores(), never the write path.
+class ScoreStore {
+public:
+    struct Stats {
+        std::uint64_t appends = 0;
+        std::uint64_t commits = 0; // fsync batches; appends/commits = batching
+        std::uint64_t replayed = 0;
+    };
+
+    // Opens (creating if needed) the store in `dir`; loads the snapshot and
+    // replays the WAL. Throws std::runtime_error on unreadable state.
+    explicit ScoreStore(std::string dir);
+    ~ScoreStore();
+
+    // Durable on return (the record's batch has been fsynced).
+    void append(const Score& score);
+
+    // Latest score for the key; false when the key was never written.
+    bool latest(std::string_view team, std::string_view judge,
+                std::string_view criterion, Score& out) const;
+
+    // Every current (latest-per-key) score, key order.
+    std::vector<Score> scores() const;
+
+    // Folds current state into the snapshot and truncates the WAL. Safe to
+    // call while writers are active.
+    void compact();
+
+    Stats stats() const;
+
+private:
+    void load_snapshot();
+    void replay_wal();
+    void commit_locked(std::unique_lock<std::mutex>& lk);
+
+    std::string dir_;
+    int wal_fd_ = -1;
+
+    mutable std::mutex mu_;
+    std::condition_variable commit_cv_;
+    std::map<std::string, Score> latest_; // key = team \0 judge \0 criterion
+    std::deque<std::pair<std::uint64_t, std::string>> queue_; // seq, record
+    std::uint64_t next_seq_ = 0;
+    std::uint64_t durable_seq_ = 0;
+    bool committing_ = false;
+    Stats stats_;
+};
+
+} // namespace intake
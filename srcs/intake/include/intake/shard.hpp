@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "intake/validator.hpp"
+
+namespace intake {
+
+// Result of one sharded job, as merged on the coordinator. `payload` is
+// opaque to the transport — workers put whatever their job function
+// produced (typically a serialized validation/extraction summary).
+struct ShardJobResult {
+    ForkRef fork;
+    bool ok = false;
+    std::string payload; // result on success, error message on failure
+};
+
+// Coordinator side of deadline-burst sharding. Submissions are partitioned
+// into shard queues by fork hash, so re-pushes of the same fork land on the
+// same worker's queue (warm caches). Distribution is pull-based over a
+// binary TCP protocol: an idle worker asks, the coordinator serves from the
+// worker's own shard first and steals from the longest other queue when
+// that runs dry — a node stuck on heavy PDFs simply stops asking and its
+// backlog drains through everyone else.
+class ShardCoordinator {
+public:
+    struct Options {
+        std::uint16_t port = 0; // 0 binds an ephemeral port
+        std::uint32_t shards = 8;
+    };
+
+    using MergeFn = std::function<void(const ShardJobResult&)>;
+
+    // Binds, listens and starts the accept thread; `merge` runs on a
+    // connection thread, one call per finished job, never concurrently.
+    ShardCoordinator(Options options, MergeFn merge);
+    ~ShardCoordinator();
+
+    ShardCoordinator(const ShardCoordinator&) = delete;
+    ShardCoordinator& operator=(const ShardCoordinator&) = delete;
+
+    void enqueue(ForkRef fork);
+
+    // Blocks until every enqueued job has a merged result.
+    void wait_all();
+
+    // Tells idle workers to exit and tears the listener down. Implied by
+    // the destructor.
+    void shutdown();
+
+    std::uint16_t port() const { return port_; }
+    std::uint64_t jobs_done() const { return done_.load(); }
+    std::uint64_t steals() const { return steals_.load(); }
+
+private:
+    struct Job {
+        ForkRef fork;
+        bool dispatched = false;
+    };
+
+    void accept_loop();
+    void serve_worker(int fd, std::uint32_t worker_index);
+    bool next_job(std::uint32_t preferred_shard, std::uint64_t& job_id);
+
+    Options options_;
+    MergeFn merge_;
+    int listen_fd_ = -1;
+    std::uint16_t port_ = 0;
+
+    std::mutex mu_;
+    std::mutex merge_mu_;
+    std::condition_variable all_done_cv_;
+    std::vector<Job> jobs_;
+    std::vector<std::deque<std::uint64_t>> shard_queues_;
+    std::uint64_t enqueued_ = 0;
+    std::atomic<std::uint64_t> done_{0};
+    std::atomic<std::uint64_t> steals_{0};
+    std::atomic<bool> stopping_{false};
+    std::atomic<std::uint32_t> next_worker_{0};
+
+    std::thread accept_thread_;
+    std::mutex workers_mu_;
+    std::vector<std::thread> worker_threads_;
+};
+
+// Worker side: connects to the coordinator, pulls jobs, runs them through
+// `job_fn` (which is free to fan out on the node's own pool/scheduler) and
+// streams results back. run() returns when the coordinator shuts down.
+class ShardWorker {
+public:
+    // Returns the result payload; a thrown exception becomes a failed
+    // result carrying the message.
+    using JobFn = std::function<std::string(const ForkRef&)>;
+
+    ShardWorker(std::string host, std::uint16_t port, JobFn job_fn);
+
+    void run();
+
+    std::uint64_t jobs_run() const { return jobs_run_; }
+
+private:
+    std::string host_;
+    std::uint16_t port_;
+    JobFn job_fn_;
+    std::uint64_t jobs_run_ = 0;
+};
+
+} // namespace intake
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace intake {
+
+// MinHash sketch of one file's content, built during intake while the blob
+// is already in memory for hashing. Shingles are 16-byte rolling windows;
+// one-permutation hashing buckets each shingle hash by its top bits and
+// keeps the minimum per slot, so the sketch costs one multiply-mix per byte
+// regardless of the slot count. Empty slots are densified by borrowing from
+// the next filled slot, which keeps the equal-slot fraction an unbiased
+// Jaccard estimate even for small files.
+struct MinHashSignature {
+    static constexpr std::size_t kSlots = 64;
+    std::array<std::uint64_t, kSlots> mins;
+
+    static MinHashSignature from_bytes(std::string_view data);
+
+    // Estimated Jaccard similarity: fraction of matching slots.
+    double jaccard(const MinHashSignature& other) const;
+};
+
+// LSH candidate filter for the post-event plagiarism pass. Signatures are
+// banded (16 bands of 4 slots); files sharing any band key are candidate
+// pairs, everything else is skipped — with 4-slot bands the detection
+// s-curve crosses 50% around Jaccard 0.5. A two-bit Bloom front (seen /
+// seen-twice) runs over the band keys first so buckets are only
+// materialized for keys that actually repeat; singleton bands, the vast
+// majority, never allocate anything.
+class SimilarityIndex {
+public:
+    struct CandidatePair {
+        std::uint32_t a; // file ids in add() order, a < b
+        std::uint32_t b;
+        double estimated_jaccard;
+    };
+
+    struct Stats {
+        std::uint64_t files = 0;
+        std::uint64_t bands = 0;
+        std::uint64_t repeated_bands = 0; // band keys the Bloom saw twice
+        std::uint64_t pairs_scored = 0;   // pairs pulled from buckets
+    };
+
+    // Registers a file; `name` is whatever the report should print
+    // (fork-relative path, typically). Returns the file id.
+    std::uint32_t add(std::string name, const MinHashSignature& sig);
+
+    // Candidate pairs with estimated Jaccard >= `min_jaccard`, each pair
+    // reported once. The expensive byte-level comparison runs only on
+    // these.
+    std::vector<CandidatePair> candidates(double min_jaccard = 0.5) const;
+
+    const std::string& name(std::uint32_t id) const { return names_[id]; }
+    std::size_t size() const { return names_.size(); }
+
+    // Counters from the last candidates() run.
+    Stats stats() const;
+
+private:
+    std::vector<std::string> names_;
+    std::vector<MinHashSignature> signatures_;
+    mutable Stats stats_;
+};
+
+} // namespace intake
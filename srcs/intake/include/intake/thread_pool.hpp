@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace intake {
+
+// Work-stealing thread pool. Each worker owns a deque; it pops its own work
+// LIFO (cache-warm) and steals FIFO from the others when empty. Submissions
+// from outside the pool round-robin across worker queues, so a burst of fork
+// validations spreads immediately and uneven forks rebalance by stealing.
+class ThreadPool {
+public:
+    explicit ThreadPool(std::size_t threads = 0); // 0 = hardware concurrency
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> fn);
+
+    // Blocks until every submitted task (including tasks submitted by other
+    // tasks) has finished.
+    void wait_idle();
+
+    // Runs one queued task on the calling thread if any is available.
+    // Lets a thread that must wait for pool work (possibly a pool worker
+    // itself) help drain the queues instead of blocking them.
+    bool try_run_one();
+
+    std::size_t thread_count() const { return workers_.size(); }
+
+private:
+    struct Queue {
+        std::mutex mu;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void worker_loop(std::size_t index);
+    bool try_pop(std::size_t index, std::function<void()>& out);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::mutex wake_mu_;
+    std::condition_variable wake_cv_;
+    std::condition_variable idle_cv_;
+    std::atomic<std::size_t> pending_{0}; // queued + running
+    std::atomic<std::size_t> queued_{0};  // sitting in a deque
+    std::atomic<std::size_t> next_queue_{0};
+    std::atomic<bool> stopping_{false};
+};
+
+} // namespace intake
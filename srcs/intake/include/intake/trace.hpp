@@ -0,0 +1,122 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Hot-path instrumentation. Sites compile to nothing unless the build
+// defines INTAKE_TRACING (the default via CMake's INTAKE_TRACING option);
+// with it on, each event is one relaxed fetch_add plus a few stores into a
+// fixed-size binary ring that overwrites its oldest records — no locks, no
+// allocation, well under the 1% budget on every path we instrument.
+//
+//   INTAKE_TRACE_SCOPE("pdf.extract_file");   // duration of this scope
+//   INTAKE_TRACE_COUNT("validator.files", n); // monotonic counter add
+//   INTAKE_TRACE_GAUGE("pool.queued", depth); // point-in-time value
+//
+// trace::dump() writes the ring plus the name table to a file for offline
+// tools; trace::summary() aggregates in-process for live inspection.
+
+namespace intake::trace {
+
+enum class Kind : std::uint8_t {
+    Duration = 0, // value = nanoseconds spent in the scope
+    Count = 1,    // value = delta
+    Gauge = 2,    // value = sampled level
+};
+
+struct Record {
+    std::uint64_t ts_ns; // steady clock, since process start
+    std::uint64_t value;
+    std::uint32_t event; // id from intern()
+    std::uint32_t tid;
+    Kind kind;
+    std::uint8_t pad[7];
+};
+static_assert(sizeof(Record) == 32);
+
+// Registers an event name once; call through a function-local static so the
+// hot path pays a load, not a lookup.
+std::uint32_t intern(std::string_view name);
+
+void record(std::uint32_t event, Kind kind, std::uint64_t value);
+
+std::uint64_t now_ns();
+
+// Snapshot of the ring in write order (oldest first), plus the name table.
+std::vector<Record> snapshot();
+const std::vector<std::string>& event_names();
+
+// Binary dump: "INTAKTR1", u32 name_count, length-prefixed names, then raw
+// Records. Returns false on I/O failure.
+bool dump(const std::string& path);
+
+// Per-event aggregation of the current ring for live inspection. Name
+// views stay valid until the next summary() call.
+struct EventSummary {
+    std::string_view name;
+    Kind kind;
+    std::uint64_t samples = 0;
+    std::uint64_t total = 0; // ns for durations, sum for counts
+    std::uint64_t max = 0;
+    std::uint64_t last = 0; // most recent value (gauges)
+};
+std::vector<EventSummary> summary();
+
+// RAII duration probe.
+class ScopeTimer {
+public:
+    explicit ScopeTimer(std::uint32_t event)
+        : event_(event), start_(now_ns()) {}
+    ~ScopeTimer() { record(event_, Kind::Duration, now_ns() - start_); }
+
+    ScopeTimer(const ScopeTimer&) = delete;
+    ScopeTimer& operator=(const ScopeTimer&) = delete;
+
+private:
+    std::uint32_t event_;
+    std::uint64_t start_;
+};
+
+} // namespace intake::trace
+
+#if defined(INTAKE_TRACING)
+
+#define INTAKE_TRACE_CAT2(a, b) a##b
+#define INTAKE_TRACE_CAT(a, b) INTAKE_TRACE_CAT2(a, b)
+
+#define INTAKE_TRACE_SCOPE(name)                                             \
+    static const std::uint32_t INTAKE_TRACE_CAT(intake_trace_ev_,            \
+                                                __LINE__) =                  \
+        ::intake::trace::intern(name);                                       \
+    ::intake::trace::ScopeTimer INTAKE_TRACE_CAT(intake_trace_sc_,           \
+                                                 __LINE__)(                  \
+        INTAKE_TRACE_CAT(intake_trace_ev_, __LINE__))
+
+#define INTAKE_TRACE_COUNT(name, delta)                                      \
+    do {                                                                     \
+        static const std::uint32_t intake_trace_ev =                         \
+            ::intake::trace::intern(name);                                   \
+        ::intake::trace::record(intake_trace_ev,                             \
+                                ::intake::trace::Kind::Count,                \
+                                static_cast<std::uint64_t>(delta));          \
+    } while (0)
+
+#define INTAKE_TRACE_GAUGE(name, value)                                      \
+    do {                                                                     \
+        static const std::uint32_t intake_trace_ev =                         \
+            ::intake::trace::intern(name);                                   \
+        ::intake::trace::record(intake_trace_ev,                             \
+                                ::intake::trace::Kind::Gauge,                \
+                                static_cast<std::uint64_t>(value));          \
+    } while (0)
+
+#else
+
+#define INTAKE_TRACE_SCOPE(name) ((void)0)
+#define INTAKE_TRACE_COUNT(name, delta) ((void)0)
+#define INTAKE_TRACE_GAUGE(name, value) ((void)0)
+
+#endif
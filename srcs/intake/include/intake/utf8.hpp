@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace intake::utf8 {
+
+// UTF-8 validation and normalization for the intake boundary: team names,
+// branch names and canvas text get one validate-and-normalize pass on entry
+// so everything downstream (feedback index, dashboard, dedup hashing) can
+// assume clean, composed UTF-8. Validation is the lookup-table SIMD
+// algorithm (three nibble shuffles classify every byte pair) on AVX2; SSE2
+// lacks the byte shuffle, so pre-AVX2 boxes get an ASCII movemask fast path
+// over a scalar decoder. Dispatch happens once at load via cpuid, like the
+// xmlscan scanners.
+
+// True when `s` is well-formed UTF-8 (RFC 3629: no overlongs, surrogates,
+// or codepoints beyond U+10FFFF; truncated tail sequences fail).
+bool validate(std::string_view s);
+
+// Byte index of the first invalid sequence, or npos when `s` is valid.
+// Scalar — meant for the error message after validate() said no.
+std::size_t find_invalid(std::string_view s);
+
+// Composes combining diacritics into their precomposed NFC forms. Scope is
+// what submissions actually contain: Latin base letters with the marks of
+// Latin-1 Supplement and Latin Extended-A (grave, acute, circumflex, tilde,
+// diaeresis, ring, cedilla, caron — the full Czech/Slovak set included).
+// Sequences outside the table pass through untouched; they are already
+// valid UTF-8, just not composed. Returns false when `s` needed no change
+// (`out` is left alone — the common case costs one SIMD scan and no copy);
+// true when `out` holds the composed text.
+bool normalize_nfc(std::string_view s, std::string& out);
+
+} // namespace intake::utf8
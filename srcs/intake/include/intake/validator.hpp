@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "intake/thread_pool.hpp"
+
+namespace intake {
+
+// One rule violation found in a fork. `path` is relative to the fork root.
+struct ValidationIssue {
+    enum class Code : std::uint8_t {
+        MissingSrcs,       // srcs/ absent or holds only the placeholder
+        MissingCanvasPdf,  // no canvas PDF at the repo root
+        MissingPitchPdf,   // pitch/ has no PDF
+        NotAPdf,           // file with .pdf name but wrong magic
+        BadBranchName,     // branch does not follow the Step 2 rules
+    };
+
+    Code code;
+    std::string path;
+    std::string message;
+};
+
+struct ValidationReport {
+    std::string fork_root;
+    std::string branch;
+    std::vector<ValidationIssue> issues;
+    std::uint64_t files_scanned = 0;
+
+    bool ok() const { return issues.empty(); }
+};
+
+struct ForkRef {
+    std::string root;   // path to the fork's working tree
+    std::string branch; // the PR's head branch name
+};
+
+// Validates forked submission trees against the README rules: solution
+// content under srcs/ (the upstream `srcs/tmp_whatever` placeholder does not
+// count), a canvas PDF at the repo root, a pitch PDF under pitch/, and a
+// team-named branch. Directory walks fan out over the shared pool so a
+// deadline batch of 200 forks saturates all cores.
+class SubmissionValidator {
+public:
+    explicit SubmissionValidator(ThreadPool& pool) : pool_(pool) {}
+
+    ValidationReport validate_fork(const ForkRef& fork);
+    std::vector<ValidationReport> validate_batch(std::span<const ForkRef> forks);
+
+    // Exposed for the incremental validator: true if `data` starts with the
+    // PDF magic.
+    static bool looks_like_pdf(std::string_view head);
+    static bool branch_name_ok(std::string_view branch);
+
+private:
+    ThreadPool& pool_;
+};
+
+} // namespace intake
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "intake/columnar_cache.hpp"
+#include "intake/feedback_index.hpp"
+#include "intake/mmap_file.hpp"
+#include "intake/validator.hpp"
+
+namespace intake {
+
+// Warm-state snapshot for fast restarts: one mmap-able file ("INTAKWS1")
+// holding the columnar cache generation it was built against, every
+// feedback index's tables, and the fork jobs that were still queued at
+// shutdown. open() maps the file, checks the generation and wires index
+// views into the mapping without touching the table pages — the kernel
+// faults them in as queries arrive — so a restart reaches first-request
+// readiness in milliseconds instead of re-ingesting the workbook.
+//
+// A snapshot whose generation no longer matches the cache (the workbook
+// changed while the service was down) is reported as absent; the caller
+// rebuilds warm state the slow way and save()s a fresh one.
+class WarmSnapshot {
+public:
+    struct NamedIndex {
+        std::string_view sheet;
+        const FeedbackIndex* index;
+    };
+
+    // Serializes the indexes and pending jobs against `cache`'s generation,
+    // written atomically (tmp + rename). Throws std::runtime_error on I/O
+    // failure.
+    static void save(const std::string& path, const ColumnarCache& cache,
+                     std::span<const NamedIndex> indexes,
+                     std::span<const ForkRef> pending);
+
+    // Maps the snapshot at `path`. Returns nullopt when the file is missing,
+    // malformed, or was built against a different cache generation — all of
+    // which mean "rebuild warm state". The cache must outlive the snapshot.
+    static std::optional<WarmSnapshot> open(const std::string& path,
+                                            const ColumnarCache& cache);
+
+    // Index for `sheet`, or nullptr if the snapshot holds none.
+    const FeedbackIndex* index(std::string_view sheet) const;
+
+    // Fork jobs that were queued when the snapshot was saved, in order.
+    std::span<const ForkRef> pending() const { return pending_; }
+
+    std::size_t index_count() const { return indexes_.size(); }
+
+private:
+    WarmSnapshot() = default;
+
+    std::shared_ptr<MmapFile> file_; // index views point into the mapping
+    std::vector<std::pair<std::string, FeedbackIndex>> indexes_;
+    std::vector<ForkRef> pending_;
+};
+
+} // namespace intake
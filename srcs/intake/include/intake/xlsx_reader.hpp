@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "intake/arena.hpp"
+#include "intake/mmap_file.hpp"
+#include "intake/zip_reader.hpp"
+
+namespace intake {
+
+// Cell produced while scanning a worksheet. `text` is a zero-copy view: for
+// shared strings it points into the shared-strings buffer owned by the
+// reader, otherwise into the inflated worksheet buffer. Views are valid until
+// the next sheet scan (or, for shared strings, for the reader's lifetime).
+struct CellView {
+    enum class Type : std::uint8_t {
+        Empty,
+        Number,       // raw numeric text, caller parses on demand
+        SharedString, // resolved against the shared-strings table
+        InlineString,
+        Boolean,
+        Error,
+        Formula,
+    };
+
+    std::uint32_t row = 0; // 1-based, as in the file
+    std::uint32_t col = 0; // 0-based column index (A == 0)
+    Type type = Type::Empty;
+    std::string_view text;
+
+    double number() const; // parses `text`; 0.0 for non-numeric cells
+};
+
+// Memory-mapped xlsx reader tuned for repeated scans of the judging
+// workbooks. The container is mapped once, worksheet parts inflate into a
+// single reusable buffer, and cell values come back as string views — no
+// per-cell materialization on the scan path.
+class XlsxReader {
+public:
+    using RowCallback =
+        std::function<void(std::uint32_t row, std::span<const CellView> cells)>;
+
+    // Throws std::runtime_error on a malformed workbook.
+    explicit XlsxReader(const std::string& path);
+
+    // Sheet names in workbook order, e.g. {"Attendance_checklist", ...}.
+    const std::vector<std::string>& sheet_names() const { return sheet_names_; }
+
+    // Scans one sheet front to back, invoking `cb` per non-empty row. Cell
+    // views passed to the callback are invalidated by the next scan.
+    void for_each_row(std::string_view sheet_name, const RowCallback& cb);
+
+    const std::vector<std::string_view>& shared_strings() const {
+        return shared_strings_;
+    }
+
+private:
+    void load_workbook_metadata();
+    void load_shared_strings();
+    std::string_view sheet_part(std::string_view sheet_name) const;
+
+    MmapFile file_;
+    ZipReader zip_;
+
+    std::vector<std::string> sheet_names_;
+    std::vector<std::string> sheet_parts_; // zip entry name per sheet
+
+    // Shared strings: the inflated XML part stays alive so the table can be
+    // plain views. Strings containing entity escapes or rich-text runs are
+    // materialized once into the reader's arena (stable for its lifetime).
+    std::vector<unsigned char> shared_strings_xml_;
+    Arena string_arena_;
+    std::vector<std::string_view> shared_strings_;
+
+    // Reusable scan-path buffers: worksheet XML and the per-row cell batch.
+    std::vector<unsigned char> sheet_xml_;
+    std::vector<CellView> row_cells_;
+};
+
+// Parses an "A1"-style cell reference; returns the 0-based column index.
+std::uint32_t column_index(std::string_view cell_ref);
+
+} // namespace intake
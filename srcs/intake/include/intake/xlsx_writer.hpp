@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "intake/columnar_cache.hpp"
+
+namespace intake {
+
+// Streaming writer for the compiled results workbook. Worksheet XML is
+// emitted row by row and deflated incrementally through a fixed 64 KiB
+// buffer pair; the zip container is written with data descriptors (general
+// purpose bit 3), so an entry's sizes and crc go after its data and
+// nothing is ever buffered whole. Strings are written inline
+// (t="inlineStr") rather than through a shared-string table — the table
+// would have to be held until the last sheet closes, and the size win is
+// irrelevant next to deflate. Memory use is constant in the row count.
+class XlsxWriter {
+public:
+    struct Cell {
+        enum class Type : std::uint8_t { Empty, Number, Text };
+
+        Type type = Type::Empty;
+        std::string_view text; // valid until the add_row() call returns
+        double number = 0.0;
+
+        static Cell empty() { return {}; }
+        static Cell num(double v) { return {Type::Number, {}, v}; }
+        static Cell str(std::string_view s) { return {Type::Text, s, 0.0}; }
+    };
+
+    // Creates (truncating) the workbook at `path`. Throws std::runtime_error
+    // on I/O failure, here and from every write below.
+    explicit XlsxWriter(const std::string& path);
+    ~XlsxWriter(); // finishes the workbook if finish() was not called
+
+    XlsxWriter(const XlsxWriter&) = delete;
+    XlsxWriter& operator=(const XlsxWriter&) = delete;
+
+    void begin_sheet(std::string_view name);
+    void add_row(std::span<const Cell> cells); // empty cells are omitted
+    void end_sheet();
+
+    // Writes the workbook-level parts and the central directory. The file
+    // is not a valid xlsx until this returns.
+    void finish();
+
+    // One-call export: every sheet of the cache, column names as the
+    // header row, then the data rows.
+    static void write_cache(const std::string& path,
+                            const ColumnarCache& cache);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace intake
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace intake::xmlscan {
+
+// Vectorized byte scanning for the SpreadsheetML hot loops. On x86-64 the
+// scanners use AVX2 when the CPU has it and SSE2 otherwise (always present
+// on x86-64); other architectures get the scalar fallback. Dispatch happens
+// once at load via cpuid.
+
+// First occurrence of `b` in [p, end), or `end`.
+const char* find_byte(const char* p, const char* end, char b);
+
+// First occurrence of either byte in [p, end), or `end`. Used to scan text
+// runs for the next tag open or entity escape in one pass.
+const char* find_any2(const char* p, const char* end, char a, char b);
+
+// First XML-structural byte ('<', '>', '"', '&') in [p, end), or `end`.
+// One byte-class pass instead of four scans when walking attribute lists.
+const char* find_structural(const char* p, const char* end);
+
+// std::string_view conveniences over the raw scanners.
+inline std::size_t find_byte(std::string_view s, std::size_t from, char b) {
+    if (from >= s.size())
+        return std::string_view::npos;
+    const char* hit = find_byte(s.data() + from, s.data() + s.size(), b);
+    return hit == s.data() + s.size() ? std::string_view::npos
+                                      : static_cast<std::size_t>(hit - s.data());
+}
+
+inline std::size_t find_any2(std::string_view s, std::size_t from, char a,
+                             char b) {
+    if (from >= s.size())
+        return std::string_view::npos;
+    const char* hit = find_any2(s.data() + from, s.data() + s.size(), a, b);
+    return hit == s.data() + s.size() ? std::string_view::npos
+                                      : static_cast<std::size_t>(hit - s.data());
+}
+
+// Parses an r="A1"-style reference in one pass. Returns false on malformed
+// input; on success `col` is 0-based and `row` 1-based.
+bool parse_cell_ref(std::string_view ref, std::uint32_t& row,
+                    std::uint32_t& col);
+
+} // namespace intake::xmlscan
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "intake/mmap_file.hpp"
+
+namespace intake {
+
+// Zip container reader over a memory-mapped archive. Entry names and stored
+// (uncompressed) payloads are zero-copy views into the mapping; deflated
+// entries inflate into a caller-supplied buffer that can be reused across
+// entries to keep the scan path allocation-free after warm-up.
+class ZipReader {
+public:
+    struct Entry {
+        std::string_view name;       // view into the mapped central directory
+        std::uint64_t data_offset;   // start of the payload in the archive
+        std::uint64_t compressed_size;
+        std::uint64_t uncompressed_size;
+        std::uint16_t method;        // 0 = stored, 8 = deflate
+    };
+
+    // Throws std::runtime_error on a malformed container.
+    explicit ZipReader(const MmapFile& file);
+
+    const std::vector<Entry>& entries() const { return entries_; }
+    const Entry* find(std::string_view name) const;
+
+    // Inflates (or, for stored entries, copies out a view of) the entry into
+    // `out`. The buffer is resized to the uncompressed size; its capacity is
+    // kept across calls. Returns the inflated bytes as a view valid until the
+    // next use of `out`. Throws on decompression failure.
+    std::string_view read(const Entry& entry,
+                          std::vector<unsigned char>& out) const;
+    std::string_view read(std::string_view name,
+                          std::vector<unsigned char>& out) const;
+
+private:
+    const MmapFile& file_;
+    std::vector<Entry> entries_;
+};
+
+} // namespace intake
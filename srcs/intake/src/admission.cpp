@@ -0,0 +1,120 @@
+#include "intake/admission.hpp"
+
+#include <utility>
+
+#include "intake/trace.hpp"
+
+namespace intake {
+
+namespace {
+
+std::string fork_key(const ForkRef& fork) {
+    std::string key;
+    key.reserve(fork.root.size() + 1 + fork.branch.size());
+    key += fork.root;
+    key += '\0';
+    key += fork.branch;
+    return key;
+}
+
+} // namespace
+
+AdmissionController::AdmissionController(Scheduler& scheduler, Options options)
+    : scheduler_(scheduler), options_(options) {
+    if (options_.max_inflight == 0)
+        options_.max_inflight = 2 * scheduler_.thread_count();
+}
+
+void AdmissionController::enqueue(JobClass job_class, ForkRef fork,
+                                  std::string commit_hex, JobFn build) {
+    {
+        std::lock_guard lock(mu_);
+        if (job_class == JobClass::Revalidation) {
+            const std::string key = fork_key(fork);
+            const auto it = queued_reval_.find(key);
+            if (it != queued_reval_.end()) {
+                // Same fork already waiting: the older commit's run would be
+                // thrown away anyway, so just retarget the queued job.
+                it->second->commit_hex = std::move(commit_hex);
+                it->second->build = std::move(build);
+                ++stats_.collapsed;
+                INTAKE_TRACE_COUNT("admission.collapsed", 1);
+                return;
+            }
+            reval_queue_.push_back(
+                {std::move(fork), std::move(commit_hex), std::move(build)});
+            queued_reval_[key] = &reval_queue_.back();
+        } else {
+            first_queue_.push_back(
+                {std::move(fork), std::move(commit_hex), std::move(build)});
+        }
+    }
+    pump();
+}
+
+void AdmissionController::pump() {
+    while (true) {
+        Job job;
+        JobClass job_class;
+        {
+            std::lock_guard lock(mu_);
+            if (inflight_ >= options_.max_inflight)
+                return;
+            const bool grant_reval =
+                !reval_queue_.empty() &&
+                (first_queue_.empty() ||
+                 first_streak_ >= options_.first_burst_budget);
+            if (grant_reval) {
+                job = std::move(reval_queue_.front());
+                reval_queue_.pop_front();
+                queued_reval_.erase(fork_key(job.fork));
+                job_class = JobClass::Revalidation;
+                if (!first_queue_.empty())
+                    ++stats_.fairness_grants;
+                first_streak_ = 0;
+                ++stats_.admitted_revalidation;
+            } else if (!first_queue_.empty()) {
+                job = std::move(first_queue_.front());
+                first_queue_.pop_front();
+                job_class = JobClass::FirstSubmission;
+                ++first_streak_;
+                ++stats_.admitted_first;
+            } else {
+                return;
+            }
+            ++inflight_;
+        }
+        admit(std::move(job), job_class);
+    }
+}
+
+void AdmissionController::admit(Job job, JobClass job_class) {
+    INTAKE_TRACE_SCOPE(job_class == JobClass::FirstSubmission
+                           ? "admission.first"
+                           : "admission.reval");
+    const Scheduler::TaskId done = job.build(scheduler_);
+    const Scheduler::TaskId deps[] = {done};
+    scheduler_.submit_after(deps, [this] {
+        {
+            std::lock_guard lock(mu_);
+            --inflight_;
+            ++stats_.completed;
+            idle_cv_.notify_all();
+        }
+        pump(); // the freed slot admits the next queued job
+    });
+}
+
+void AdmissionController::wait_idle() {
+    std::unique_lock lock(mu_);
+    idle_cv_.wait(lock, [this] {
+        return inflight_ == 0 && first_queue_.empty() && reval_queue_.empty();
+    });
+}
+
+AdmissionController::Stats AdmissionController::stats() const {
+    std::lock_guard lock(mu_);
+    return stats_;
+}
+
+} // namespace intake
@@ -0,0 +1,220 @@
+#include "intake/aggregate.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define INTAKE_X86 1
+#endif
+
+namespace intake::agg {
+
+namespace {
+
+Summary summarize_scalar(const double* values, std::size_t n) {
+    Summary s;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double v = values[i];
+        if (std::isnan(v))
+            continue;
+        if (s.count == 0) {
+            s.min = s.max = v;
+        } else {
+            s.min = std::min(s.min, v);
+            s.max = std::max(s.max, v);
+        }
+        s.sum += v;
+        ++s.count;
+    }
+    return s;
+}
+
+#ifdef INTAKE_X86
+
+bool have_avx2() {
+    static const bool v = __builtin_cpu_supports("avx2");
+    return v;
+}
+
+__attribute__((target("avx2"))) Summary summarize_avx2(const double* values,
+                                                       std::size_t n) {
+    __m256d sum = _mm256_setzero_pd();
+    __m256d mn = _mm256_set1_pd(__builtin_inf());
+    __m256d mx = _mm256_set1_pd(-__builtin_inf());
+    std::uint64_t count = 0;
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256d v = _mm256_loadu_pd(values + i);
+        // Ordered self-compare: NaN lanes come back 0 and drop out of every
+        // accumulator below.
+        const __m256d ord = _mm256_cmp_pd(v, v, _CMP_ORD_Q);
+        sum = _mm256_add_pd(sum, _mm256_and_pd(v, ord));
+        mn = _mm256_min_pd(mn, _mm256_blendv_pd(mn, v, ord));
+        mx = _mm256_max_pd(mx, _mm256_blendv_pd(mx, v, ord));
+        count += static_cast<unsigned>(
+            __builtin_popcount(_mm256_movemask_pd(ord)));
+    }
+    alignas(32) double lanes[4];
+    Summary s;
+    s.count = count;
+    _mm256_store_pd(lanes, sum);
+    s.sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    _mm256_store_pd(lanes, mn);
+    s.min = std::min(std::min(lanes[0], lanes[1]),
+                     std::min(lanes[2], lanes[3]));
+    _mm256_store_pd(lanes, mx);
+    s.max = std::max(std::max(lanes[0], lanes[1]),
+                     std::max(lanes[2], lanes[3]));
+
+    // Scalar tail, folded into the vector partials.
+    const Summary tail = summarize_scalar(values + i, n - i);
+    if (tail.count > 0) {
+        s.sum += tail.sum;
+        s.min = s.count ? std::min(s.min, tail.min) : tail.min;
+        s.max = s.count ? std::max(s.max, tail.max) : tail.max;
+        s.count += tail.count;
+    }
+    if (s.count == 0)
+        s.min = s.max = 0.0;
+    return s;
+}
+
+#endif // INTAKE_X86
+
+} // namespace
+
+Summary summarize(const double* values, std::size_t n) {
+#ifdef INTAKE_X86
+    if (have_avx2())
+        return summarize_avx2(values, n);
+#endif
+    return summarize_scalar(values, n);
+}
+
+double quantile(std::span<const double> values, double q) {
+    std::vector<double> scratch;
+    scratch.reserve(values.size());
+    for (double v : values)
+        if (!std::isnan(v))
+            scratch.push_back(v);
+    if (scratch.empty())
+        return std::nan("");
+    q = std::clamp(q, 0.0, 1.0);
+    const double pos = q * static_cast<double>(scratch.size() - 1);
+    const std::size_t lo = static_cast<std::size_t>(pos);
+    std::nth_element(scratch.begin(), scratch.begin() + lo, scratch.end());
+    const double a = scratch[lo];
+    if (lo + 1 >= scratch.size() || pos == static_cast<double>(lo))
+        return a;
+    const double b =
+        *std::min_element(scratch.begin() + lo + 1, scratch.end());
+    return a + (b - a) * (pos - static_cast<double>(lo));
+}
+
+// ---------------------------------------------------------------------------
+// Leaderboard.
+
+bool Leaderboard::ranks_before(const Entry& a, const Entry& b) {
+    if (a.mean() != b.mean())
+        return a.mean() > b.mean();
+    return a.count > b.count; // more scores wins the tie
+}
+
+Leaderboard::Leaderboard(const ColumnarCache& cache, std::string_view sheet,
+                         std::string_view team_col,
+                         std::string_view score_col) {
+    const ColumnarCache::Sheet* sh = cache.sheet(sheet);
+    if (!sh)
+        throw std::runtime_error("leaderboard: no sheet named '" +
+                                 std::string(sheet) + "'");
+    const ColumnarCache::Column* teams = nullptr;
+    const ColumnarCache::Column* scores = nullptr;
+    for (const ColumnarCache::Column& c : sh->columns) {
+        if (c.name == team_col)
+            teams = &c;
+        else if (c.name == score_col)
+            scores = &c;
+    }
+    if (!teams || teams->type != ColumnarCache::ColumnType::String)
+        throw std::runtime_error("leaderboard: missing string column '" +
+                                 std::string(team_col) + "'");
+    if (!scores || scores->type != ColumnarCache::ColumnType::Number)
+        throw std::runtime_error("leaderboard: missing numeric column '" +
+                                 std::string(score_col) + "'");
+
+    std::unordered_map<std::uint32_t, std::uint32_t> by_id;
+    for (std::uint64_t row = 0; row < sh->rows; ++row) {
+        const std::uint32_t id = teams->strings[row];
+        const double v = scores->numbers[row];
+        if (id == ColumnarCache::kNoString || std::isnan(v))
+            continue;
+        const auto [it, fresh] =
+            by_id.try_emplace(id, static_cast<std::uint32_t>(entries_.size()));
+        if (fresh) {
+            entries_.push_back({cache.string_at(id), 0.0, 0});
+            by_team_[entries_.back().team] = it->second;
+        }
+        entries_[it->second].sum += v;
+        ++entries_[it->second].count;
+    }
+
+    ranking_.resize(entries_.size());
+    for (std::uint32_t i = 0; i < ranking_.size(); ++i)
+        ranking_[i] = i;
+    std::sort(ranking_.begin(), ranking_.end(),
+              [this](std::uint32_t a, std::uint32_t b) {
+                  return ranks_before(entries_[a], entries_[b]);
+              });
+    rank_of_.resize(ranking_.size());
+    for (std::uint32_t r = 0; r < ranking_.size(); ++r)
+        rank_of_[ranking_[r]] = r;
+}
+
+void Leaderboard::add_score(std::string_view team, double value) {
+    const auto it = by_team_.find(team);
+    std::uint32_t index;
+    if (it != by_team_.end()) {
+        index = it->second;
+    } else {
+        names_.push_back(std::make_unique<std::string>(team));
+        index = static_cast<std::uint32_t>(entries_.size());
+        entries_.push_back({*names_.back(), 0.0, 0});
+        by_team_[entries_.back().team] = index;
+        ranking_.push_back(index);
+        rank_of_.push_back(static_cast<std::uint32_t>(ranking_.size() - 1));
+    }
+    entries_[index].sum += value;
+    ++entries_[index].count;
+    repair_rank(index);
+}
+
+void Leaderboard::repair_rank(std::size_t entry_index) {
+    // The changed team is the only entry out of place: swap it toward the
+    // front while it outranks its neighbor, then toward the back.
+    std::uint32_t r = rank_of_[entry_index];
+    while (r > 0 &&
+           ranks_before(entries_[ranking_[r]], entries_[ranking_[r - 1]])) {
+        std::swap(ranking_[r], ranking_[r - 1]);
+        rank_of_[ranking_[r]] = r;
+        rank_of_[ranking_[r - 1]] = r - 1;
+        --r;
+    }
+    while (r + 1 < ranking_.size() &&
+           ranks_before(entries_[ranking_[r + 1]], entries_[ranking_[r]])) {
+        std::swap(ranking_[r], ranking_[r + 1]);
+        rank_of_[ranking_[r]] = r;
+        rank_of_[ranking_[r + 1]] = r + 1;
+        ++r;
+    }
+}
+
+std::size_t Leaderboard::rank_of(std::string_view team) const {
+    const auto it = by_team_.find(team);
+    if (it == by_team_.end())
+        return std::string_view::npos;
+    return rank_of_[it->second];
+}
+
+} // namespace intake::agg
@@ -0,0 +1,158 @@
+#include "intake/blake2b.hpp"
+
+#include <cstring>
+
+namespace intake {
+
+namespace {
+
+constexpr std::uint64_t kIV[8] = {
+    0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL,
+    0xa54ff53a5f1d36f1ULL, 0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL,
+    0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL};
+
+constexpr std::uint8_t kSigma[12][16] = {
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+    {11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4},
+    {7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
+    {9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13},
+    {2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
+    {12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11},
+    {13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
+    {6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5},
+    {10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0},
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3}};
+
+std::uint64_t rotr64(std::uint64_t x, int n) {
+    return (x >> n) | (x << (64 - n));
+}
+
+std::uint64_t load64(const std::uint8_t* p) {
+    std::uint64_t v;
+    memcpy(&v, p, 8);
+    return v; // little-endian hosts only, which is all our fleet
+}
+
+} // namespace
+
+Blake2b::Blake2b() {
+    for (int i = 0; i < 8; ++i)
+        h_[i] = kIV[i];
+    // Parameter block: digest length 32, fanout 1, depth 1.
+    h_[0] ^= 0x01010020ULL;
+}
+
+void Blake2b::compress(const std::uint8_t* block, bool last) {
+    std::uint64_t m[16];
+    for (int i = 0; i < 16; ++i)
+        m[i] = load64(block + 8 * i);
+
+    std::uint64_t v[16];
+    for (int i = 0; i < 8; ++i) {
+        v[i] = h_[i];
+        v[i + 8] = kIV[i];
+    }
+    v[12] ^= t_[0];
+    v[13] ^= t_[1];
+    if (last)
+        v[14] = ~v[14];
+
+    auto g = [&](int a, int b, int c, int d, std::uint64_t x, std::uint64_t y) {
+        v[a] = v[a] + v[b] + x;
+        v[d] = rotr64(v[d] ^ v[a], 32);
+        v[c] = v[c] + v[d];
+        v[b] = rotr64(v[b] ^ v[c], 24);
+        v[a] = v[a] + v[b] + y;
+        v[d] = rotr64(v[d] ^ v[a], 16);
+        v[c] = v[c] + v[d];
+        v[b] = rotr64(v[b] ^ v[c], 63);
+    };
+
+    for (int r = 0; r < 12; ++r) {
+        const std::uint8_t* s = kSigma[r];
+        g(0, 4, 8, 12, m[s[0]], m[s[1]]);
+        g(1, 5, 9, 13, m[s[2]], m[s[3]]);
+        g(2, 6, 10, 14, m[s[4]], m[s[5]]);
+        g(3, 7, 11, 15, m[s[6]], m[s[7]]);
+        g(0, 5, 10, 15, m[s[8]], m[s[9]]);
+        g(1, 6, 11, 12, m[s[10]], m[s[11]]);
+        g(2, 7, 8, 13, m[s[12]], m[s[13]]);
+        g(3, 4, 9, 14, m[s[14]], m[s[15]]);
+    }
+
+    for (int i = 0; i < 8; ++i)
+        h_[i] ^= v[i] ^ v[i + 8];
+}
+
+void Blake2b::update(const void* data, std::size_t len) {
+    const std::uint8_t* p = static_cast<const std::uint8_t*>(data);
+    while (len > 0) {
+        if (buf_len_ == 128) {
+            t_[0] += 128;
+            if (t_[0] < 128)
+                ++t_[1];
+            compress(buf_.data(), false);
+            buf_len_ = 0;
+        }
+        const std::size_t take = std::min(len, 128 - buf_len_);
+        memcpy(buf_.data() + buf_len_, p, take);
+        buf_len_ += take;
+        p += take;
+        len -= take;
+    }
+}
+
+Digest Blake2b::finish() {
+    t_[0] += buf_len_;
+    if (t_[0] < buf_len_)
+        ++t_[1];
+    memset(buf_.data() + buf_len_, 0, 128 - buf_len_);
+    compress(buf_.data(), true);
+
+    Digest d;
+    memcpy(d.bytes.data(), h_.data(), d.bytes.size());
+    return d;
+}
+
+Digest Blake2b::hash(std::string_view data) {
+    Blake2b b;
+    b.update(data);
+    return b.finish();
+}
+
+std::string Digest::hex() const {
+    static const char* kHex = "0123456789abcdef";
+    std::string out;
+    out.reserve(64);
+    for (std::uint8_t b : bytes) {
+        out.push_back(kHex[b >> 4]);
+        out.push_back(kHex[b & 0x0f]);
+    }
+    return out;
+}
+
+std::optional<Digest> Digest::from_hex(std::string_view hex) {
+    if (hex.size() != 64)
+        return std::nullopt;
+    Digest d;
+    for (std::size_t i = 0; i < 32; ++i) {
+        auto nib = [](char c) -> int {
+            if (c >= '0' && c <= '9')
+                return c - '0';
+            if (c >= 'a' && c <= 'f')
+                return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F')
+                return c - 'A' + 10;
+            return -1;
+        };
+        const int hi = nib(hex[2 * i]), lo = nib(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0)
+            return std::nullopt;
+        d.bytes[i] = static_cast<std::uint8_t>(hi * 16 + lo);
+    }
+    return d;
+}
+
+} // namespace intake
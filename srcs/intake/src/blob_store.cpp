@@ -0,0 +1,103 @@
+#include "intake/blob_store.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+namespace intake {
+
+BlobStore::BlobStore(std::string root) : root_(std::move(root)) {
+    std::error_code ec;
+    fs::create_directories(fs::path(root_) / "objects", ec);
+    fs::create_directories(fs::path(root_) / "tmp", ec);
+    if (ec)
+        throw std::runtime_error("blobstore: cannot create " + root_ + ": " +
+                                 ec.message());
+}
+
+std::string BlobStore::object_path(const Digest& digest) const {
+    const std::string hex = digest.hex();
+    std::string path;
+    path.reserve(root_.size() + 9 + 64);
+    path += root_;
+    path += "/objects/";
+    path += hex.substr(0, 2);
+    path += '/';
+    path += hex.substr(2);
+    return path;
+}
+
+bool BlobStore::contains(const Digest& digest) const {
+    std::error_code ec;
+    return fs::exists(object_path(digest), ec);
+}
+
+Digest BlobStore::store(std::string_view data) {
+    const Digest digest = Blake2b::hash(data);
+    const std::string dest = object_path(digest);
+
+    std::error_code ec;
+    if (fs::exists(dest, ec)) {
+        stats_.duplicates_skipped.fetch_add(1, std::memory_order_relaxed);
+        stats_.bytes_deduplicated.fetch_add(data.size(),
+                                            std::memory_order_relaxed);
+        return digest;
+    }
+
+    fs::create_directories(fs::path(dest).parent_path(), ec);
+    const std::string tmp = root_ + "/tmp/" + digest.hex() + "." +
+                            std::to_string(::getpid());
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                    0444);
+    if (fd < 0)
+        throw std::runtime_error("blobstore: open " + tmp + ": " +
+                                 std::strerror(errno));
+    const char* p = data.data();
+    std::size_t left = data.size();
+    while (left > 0) {
+        const ssize_t n = ::write(fd, p, left);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            const int err = errno;
+            ::close(fd);
+            ::unlink(tmp.c_str());
+            throw std::runtime_error("blobstore: write: " +
+                                     std::string(std::strerror(err)));
+        }
+        p += n;
+        left -= static_cast<std::size_t>(n);
+    }
+    ::close(fd);
+
+    // rename() is atomic: if a concurrent writer won the race we simply
+    // replace the identical bytes.
+    if (::rename(tmp.c_str(), dest.c_str()) != 0) {
+        const int err = errno;
+        ::unlink(tmp.c_str());
+        throw std::runtime_error("blobstore: rename into " + dest + ": " +
+                                 std::strerror(err));
+    }
+    stats_.blobs_added.fetch_add(1, std::memory_order_relaxed);
+    stats_.bytes_added.fetch_add(data.size(), std::memory_order_relaxed);
+    return digest;
+}
+
+Digest BlobStore::put_bytes(std::string_view data) { return store(data); }
+
+Digest BlobStore::put_file(const std::string& path) {
+    MmapFile file(path);
+    return store(file.view());
+}
+
+MmapFile BlobStore::open(const Digest& digest) const {
+    return MmapFile(object_path(digest));
+}
+
+} // namespace intake
@@ -0,0 +1,338 @@
+#include "intake/columnar_cache.hpp"
+
+#include <sys/stat.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "intake/xlsx_reader.hpp"
+
+namespace intake {
+
+namespace {
+
+constexpr char kMagic[8] = {'I', 'N', 'T', 'A', 'K', 'C', 'C', '1'};
+constexpr std::uint32_t kVersion = 1;
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t sheet_count;
+    std::uint64_t source_size;
+    std::uint64_t source_mtime_ns;
+    std::uint8_t digest[32];
+    std::uint64_t string_table_off;
+    std::uint64_t first_sheet_off;
+};
+
+struct SheetRec {
+    std::uint64_t name_id;
+    std::uint64_t rows; // data rows; the xlsx header row becomes column names
+    std::uint64_t cols;
+};
+
+struct ColRec {
+    std::uint32_t type;
+    std::uint32_t name_id;
+    std::uint64_t data_off;
+};
+
+static_assert(sizeof(FileHeader) == 80);
+static_assert(sizeof(SheetRec) == 24);
+static_assert(sizeof(ColRec) == 16);
+
+std::uint64_t mtime_ns(const struct stat& st) {
+    return static_cast<std::uint64_t>(st.st_mtim.tv_sec) * 1000000000ULL +
+           static_cast<std::uint64_t>(st.st_mtim.tv_nsec);
+}
+
+struct stat stat_or_throw(const std::string& path) {
+    struct stat st {};
+    if (::stat(path.c_str(), &st) != 0)
+        throw std::runtime_error("columnar: cannot stat " + path);
+    return st;
+}
+
+// Build-side accumulation.
+struct BuildColumn {
+    bool has_string = false;
+    std::vector<double> numbers;
+    std::vector<std::uint32_t> strings; // interned ids of raw cell text
+    std::uint32_t name_id = 0;
+};
+
+struct BuildSheet {
+    std::uint32_t name_id = 0;
+    std::uint64_t rows = 0;
+    std::vector<BuildColumn> columns;
+};
+
+class Interner {
+public:
+    Interner() { intern(""); } // id 0: the empty string
+
+    std::uint32_t intern(std::string_view s) {
+        auto it = ids_.find(s);
+        if (it != ids_.end())
+            return it->second;
+        const std::uint32_t id = static_cast<std::uint32_t>(strings_.size());
+        strings_.emplace_back(s);
+        ids_.emplace(strings_.back(), id);
+        return id;
+    }
+
+    const std::vector<std::string>& strings() const { return strings_; }
+
+private:
+    struct SvHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view s) const {
+            return std::hash<std::string_view>{}(s);
+        }
+    };
+
+    std::vector<std::string> strings_;
+    std::unordered_map<std::string, std::uint32_t, SvHash, std::equal_to<>>
+        ids_;
+};
+
+void append(std::vector<unsigned char>& out, const void* p, std::size_t n) {
+    const unsigned char* b = static_cast<const unsigned char*>(p);
+    out.insert(out.end(), b, b + n);
+}
+
+void pad8(std::vector<unsigned char>& out) {
+    while (out.size() % 8 != 0)
+        out.push_back(0);
+}
+
+void write_atomically(const std::string& path,
+                      const std::vector<unsigned char>& bytes) {
+    const std::string tmp = path + ".tmp";
+    FILE* f = std::fopen(tmp.c_str(), "wb");
+    if (f == nullptr)
+        throw std::runtime_error("columnar: cannot write " + tmp);
+    const bool ok = std::fwrite(bytes.data(), 1, bytes.size(), f) ==
+                    bytes.size();
+    std::fclose(f);
+    if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        throw std::runtime_error("columnar: cannot finalize " + path);
+    }
+}
+
+void build_cache(const std::string& xlsx_path, const std::string& cache_path,
+                 const struct stat& st, const Digest& digest) {
+    XlsxReader reader(xlsx_path);
+    Interner interner;
+    std::vector<BuildSheet> sheets;
+
+    for (const std::string& name : reader.sheet_names()) {
+        BuildSheet sheet;
+        sheet.name_id = interner.intern(name);
+
+        // Pass the sheet once; row 1 supplies column names, the rest data.
+        reader.for_each_row(name, [&](std::uint32_t row,
+                                      std::span<const CellView> cells) {
+            for (const CellView& cell : cells) {
+                if (cell.col >= sheet.columns.size())
+                    sheet.columns.resize(cell.col + 1);
+                BuildColumn& col = sheet.columns[cell.col];
+                if (row == 1) {
+                    col.name_id = interner.intern(cell.text);
+                    continue;
+                }
+                const std::uint64_t idx = row - 2; // data row index
+                if (idx >= sheet.rows)
+                    sheet.rows = idx + 1;
+                if (col.numbers.size() < idx + 1) {
+                    col.numbers.resize(
+                        idx + 1, std::numeric_limits<double>::quiet_NaN());
+                    col.strings.resize(idx + 1, ColumnarCache::kNoString);
+                }
+                if (cell.type == CellView::Type::Number ||
+                    cell.type == CellView::Type::Boolean) {
+                    col.numbers[idx] = cell.number();
+                } else {
+                    col.has_string = true;
+                }
+                col.strings[idx] = interner.intern(cell.text);
+            }
+        });
+
+        for (BuildColumn& col : sheet.columns) {
+            col.numbers.resize(sheet.rows,
+                               std::numeric_limits<double>::quiet_NaN());
+            col.strings.resize(sheet.rows, ColumnarCache::kNoString);
+        }
+        sheets.push_back(std::move(sheet));
+    }
+
+    // Serialize: header, sheet metadata, payloads, string table.
+    std::vector<unsigned char> out;
+    FileHeader hdr{};
+    memcpy(hdr.magic, kMagic, 8);
+    hdr.version = kVersion;
+    hdr.sheet_count = static_cast<std::uint32_t>(sheets.size());
+    hdr.source_size = static_cast<std::uint64_t>(st.st_size);
+    hdr.source_mtime_ns = mtime_ns(st);
+    memcpy(hdr.digest, digest.bytes.data(), 32);
+    hdr.first_sheet_off = sizeof(FileHeader);
+    append(out, &hdr, sizeof(hdr)); // re-patched below
+
+    std::vector<std::size_t> col_rec_offsets;
+    for (const BuildSheet& sheet : sheets) {
+        SheetRec rec{sheet.name_id, sheet.rows, sheet.columns.size()};
+        append(out, &rec, sizeof(rec));
+        for (const BuildColumn& col : sheet.columns) {
+            ColRec c{static_cast<std::uint32_t>(
+                         col.has_string ? ColumnarCache::ColumnType::String
+                                        : ColumnarCache::ColumnType::Number),
+                     col.name_id, 0};
+            col_rec_offsets.push_back(out.size());
+            append(out, &c, sizeof(c));
+        }
+    }
+
+    std::size_t rec_i = 0;
+    for (const BuildSheet& sheet : sheets) {
+        for (const BuildColumn& col : sheet.columns) {
+            pad8(out);
+            const std::uint64_t off = out.size();
+            memcpy(out.data() + col_rec_offsets[rec_i] + offsetof(ColRec, data_off),
+                   &off, sizeof(off));
+            if (col.has_string)
+                append(out, col.strings.data(), col.strings.size() * 4);
+            else
+                append(out, col.numbers.data(), col.numbers.size() * 8);
+            ++rec_i;
+        }
+    }
+
+    pad8(out);
+    const std::uint64_t table_off = out.size();
+    memcpy(out.data() + offsetof(FileHeader, string_table_off), &table_off, 8);
+    const std::uint64_t count = interner.strings().size();
+    append(out, &count, 8);
+    std::uint64_t running =
+        table_off + 8 + (count + 1) * 8; // bytes begin after the offsets
+    for (const std::string& s : interner.strings()) {
+        append(out, &running, 8);
+        running += s.size();
+    }
+    append(out, &running, 8);
+    for (const std::string& s : interner.strings())
+        append(out, s.data(), s.size());
+
+    write_atomically(cache_path, out);
+}
+
+} // namespace
+
+void ColumnarCache::attach(MmapFile file) {
+    file_ = std::move(file);
+    if (file_.size() < sizeof(FileHeader))
+        throw std::runtime_error("columnar: cache file too small");
+    const unsigned char* base = file_.data();
+    FileHeader hdr;
+    memcpy(&hdr, base, sizeof(hdr));
+    if (memcmp(hdr.magic, kMagic, 8) != 0 || hdr.version != kVersion)
+        throw std::runtime_error("columnar: bad cache header");
+    memcpy(source_digest_.bytes.data(), hdr.digest, 32);
+
+    const std::uint64_t table_off = hdr.string_table_off;
+    if (table_off + 8 > file_.size())
+        throw std::runtime_error("columnar: truncated string table");
+    memcpy(&string_count_, base + table_off, 8);
+    string_offsets_ =
+        reinterpret_cast<const std::uint64_t*>(base + table_off + 8);
+    string_bytes_ = reinterpret_cast<const char*>(base);
+
+    std::size_t at = hdr.first_sheet_off;
+    sheets_.reserve(hdr.sheet_count);
+    for (std::uint32_t i = 0; i < hdr.sheet_count; ++i) {
+        SheetRec rec;
+        memcpy(&rec, base + at, sizeof(rec));
+        at += sizeof(rec);
+        Sheet sheet;
+        sheet.name = string_at(static_cast<std::uint32_t>(rec.name_id));
+        sheet.rows = rec.rows;
+        sheet.columns.reserve(rec.cols);
+        for (std::uint64_t c = 0; c < rec.cols; ++c) {
+            ColRec cr;
+            memcpy(&cr, base + at, sizeof(cr));
+            at += sizeof(cr);
+            Column col{};
+            col.type = static_cast<ColumnType>(cr.type);
+            col.name = string_at(cr.name_id);
+            if (col.type == ColumnType::Number)
+                col.numbers =
+                    reinterpret_cast<const double*>(base + cr.data_off);
+            else
+                col.strings =
+                    reinterpret_cast<const std::uint32_t*>(base + cr.data_off);
+            sheet.columns.push_back(col);
+        }
+        sheets_.push_back(std::move(sheet));
+    }
+}
+
+std::string_view ColumnarCache::string_at(std::uint32_t id) const {
+    if (id >= string_count_)
+        return {};
+    return std::string_view(string_bytes_ + string_offsets_[id],
+                            string_offsets_[id + 1] - string_offsets_[id]);
+}
+
+const ColumnarCache::Sheet* ColumnarCache::sheet(std::string_view name) const {
+    for (const Sheet& s : sheets_)
+        if (s.name == name)
+            return &s;
+    return nullptr;
+}
+
+ColumnarCache ColumnarCache::open(const std::string& cache_path) {
+    ColumnarCache cache;
+    cache.attach(MmapFile(cache_path));
+    return cache;
+}
+
+ColumnarCache ColumnarCache::open_or_build(const std::string& xlsx_path,
+                                           const std::string& cache_path) {
+    const struct stat st = stat_or_throw(xlsx_path);
+
+    // Fast path: size and mtime match what the cache recorded.
+    try {
+        MmapFile existing(cache_path);
+        if (existing.size() >= sizeof(FileHeader)) {
+            FileHeader hdr;
+            memcpy(&hdr, existing.data(), sizeof(hdr));
+            if (memcmp(hdr.magic, kMagic, 8) == 0 && hdr.version == kVersion &&
+                hdr.source_size == static_cast<std::uint64_t>(st.st_size) &&
+                hdr.source_mtime_ns == mtime_ns(st)) {
+                ColumnarCache cache;
+                cache.attach(std::move(existing));
+                return cache;
+            }
+            // mtime moved: only rebuild if the content actually changed.
+            MmapFile src(xlsx_path);
+            const Digest digest = Blake2b::hash(src.view());
+            if (memcmp(hdr.digest, digest.bytes.data(), 32) == 0) {
+                ColumnarCache cache;
+                cache.attach(std::move(existing));
+                return cache;
+            }
+        }
+    } catch (const std::exception&) {
+        // Missing or unreadable cache: rebuild below.
+    }
+
+    MmapFile src(xlsx_path);
+    build_cache(xlsx_path, cache_path, st, Blake2b::hash(src.view()));
+    return open(cache_path);
+}
+
+} // namespace intake
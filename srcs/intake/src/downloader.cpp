@@ -0,0 +1,806 @@
+#include "intake/downloader.hpp"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/tcp.h>
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+
+#include "intake/mmap_file.hpp"
+
+namespace intake {
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// URL handling.
+
+struct Url {
+    bool tls = false;
+    std::string host;
+    std::uint16_t port = 80;
+    std::string path; // includes query
+};
+
+bool parse_url(const std::string& url, Url& out) {
+    std::string_view s(url);
+    if (s.starts_with("https://")) {
+        out.tls = true;
+        out.port = 443;
+        s.remove_prefix(8);
+    } else if (s.starts_with("http://")) {
+        out.tls = false;
+        out.port = 80;
+        s.remove_prefix(7);
+    } else {
+        return false;
+    }
+    const std::size_t slash = s.find('/');
+    std::string_view hostport = s.substr(0, slash);
+    out.path = slash == std::string_view::npos ? "/" : std::string(s.substr(slash));
+    const std::size_t colon = hostport.rfind(':');
+    if (colon != std::string_view::npos) {
+        out.host = std::string(hostport.substr(0, colon));
+        out.port = static_cast<std::uint16_t>(
+            std::strtoul(std::string(hostport.substr(colon + 1)).c_str(),
+                         nullptr, 10));
+    } else {
+        out.host = std::string(hostport);
+    }
+    return !out.host.empty();
+}
+
+// ---------------------------------------------------------------------------
+// Per-file and per-connection state.
+
+struct FileJob;
+
+struct ChunkTask {
+    FileJob* job = nullptr;
+    std::uint64_t offset = 0;
+    std::uint64_t length = 0; // 0 = open-ended (first request / whole file)
+    bool first = false;       // first request of the job (discovers the size)
+    int redirects_left = 5;
+    int retries_left = 3;
+    Url url; // may differ from the job's after a redirect
+};
+
+struct FileJob {
+    Downloader::Item item;
+    Url url;
+    int dest_fd = -1;
+    std::uint64_t total_size = 0; // 0 until the first response reveals it
+    bool size_known = false;
+    std::size_t chunks_outstanding = 0;
+    std::uint64_t bytes_transferred = 0;
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> resumed; // off,len
+    bool failed = false;
+    std::string error;
+    bool done = false;
+
+    std::string progress_path() const { return item.dest + ".progress"; }
+};
+
+enum class ConnState {
+    Connecting,
+    TlsHandshake,
+    SendRequest,
+    ReadHeaders,
+    ReadBody,
+    Done,
+    Failed,
+};
+
+struct Conn {
+    int fd = -1;
+    SSL* ssl = nullptr;
+    ConnState state = ConnState::Connecting;
+    ChunkTask task;
+
+    std::string request;
+    std::size_t request_sent = 0;
+    std::string header_buf;
+
+    int status = 0;
+    std::uint64_t body_expected = 0; // from Content-Length (0 = until EOF)
+    bool body_until_eof = false;
+    bool chunked = false;
+    std::uint64_t body_received = 0;
+    std::uint64_t write_offset = 0;
+    std::string location; // redirect target
+    std::uint64_t content_range_total = 0;
+
+    // chunked-transfer decoder state
+    std::string chunk_line;
+    std::uint64_t chunk_left = 0;
+    bool chunk_reading_size = true;
+    bool chunk_done = false;
+
+    std::string error;
+    std::uint32_t events = 0; // currently registered epoll interest
+};
+
+// ---------------------------------------------------------------------------
+// The engine.
+
+class Engine {
+public:
+    explicit Engine(const Downloader::Options& options) : options_(options) {
+        epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd_ < 0)
+            throw std::runtime_error("downloader: epoll_create1 failed");
+        const SSL_METHOD* method = TLS_client_method();
+        ssl_ctx_ = SSL_CTX_new(method);
+        if (ssl_ctx_ == nullptr)
+            throw std::runtime_error("downloader: SSL_CTX_new failed");
+        SSL_CTX_set_default_verify_paths(ssl_ctx_);
+        SSL_CTX_set_verify(ssl_ctx_,
+                           options_.verify_tls ? SSL_VERIFY_PEER
+                                               : SSL_VERIFY_NONE,
+                           nullptr);
+    }
+
+    ~Engine() {
+        for (auto& [fd, conn] : conns_)
+            close_conn_fd(*conn);
+        if (ssl_ctx_ != nullptr)
+            SSL_CTX_free(ssl_ctx_);
+        ::close(epoll_fd_);
+    }
+
+    std::vector<Downloader::Result> run(std::span<const Downloader::Item> items);
+
+private:
+    void enqueue_job(const Downloader::Item& item);
+    void start_task(ChunkTask task);
+    void fail_task(Conn& conn, const std::string& why);
+    void finish_task(Conn& conn);
+    void drive(Conn& conn, std::uint32_t revents);
+    void update_interest(Conn& conn, std::uint32_t events);
+    void close_conn_fd(Conn& conn);
+    void remove_conn(int fd);
+    bool handle_headers(Conn& conn);
+    bool consume_body(Conn& conn, const char* data, std::size_t len);
+    void on_first_response(Conn& conn);
+    void complete_job(FileJob& job);
+    void fail_job(FileJob& job, const std::string& why);
+    void record_progress(FileJob& job, std::uint64_t off, std::uint64_t len);
+    bool pending_empty_for(const FileJob& job);
+
+    Downloader::Options options_;
+    int epoll_fd_ = -1;
+    SSL_CTX* ssl_ctx_ = nullptr;
+    std::deque<ChunkTask> pending_;
+    std::map<int, std::unique_ptr<Conn>> conns_;
+    std::vector<std::unique_ptr<FileJob>> jobs_;
+};
+
+void Engine::enqueue_job(const Downloader::Item& item) {
+    auto job = std::make_unique<FileJob>();
+    job->item = item;
+    if (!parse_url(item.url, job->url)) {
+        job->failed = true;
+        job->done = true;
+        job->error = "bad url";
+        jobs_.push_back(std::move(job));
+        return;
+    }
+
+    // Resume journal: offsets already on disk from an interrupted run.
+    std::ifstream progress(job->progress_path());
+    std::uint64_t off = 0, len = 0;
+    while (progress >> off >> len)
+        job->resumed.emplace_back(off, len);
+
+    ChunkTask first;
+    first.job = job.get();
+    first.first = true;
+    first.url = job->url;
+    first.redirects_left = options_.max_redirects;
+    first.retries_left = options_.max_retries;
+    // The first request asks for the opening chunk; a 206 reveals the total
+    // size via Content-Range and the rest of the file fans out in parallel.
+    first.offset = 0;
+    first.length = options_.chunk_size;
+    pending_.push_back(std::move(first));
+    job->chunks_outstanding = 1;
+    jobs_.push_back(std::move(job));
+}
+
+void Engine::start_task(ChunkTask task) {
+    struct addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* res = nullptr;
+    const std::string port = std::to_string(task.url.port);
+    if (::getaddrinfo(task.url.host.c_str(), port.c_str(), &hints, &res) != 0 ||
+        res == nullptr) {
+        Conn tmp;
+        tmp.task = std::move(task);
+        fail_task(tmp, "dns resolution failed");
+        return;
+    }
+    int fd = ::socket(res->ai_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                      0);
+    if (fd < 0) {
+        ::freeaddrinfo(res);
+        Conn tmp;
+        tmp.task = std::move(task);
+        fail_task(tmp, "socket failed");
+        return;
+    }
+    const int rc = ::connect(fd, res->ai_addr, res->ai_addrlen);
+    ::freeaddrinfo(res);
+    if (rc != 0 && errno != EINPROGRESS) {
+        ::close(fd);
+        Conn tmp;
+        tmp.task = std::move(task);
+        fail_task(tmp, "connect failed");
+        return;
+    }
+
+    auto conn = std::make_unique<Conn>();
+    conn->fd = fd;
+    conn->task = std::move(task);
+    conn->state = ConnState::Connecting;
+
+    struct epoll_event ev{};
+    ev.events = EPOLLOUT;
+    ev.data.fd = fd;
+    conn->events = EPOLLOUT;
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev);
+    conns_.emplace(fd, std::move(conn));
+}
+
+void Engine::update_interest(Conn& conn, std::uint32_t events) {
+    if (events == conn.events)
+        return;
+    struct epoll_event ev{};
+    ev.events = events;
+    ev.data.fd = conn.fd;
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, conn.fd, &ev);
+    conn.events = events;
+}
+
+void Engine::close_conn_fd(Conn& conn) {
+    if (conn.ssl != nullptr) {
+        SSL_free(conn.ssl);
+        conn.ssl = nullptr;
+    }
+    if (conn.fd >= 0) {
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, conn.fd, nullptr);
+        ::close(conn.fd);
+        conn.fd = -1;
+    }
+}
+
+void Engine::remove_conn(int fd) { conns_.erase(fd); }
+
+void Engine::fail_job(FileJob& job, const std::string& why) {
+    if (!job.done) {
+        job.failed = true;
+        job.done = true;
+        job.error = why;
+    }
+}
+
+void Engine::fail_task(Conn& conn, const std::string& why) {
+    ChunkTask task = std::move(conn.task);
+    close_conn_fd(conn);
+    if (task.retries_left-- > 0 && task.job != nullptr && !task.job->done) {
+        pending_.push_back(std::move(task));
+        return;
+    }
+    if (task.job != nullptr) {
+        task.job->chunks_outstanding--;
+        fail_job(*task.job, why);
+    }
+}
+
+void Engine::record_progress(FileJob& job, std::uint64_t off,
+                             std::uint64_t len) {
+    std::ofstream out(job.progress_path(), std::ios::app);
+    out << off << ' ' << len << '\n';
+}
+
+void Engine::complete_job(FileJob& job) {
+    if (job.dest_fd >= 0) {
+        ::close(job.dest_fd);
+        job.dest_fd = -1;
+    }
+    if (job.item.digest) {
+        try {
+            MmapFile file(job.item.dest);
+            if (!(Blake2b::hash(file.view()) == *job.item.digest)) {
+                // Corrupt mirror: drop the journal so the next run refetches.
+                std::remove(job.progress_path().c_str());
+                fail_job(job, "digest mismatch after download");
+                return;
+            }
+        } catch (const std::exception& e) {
+            fail_job(job, e.what());
+            return;
+        }
+    }
+    std::remove(job.progress_path().c_str());
+    job.done = true;
+}
+
+void Engine::on_first_response(Conn& conn) {
+    FileJob& job = *conn.task.job;
+    if (conn.status == 206 && conn.content_range_total > 0) {
+        job.total_size = conn.content_range_total;
+        job.size_known = true;
+        // Files smaller than one chunk return less than we asked for.
+        if (conn.task.offset + conn.task.length > job.total_size)
+            conn.task.length = job.total_size - conn.task.offset;
+    } else {
+        // Server ignored the range: the whole body arrives on this
+        // connection.
+        job.total_size = conn.body_expected;
+        job.size_known = !conn.body_until_eof && !conn.chunked;
+        conn.task.length = 0;
+    }
+
+    job.dest_fd = ::open(job.item.dest.c_str(),
+                         O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+    if (job.dest_fd < 0) {
+        fail_task(conn, "cannot open destination " + job.item.dest);
+        return;
+    }
+    if (job.size_known)
+        (void)!::ftruncate(job.dest_fd, static_cast<off_t>(job.total_size));
+
+    // Fan the rest of the file out as parallel range chunks, skipping
+    // anything the resume journal already has.
+    if (conn.status == 206 && job.size_known) {
+        for (std::uint64_t off = options_.chunk_size; off < job.total_size;
+             off += options_.chunk_size) {
+            const std::uint64_t len =
+                std::min<std::uint64_t>(options_.chunk_size,
+                                        job.total_size - off);
+            const bool resumed =
+                std::find(job.resumed.begin(), job.resumed.end(),
+                          std::make_pair(off, len)) != job.resumed.end();
+            if (resumed)
+                continue;
+            ChunkTask chunk;
+            chunk.job = &job;
+            chunk.offset = off;
+            chunk.length = len;
+            chunk.url = job.url;
+            chunk.redirects_left = options_.max_redirects;
+            chunk.retries_left = options_.max_retries;
+            job.chunks_outstanding++;
+            pending_.push_back(std::move(chunk));
+        }
+    }
+}
+
+bool Engine::handle_headers(Conn& conn) {
+    const std::size_t end = conn.header_buf.find("\r\n\r\n");
+    if (end == std::string::npos)
+        return true; // need more bytes
+
+    std::string_view headers(conn.header_buf.data(), end);
+    const std::size_t line_end = headers.find("\r\n");
+    std::string_view status_line = headers.substr(0, line_end);
+    if (status_line.size() < 12 || !status_line.starts_with("HTTP/")) {
+        fail_task(conn, "malformed status line");
+        return false;
+    }
+    conn.status = std::atoi(std::string(status_line.substr(9, 3)).c_str());
+
+    std::size_t at = line_end == std::string_view::npos ? end : line_end + 2;
+    while (at < headers.size()) {
+        std::size_t eol = headers.find("\r\n", at);
+        if (eol == std::string_view::npos)
+            eol = headers.size();
+        std::string_view line = headers.substr(at, eol - at);
+        at = eol + 2;
+        const std::size_t colon = line.find(':');
+        if (colon == std::string_view::npos)
+            continue;
+        std::string key(line.substr(0, colon));
+        for (char& c : key)
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        std::string_view value = line.substr(colon + 1);
+        while (!value.empty() && value.front() == ' ')
+            value.remove_prefix(1);
+        if (key == "content-length") {
+            conn.body_expected =
+                std::strtoull(std::string(value).c_str(), nullptr, 10);
+        } else if (key == "transfer-encoding") {
+            conn.chunked = value.find("chunked") != std::string_view::npos;
+        } else if (key == "location") {
+            conn.location = std::string(value);
+        } else if (key == "content-range") {
+            const std::size_t slash = value.rfind('/');
+            if (slash != std::string_view::npos && value[slash + 1] != '*')
+                conn.content_range_total = std::strtoull(
+                    std::string(value.substr(slash + 1)).c_str(), nullptr, 10);
+        }
+    }
+
+    // Redirect?
+    if (conn.status >= 300 && conn.status < 400 && !conn.location.empty()) {
+        ChunkTask task = std::move(conn.task);
+        close_conn_fd(conn);
+        if (task.redirects_left-- <= 0) {
+            task.job->chunks_outstanding--;
+            fail_job(*task.job, "too many redirects");
+            return false;
+        }
+        Url target;
+        if (!parse_url(conn.location, target)) {
+            task.job->chunks_outstanding--;
+            fail_job(*task.job, "bad redirect location");
+            return false;
+        }
+        if (task.first)
+            task.job->url = target;
+        task.url = target;
+        pending_.push_back(std::move(task));
+        return false;
+    }
+
+    if (conn.status != 200 && conn.status != 206) {
+        fail_task(conn, "http status " + std::to_string(conn.status));
+        return false;
+    }
+
+    conn.body_until_eof = !conn.chunked && conn.body_expected == 0;
+    if (conn.task.first)
+        on_first_response(conn);
+    if (conn.state == ConnState::Failed)
+        return false;
+    conn.write_offset = conn.task.offset;
+    conn.state = ConnState::ReadBody;
+
+    // Whatever body bytes arrived with the headers.
+    const std::string tail = conn.header_buf.substr(end + 4);
+    conn.header_buf.clear();
+    if (!tail.empty())
+        return consume_body(conn, tail.data(), tail.size());
+    return true;
+}
+
+bool Engine::consume_body(Conn& conn, const char* data, std::size_t len) {
+    FileJob& job = *conn.task.job;
+    auto write_out = [&](const char* p, std::size_t n) -> bool {
+        while (n > 0) {
+            const ssize_t w = ::pwrite(job.dest_fd, p, n,
+                                       static_cast<off_t>(conn.write_offset));
+            if (w < 0) {
+                if (errno == EINTR)
+                    continue;
+                fail_task(conn, "write failed: " +
+                                    std::string(std::strerror(errno)));
+                return false;
+            }
+            conn.write_offset += static_cast<std::uint64_t>(w);
+            conn.body_received += static_cast<std::uint64_t>(w);
+            job.bytes_transferred += static_cast<std::uint64_t>(w);
+            p += w;
+            n -= static_cast<std::size_t>(w);
+        }
+        return true;
+    };
+
+    if (!conn.chunked)
+        return write_out(data, len);
+
+    // Minimal chunked-transfer decoder.
+    std::size_t i = 0;
+    while (i < len) {
+        if (conn.chunk_reading_size) {
+            const char c = data[i++];
+            conn.chunk_line.push_back(c);
+            if (c == '\n') {
+                conn.chunk_left =
+                    std::strtoull(conn.chunk_line.c_str(), nullptr, 16);
+                conn.chunk_line.clear();
+                conn.chunk_reading_size = false;
+                if (conn.chunk_left == 0) {
+                    conn.chunk_done = true;
+                    return true;
+                }
+            }
+            continue;
+        }
+        if (conn.chunk_left == 0) {
+            // consume the CRLF after the chunk payload
+            if (data[i] == '\r' || data[i] == '\n') {
+                if (data[i] == '\n')
+                    conn.chunk_reading_size = true;
+                ++i;
+                continue;
+            }
+            conn.chunk_reading_size = true;
+            continue;
+        }
+        const std::size_t take =
+            std::min<std::size_t>(conn.chunk_left, len - i);
+        if (!write_out(data + i, take))
+            return false;
+        conn.chunk_left -= take;
+        i += take;
+    }
+    return true;
+}
+
+void Engine::finish_task(Conn& conn) {
+    FileJob& job = *conn.task.job;
+    const std::uint64_t off = conn.task.offset;
+    const std::uint64_t expected = conn.task.length;
+    const std::uint64_t got = conn.body_received;
+    ChunkTask task = std::move(conn.task);
+    close_conn_fd(conn);
+    job.chunks_outstanding--;
+
+    if (expected != 0 && got != expected) {
+        // Short range read: retry the chunk.
+        if (task.retries_left-- > 0 && !job.done) {
+            job.chunks_outstanding++;
+            pending_.push_back(std::move(task));
+            return;
+        }
+        fail_job(job, "short read on range");
+        return;
+    }
+    if (expected != 0)
+        record_progress(job, off, got);
+    if (job.chunks_outstanding == 0 && pending_empty_for(job))
+        complete_job(job);
+}
+
+bool Engine::pending_empty_for(const FileJob& job) {
+    for (const ChunkTask& t : pending_)
+        if (t.job == &job)
+            return false;
+    return true;
+}
+
+void Engine::drive(Conn& conn, std::uint32_t revents) {
+    if ((revents & (EPOLLERR | EPOLLHUP)) != 0 &&
+        conn.state != ConnState::ReadBody) {
+        fail_task(conn, "connection error");
+        return;
+    }
+
+    if (conn.state == ConnState::Connecting) {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        ::getsockopt(conn.fd, SOL_SOCKET, SO_ERROR, &err, &len);
+        if (err != 0) {
+            fail_task(conn, std::string("connect: ") + std::strerror(err));
+            return;
+        }
+        if (conn.task.url.tls) {
+            conn.ssl = SSL_new(ssl_ctx_);
+            SSL_set_fd(conn.ssl, conn.fd);
+            SSL_set_tlsext_host_name(conn.ssl, conn.task.url.host.c_str());
+            SSL_set1_host(conn.ssl, conn.task.url.host.c_str());
+            conn.state = ConnState::TlsHandshake;
+        } else {
+            conn.state = ConnState::SendRequest;
+        }
+    }
+
+    if (conn.state == ConnState::TlsHandshake) {
+        const int rc = SSL_connect(conn.ssl);
+        if (rc == 1) {
+            conn.state = ConnState::SendRequest;
+        } else {
+            const int want = SSL_get_error(conn.ssl, rc);
+            if (want == SSL_ERROR_WANT_READ) {
+                update_interest(conn, EPOLLIN);
+                return;
+            }
+            if (want == SSL_ERROR_WANT_WRITE) {
+                update_interest(conn, EPOLLOUT);
+                return;
+            }
+            fail_task(conn, "tls handshake failed");
+            return;
+        }
+    }
+
+    if (conn.state == ConnState::SendRequest) {
+        if (conn.request.empty()) {
+            const ChunkTask& t = conn.task;
+            conn.request = "GET " + t.url.path + " HTTP/1.1\r\nHost: " +
+                           t.url.host + "\r\nUser-Agent: intake-mirror/1\r\n";
+            if (t.length != 0)
+                conn.request += "Range: bytes=" + std::to_string(t.offset) +
+                                "-" +
+                                std::to_string(t.offset + t.length - 1) +
+                                "\r\n";
+            conn.request += "Connection: close\r\n\r\n";
+        }
+        while (conn.request_sent < conn.request.size()) {
+            ssize_t n;
+            if (conn.ssl != nullptr) {
+                n = SSL_write(conn.ssl,
+                              conn.request.data() + conn.request_sent,
+                              static_cast<int>(conn.request.size() -
+                                               conn.request_sent));
+                if (n <= 0) {
+                    const int want = SSL_get_error(conn.ssl,
+                                                   static_cast<int>(n));
+                    if (want == SSL_ERROR_WANT_WRITE ||
+                        want == SSL_ERROR_WANT_READ) {
+                        update_interest(conn, want == SSL_ERROR_WANT_READ
+                                                  ? EPOLLIN
+                                                  : EPOLLOUT);
+                        return;
+                    }
+                    fail_task(conn, "tls write failed");
+                    return;
+                }
+            } else {
+                n = ::send(conn.fd, conn.request.data() + conn.request_sent,
+                           conn.request.size() - conn.request_sent,
+                           MSG_NOSIGNAL);
+                if (n < 0) {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                        update_interest(conn, EPOLLOUT);
+                        return;
+                    }
+                    fail_task(conn, "send failed");
+                    return;
+                }
+            }
+            conn.request_sent += static_cast<std::size_t>(n);
+        }
+        conn.state = ConnState::ReadHeaders;
+        update_interest(conn, EPOLLIN);
+    }
+
+    if (conn.state == ConnState::ReadHeaders ||
+        conn.state == ConnState::ReadBody) {
+        char buf[64 * 1024];
+        while (true) {
+            ssize_t n;
+            if (conn.ssl != nullptr) {
+                n = SSL_read(conn.ssl, buf, sizeof(buf));
+                if (n <= 0) {
+                    const int want = SSL_get_error(conn.ssl,
+                                                   static_cast<int>(n));
+                    if (want == SSL_ERROR_WANT_READ) {
+                        update_interest(conn, EPOLLIN);
+                        return;
+                    }
+                    if (want == SSL_ERROR_WANT_WRITE) {
+                        update_interest(conn, EPOLLOUT);
+                        return;
+                    }
+                    n = 0; // clean or dirty close: treat as EOF
+                }
+            } else {
+                n = ::recv(conn.fd, buf, sizeof(buf), 0);
+                if (n < 0) {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK)
+                        return;
+                    fail_task(conn, "recv failed");
+                    return;
+                }
+            }
+            if (n == 0) {
+                // EOF. Valid end for until-EOF bodies and after full bodies.
+                if (conn.state == ConnState::ReadBody &&
+                    (conn.body_until_eof || conn.chunk_done ||
+                     (conn.body_expected != 0 &&
+                      conn.body_received >= conn.body_expected))) {
+                    finish_task(conn);
+                } else {
+                    fail_task(conn, "connection closed early");
+                }
+                return;
+            }
+            if (conn.state == ConnState::ReadHeaders) {
+                conn.header_buf.append(buf, static_cast<std::size_t>(n));
+                if (conn.header_buf.size() > 256 * 1024) {
+                    fail_task(conn, "oversized response headers");
+                    return;
+                }
+                if (!handle_headers(conn))
+                    return; // redirected, failed, or consumed elsewhere
+                if (conn.state != ConnState::ReadBody)
+                    continue;
+            } else {
+                if (!consume_body(conn, buf, static_cast<std::size_t>(n)))
+                    return;
+            }
+            // Completed a counted body without waiting for EOF?
+            if (conn.state == ConnState::ReadBody &&
+                ((conn.body_expected != 0 &&
+                  conn.body_received >= conn.body_expected) ||
+                 conn.chunk_done)) {
+                finish_task(conn);
+                return;
+            }
+        }
+    }
+}
+
+std::vector<Downloader::Result>
+Engine::run(std::span<const Downloader::Item> items) {
+    for (const Downloader::Item& item : items)
+        enqueue_job(item);
+
+    struct epoll_event events[64];
+    while (true) {
+        // Admit pending tasks up to the connection budget.
+        while (!pending_.empty() && conns_.size() < options_.max_connections) {
+            ChunkTask task = std::move(pending_.front());
+            pending_.pop_front();
+            if (task.job->done) { // job already failed; drop its chunks
+                task.job->chunks_outstanding--;
+                continue;
+            }
+            start_task(std::move(task));
+        }
+        if (conns_.empty() && pending_.empty())
+            break;
+        if (conns_.empty())
+            continue; // all pending tasks failed synchronously
+
+        const int n = ::epoll_wait(epoll_fd_, events, 64, 1000);
+        std::vector<int> dead;
+        for (int i = 0; i < n; ++i) {
+            const int fd = events[i].data.fd;
+            auto it = conns_.find(fd);
+            if (it == conns_.end())
+                continue;
+            drive(*it->second, events[i].events);
+            if (it->second->fd < 0)
+                dead.push_back(fd);
+        }
+        for (int fd : dead)
+            remove_conn(fd);
+    }
+
+    std::vector<Downloader::Result> out;
+    out.reserve(jobs_.size());
+    for (auto& job : jobs_) {
+        if (!job->done && !job->failed)
+            complete_job(*job); // jobs finishing on the last loop turn
+        Downloader::Result r;
+        r.url = job->item.url;
+        r.dest = job->item.dest;
+        r.ok = !job->failed;
+        r.bytes = job->bytes_transferred;
+        r.error = job->error;
+        if (job->dest_fd >= 0)
+            ::close(job->dest_fd);
+        out.push_back(std::move(r));
+    }
+    return out;
+}
+
+} // namespace
+
+Downloader::Downloader(Options options) : options_(options) {}
+
+std::vector<Downloader::Result>
+Downloader::fetch(std::span<const Item> items) {
+    Engine engine(options_);
+    return engine.run(items);
+}
+
+} // namespace intake
@@ -0,0 +1,184 @@
+#include "intake/extraction_cache.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace intake {
+
+namespace {
+
+constexpr char kMagic[8] = {'I', 'N', 'T', 'A', 'K', 'P', 'X', '1'};
+constexpr std::uint32_t kVersion = 1;
+
+struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t ok;
+    std::uint64_t page_count; // 1 delimiting pair when !ok (error string)
+};
+static_assert(sizeof(Header) == 24);
+
+void write_atomically(const std::string& dest, const std::string& bytes) {
+    std::error_code ec;
+    fs::create_directories(fs::path(dest).parent_path(), ec);
+    const std::string tmp = dest + ".tmp." + std::to_string(::getpid());
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                    0444);
+    if (fd < 0)
+        throw std::runtime_error("extract-cache: open " + tmp + ": " +
+                                 std::strerror(errno));
+    const char* p = bytes.data();
+    std::size_t left = bytes.size();
+    while (left > 0) {
+        const ssize_t n = ::write(fd, p, left);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            const int err = errno;
+            ::close(fd);
+            ::unlink(tmp.c_str());
+            throw std::runtime_error("extract-cache: write: " +
+                                     std::string(std::strerror(err)));
+        }
+        p += n;
+        left -= static_cast<std::size_t>(n);
+    }
+    ::close(fd);
+    if (::rename(tmp.c_str(), dest.c_str()) != 0) {
+        const int err = errno;
+        ::unlink(tmp.c_str());
+        throw std::runtime_error("extract-cache: rename into " + dest + ": " +
+                                 std::strerror(err));
+    }
+}
+
+} // namespace
+
+std::string_view CachedExtraction::page(std::size_t index) const {
+    if (index >= page_count_)
+        return {};
+    return {base_ + offsets_[index],
+            static_cast<std::size_t>(offsets_[index + 1] - offsets_[index])};
+}
+
+ExtractionCache::ExtractionCache(std::string root) : root_(std::move(root)) {
+    std::error_code ec;
+    fs::create_directories(fs::path(root_) / "extract", ec);
+    if (ec)
+        throw std::runtime_error("extract-cache: cannot create " + root_ +
+                                 ": " + ec.message());
+}
+
+std::string ExtractionCache::entry_path(const Digest& digest) const {
+    const std::string hex = digest.hex();
+    return root_ + "/extract/" + hex.substr(0, 2) + "/" + hex.substr(2);
+}
+
+std::optional<CachedExtraction>
+ExtractionCache::lookup(const Digest& digest) const {
+    const std::string path = entry_path(digest);
+    std::error_code ec;
+    if (!fs::exists(path, ec))
+        return std::nullopt;
+
+    CachedExtraction out;
+    out.file_ = std::make_shared<MmapFile>(path);
+    const char* base = reinterpret_cast<const char*>(out.file_->data());
+    if (out.file_->size() < sizeof(Header))
+        throw std::runtime_error("extract-cache: truncated entry " + path);
+    Header hdr;
+    std::memcpy(&hdr, base, sizeof(hdr));
+    if (std::memcmp(hdr.magic, kMagic, 8) != 0 || hdr.version != kVersion)
+        throw std::runtime_error("extract-cache: bad entry header " + path);
+
+    const std::uint64_t pairs = hdr.ok ? hdr.page_count : 1;
+    if (sizeof(Header) + (pairs + 1) * 8 > out.file_->size())
+        throw std::runtime_error("extract-cache: truncated entry " + path);
+    out.offsets_ = reinterpret_cast<const std::uint64_t*>(base +
+                                                          sizeof(Header));
+    out.base_ = base;
+    out.ok_ = hdr.ok != 0;
+    if (out.ok_) {
+        out.page_count_ = hdr.page_count;
+    } else {
+        out.error_ = {base + out.offsets_[0],
+                      static_cast<std::size_t>(out.offsets_[1] -
+                                               out.offsets_[0])};
+    }
+    return out;
+}
+
+CachedExtraction ExtractionCache::get_or_extract(const std::string& pdf_path,
+                                                 PdfExtractor& extractor,
+                                                 Digest* digest_out) {
+    MmapFile file(pdf_path);
+    const Digest digest = Blake2b::hash(file.view());
+    if (digest_out)
+        *digest_out = digest;
+
+    if (auto hit = lookup(digest)) {
+        ++stats_.hits;
+        return *hit;
+    }
+    ++stats_.misses;
+
+    // Miss: extract, then persist pages (or the failure) and re-open the
+    // mmap'd entry so hit and miss hand back the same zero-copy shape.
+    std::vector<std::pair<std::uint32_t, std::string>> pages;
+    std::string error;
+    bool ok = true;
+    try {
+        extractor.extract_file(pdf_path,
+                               [&](std::uint32_t page, std::string_view t) {
+                                   pages.emplace_back(page, std::string(t));
+                               });
+    } catch (const std::exception& e) {
+        ok = false;
+        error = e.what();
+    }
+
+    Header hdr{};
+    std::memcpy(hdr.magic, kMagic, 8);
+    hdr.version = kVersion;
+    hdr.ok = ok ? 1 : 0;
+    hdr.page_count = ok ? pages.size() : 0;
+    const std::uint64_t pairs = ok ? pages.size() : 1;
+
+    std::string bytes;
+    bytes.append(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+    std::uint64_t at = sizeof(Header) + (pairs + 1) * 8;
+    std::vector<std::uint64_t> offsets;
+    offsets.push_back(at);
+    if (ok) {
+        for (const auto& [page, text] : pages) {
+            at += text.size();
+            offsets.push_back(at);
+        }
+    } else {
+        at += error.size();
+        offsets.push_back(at);
+    }
+    bytes.append(reinterpret_cast<const char*>(offsets.data()),
+                 offsets.size() * 8);
+    if (ok)
+        for (const auto& [page, text] : pages)
+            bytes += text;
+    else
+        bytes += error;
+
+    write_atomically(entry_path(digest), bytes);
+    auto entry = lookup(digest);
+    if (!entry)
+        throw std::runtime_error("extract-cache: entry vanished after write");
+    return *entry;
+}
+
+} // namespace intake
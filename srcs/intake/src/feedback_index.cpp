@@ -0,0 +1,282 @@
+#include "intake/feedback_index.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace intake {
+
+namespace {
+
+char fold(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+std::string fold_copy(std::string_view s) {
+    std::string out(s);
+    for (char& c : out)
+        c = fold(c);
+    return out;
+}
+
+std::uint32_t trigram_key(const char* p) {
+    return static_cast<std::uint32_t>(static_cast<unsigned char>(p[0])) |
+           (static_cast<std::uint32_t>(static_cast<unsigned char>(p[1]))
+            << 8) |
+           (static_cast<std::uint32_t>(static_cast<unsigned char>(p[2]))
+            << 16);
+}
+
+// Distinct trigram keys of a folded string, sorted.
+void string_trigrams(std::string_view folded, std::vector<std::uint32_t>& out) {
+    out.clear();
+    if (folded.size() < 3)
+        return;
+    for (std::size_t i = 0; i + 3 <= folded.size(); ++i)
+        out.push_back(trigram_key(folded.data() + i));
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+bool icontains(std::string_view haystack, std::string_view folded_needle) {
+    if (folded_needle.empty())
+        return true;
+    if (haystack.size() < folded_needle.size())
+        return false;
+    for (std::size_t i = 0; i + folded_needle.size() <= haystack.size(); ++i) {
+        std::size_t j = 0;
+        while (j < folded_needle.size() &&
+               fold(haystack[i + j]) == folded_needle[j])
+            ++j;
+        if (j == folded_needle.size())
+            return true;
+    }
+    return false;
+}
+
+std::size_t pad8(std::size_t n) { return (n + 7) & ~std::size_t{7}; }
+
+// Serialized blob header: string table generation guard, then one count per
+// table in declaration order.
+struct BlobHeader {
+    std::uint64_t string_count;
+    std::uint64_t ids;
+    std::uint64_t grams;
+    std::uint64_t posting_ids;
+    std::uint64_t occ_ranges;
+    std::uint64_t occurrences;
+};
+static_assert(sizeof(BlobHeader) == 48);
+
+} // namespace
+
+FeedbackIndex::FeedbackIndex(const ColumnarCache& cache,
+                             std::string_view sheet_name)
+    : cache_(cache) {
+    const ColumnarCache::Sheet* sheet = cache.sheet(sheet_name);
+    if (!sheet)
+        throw std::runtime_error("feedback index: no sheet named '" +
+                                 std::string(sheet_name) + "' in cache");
+
+    // Pass 1: occurrences per string id. Rows are the data rows (the header
+    // row carries column names, not feedback).
+    const std::uint64_t rows = sheet->rows;
+    std::unordered_map<std::uint32_t, std::uint32_t> occ_counts;
+    for (std::uint32_t col = 0; col < sheet->columns.size(); ++col) {
+        const ColumnarCache::Column& c = sheet->columns[col];
+        if (c.type != ColumnarCache::ColumnType::String)
+            continue;
+        for (std::uint64_t row = 0; row < rows; ++row) {
+            const std::uint32_t id = c.strings[row];
+            if (id != ColumnarCache::kNoString)
+                ++occ_counts[id];
+        }
+    }
+
+    for (const auto& [id, count] : occ_counts)
+        own_ids_.push_back(id);
+    std::sort(own_ids_.begin(), own_ids_.end());
+
+    std::uint32_t total = 0;
+    own_occ_ranges_.reserve(own_ids_.size());
+    for (std::uint32_t id : own_ids_) {
+        own_occ_ranges_.push_back({id, total, 0}); // length doubles as cursor
+        total += occ_counts[id];
+    }
+    own_occurrences_.resize(total);
+    auto occ_of = [this](std::uint32_t id) -> OccRange& {
+        const auto it = std::lower_bound(
+            own_occ_ranges_.begin(), own_occ_ranges_.end(), id,
+            [](const OccRange& r, std::uint32_t v) { return r.id < v; });
+        return *it;
+    };
+    for (std::uint32_t col = 0; col < sheet->columns.size(); ++col) {
+        const ColumnarCache::Column& c = sheet->columns[col];
+        if (c.type != ColumnarCache::ColumnType::String)
+            continue;
+        for (std::uint64_t row = 0; row < rows; ++row) {
+            const std::uint32_t id = c.strings[row];
+            if (id == ColumnarCache::kNoString)
+                continue;
+            OccRange& r = occ_of(id);
+            own_occurrences_[r.offset + r.length++] = {
+                static_cast<std::uint32_t>(row), col};
+        }
+    }
+
+    // Pass 2: trigram postings over the distinct strings. Counting pass
+    // sizes the tables, fill pass keeps each posting list sorted because ids
+    // are visited in ascending order.
+    std::vector<std::uint32_t> grams;
+    std::unordered_map<std::uint32_t, std::uint32_t> gram_counts;
+    for (std::uint32_t id : own_ids_) {
+        string_trigrams(fold_copy(cache_.string_at(id)), grams);
+        for (std::uint32_t g : grams)
+            ++gram_counts[g];
+    }
+    own_grams_.reserve(gram_counts.size());
+    for (const auto& [gram, count] : gram_counts)
+        own_grams_.push_back({gram, 0, 0});
+    std::sort(own_grams_.begin(), own_grams_.end(),
+              [](const GramRange& a, const GramRange& b) {
+                  return a.gram < b.gram;
+              });
+    std::uint32_t posting_total = 0;
+    for (GramRange& g : own_grams_) {
+        g.offset = posting_total;
+        posting_total += gram_counts[g.gram];
+    }
+    own_posting_ids_.resize(posting_total);
+    for (std::uint32_t id : own_ids_) {
+        string_trigrams(fold_copy(cache_.string_at(id)), grams);
+        for (std::uint32_t g : grams) {
+            const auto it = std::lower_bound(
+                own_grams_.begin(), own_grams_.end(), g,
+                [](const GramRange& r, std::uint32_t v) { return r.gram < v; });
+            own_posting_ids_[it->offset + it->length++] = id;
+        }
+    }
+
+    indexed_ids_ = own_ids_;
+    grams_ = own_grams_;
+    posting_ids_ = own_posting_ids_;
+    occ_ranges_ = own_occ_ranges_;
+    occurrences_ = own_occurrences_;
+}
+
+FeedbackIndex::FeedbackIndex(const ColumnarCache& cache, const void* blob,
+                             std::size_t len)
+    : cache_(cache) {
+    const char* base = static_cast<const char*>(blob);
+    BlobHeader h;
+    if (len < sizeof(h))
+        throw std::runtime_error("feedback index: snapshot blob too short");
+    std::memcpy(&h, base, sizeof(h));
+    if (h.string_count != cache.string_count())
+        throw std::runtime_error(
+            "feedback index: snapshot built against a different string table");
+
+    std::size_t at = sizeof(h);
+    auto table = [&](std::uint64_t count, std::size_t elem,
+                     auto& span) {
+        const std::size_t bytes = static_cast<std::size_t>(count) * elem;
+        if (at + bytes > len)
+            throw std::runtime_error("feedback index: truncated snapshot blob");
+        using Elem = typename std::remove_reference_t<decltype(span)>::element_type;
+        span = {reinterpret_cast<const Elem*>(base + at),
+                static_cast<std::size_t>(count)};
+        at = pad8(at + bytes);
+    };
+    table(h.ids, sizeof(std::uint32_t), indexed_ids_);
+    table(h.grams, sizeof(GramRange), grams_);
+    table(h.posting_ids, sizeof(std::uint32_t), posting_ids_);
+    table(h.occ_ranges, sizeof(OccRange), occ_ranges_);
+    table(h.occurrences, sizeof(Occurrence), occurrences_);
+}
+
+void FeedbackIndex::serialize(std::string& out) const {
+    const BlobHeader h = {cache_.string_count(),       indexed_ids_.size(),
+                          grams_.size(),               posting_ids_.size(),
+                          occ_ranges_.size(),          occurrences_.size()};
+    out.append(reinterpret_cast<const char*>(&h), sizeof(h));
+    auto table = [&](const auto& span) {
+        out.append(reinterpret_cast<const char*>(span.data()),
+                   span.size_bytes());
+        out.resize(pad8(out.size()), '\0');
+    };
+    table(indexed_ids_);
+    table(grams_);
+    table(posting_ids_);
+    table(occ_ranges_);
+    table(occurrences_);
+}
+
+void FeedbackIndex::collect_candidates(std::string_view folded,
+                                       std::vector<std::uint32_t>& out) const {
+    // Intersect posting lists, shortest first; a query trigram absent from
+    // the corpus means no match at all.
+    std::vector<const GramRange*> ranges;
+    for (std::size_t i = 0; i + 3 <= folded.size(); ++i) {
+        const std::uint32_t key = trigram_key(folded.data() + i);
+        const auto it = std::lower_bound(
+            grams_.begin(), grams_.end(), key,
+            [](const GramRange& r, std::uint32_t v) { return r.gram < v; });
+        if (it == grams_.end() || it->gram != key) {
+            out.clear();
+            return;
+        }
+        ranges.push_back(&*it);
+    }
+    std::sort(ranges.begin(), ranges.end(),
+              [](const GramRange* a, const GramRange* b) {
+                  return a->length < b->length;
+              });
+    out.assign(posting_ids_.begin() + ranges[0]->offset,
+               posting_ids_.begin() + ranges[0]->offset + ranges[0]->length);
+    std::vector<std::uint32_t> next;
+    for (std::size_t i = 1; i < ranges.size() && !out.empty(); ++i) {
+        const std::uint32_t* begin = posting_ids_.data() + ranges[i]->offset;
+        const std::uint32_t* end = begin + ranges[i]->length;
+        next.clear();
+        std::set_intersection(out.begin(), out.end(), begin, end,
+                              std::back_inserter(next));
+        out.swap(next);
+    }
+}
+
+void FeedbackIndex::append_matches(std::uint32_t id,
+                                   std::vector<Match>& out) const {
+    const auto it = std::lower_bound(
+        occ_ranges_.begin(), occ_ranges_.end(), id,
+        [](const OccRange& r, std::uint32_t v) { return r.id < v; });
+    if (it == occ_ranges_.end() || it->id != id)
+        return;
+    const std::string_view text = cache_.string_at(id);
+    for (std::uint32_t i = 0; i < it->length; ++i) {
+        const Occurrence& o = occurrences_[it->offset + i];
+        out.push_back({o.row, o.col, text});
+    }
+}
+
+std::vector<FeedbackIndex::Match>
+FeedbackIndex::search(std::string_view query) const {
+    const std::string folded = fold_copy(query);
+    std::vector<std::uint32_t> candidates;
+    if (folded.size() >= 3)
+        collect_candidates(folded, candidates);
+    else
+        candidates.assign(indexed_ids_.begin(),
+                          indexed_ids_.end()); // short query: scan strings
+
+    std::vector<Match> out;
+    for (std::uint32_t id : candidates)
+        if (icontains(cache_.string_at(id), folded))
+            append_matches(id, out);
+    std::sort(out.begin(), out.end(), [](const Match& a, const Match& b) {
+        return a.row != b.row ? a.row < b.row : a.col < b.col;
+    });
+    return out;
+}
+
+} // namespace intake
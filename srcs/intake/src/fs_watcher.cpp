@@ -0,0 +1,221 @@
+#include "intake/fs_watcher.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include "intake/trace.hpp"
+
+namespace intake {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+[[noreturn]] void throw_errno(const char* what) {
+    throw std::runtime_error(std::string("watcher: ") + what + ": " +
+                             std::strerror(errno));
+}
+
+// Everything that changes directory contents. IN_CLOSE_WRITE rather than
+// IN_MODIFY for plain writes — editors fire IN_MODIFY per chunk, and the
+// close is the natural "file is now whole" signal.
+constexpr std::uint32_t kWatchMask =
+    IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_DELETE_SELF | IN_MOVED_FROM |
+    IN_MOVED_TO | IN_ONLYDIR;
+
+} // namespace
+
+FsWatcher::FsWatcher(Options options, BatchFn on_batch)
+    : options_(std::move(options)), on_batch_(std::move(on_batch)) {
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd_ < 0)
+        throw_errno("inotify_init1");
+    wake_fd_ = eventfd(0, EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        ::close(inotify_fd_);
+        throw_errno("eventfd");
+    }
+    try {
+        for (const std::string& root : options_.roots)
+            watch_tree(root);
+    } catch (...) {
+        ::close(inotify_fd_);
+        ::close(wake_fd_);
+        throw;
+    }
+    thread_ = std::thread([this] { event_loop(); });
+}
+
+FsWatcher::~FsWatcher() {
+    stop();
+    ::close(inotify_fd_);
+    ::close(wake_fd_);
+}
+
+void FsWatcher::stop() {
+    {
+        std::lock_guard lock(stats_mu_);
+        if (stopped_)
+            return;
+        stopped_ = true;
+    }
+    std::uint64_t one = 1;
+    [[maybe_unused]] ssize_t r = ::write(wake_fd_, &one, sizeof(one));
+    if (thread_.joinable())
+        thread_.join();
+}
+
+FsWatcher::Stats FsWatcher::stats() const {
+    std::lock_guard lock(stats_mu_);
+    return stats_;
+}
+
+int FsWatcher::add_watch(const std::string& dir) {
+    int wd = inotify_add_watch(inotify_fd_, dir.c_str(), kWatchMask);
+    if (wd < 0) {
+        if (errno == ENOENT || errno == ENOTDIR)
+            return -1; // raced with a delete; the parent's event covers it
+        throw_errno("inotify_add_watch");
+    }
+    dir_by_wd_[wd] = dir;
+    wd_by_dir_[dir] = wd;
+    return wd;
+}
+
+void FsWatcher::watch_tree(const std::string& dir) {
+    if (add_watch(dir) < 0)
+        return;
+    std::error_code ec;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end;
+         it.increment(ec)) {
+        if (it->is_directory(ec) && !ec)
+            watch_tree(it->path().string());
+    }
+}
+
+void FsWatcher::mark_dirty(std::string dir,
+                           std::chrono::steady_clock::time_point now) {
+    auto [it, fresh] = pending_.try_emplace(std::move(dir), Pending{now, now});
+    if (!fresh)
+        it->second.last = now;
+}
+
+void FsWatcher::consume_events() {
+    INTAKE_TRACE_SCOPE("watch.drain");
+    const auto now = std::chrono::steady_clock::now();
+    // Large enough for a burst; the kernel never splits an event across
+    // reads as long as the buffer holds one maximal entry.
+    alignas(inotify_event) char buf[16 << 10];
+    while (true) {
+        const ssize_t n = ::read(inotify_fd_, buf, sizeof(buf));
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return;
+            if (errno == EINTR)
+                continue;
+            throw_errno("read");
+        }
+        std::uint64_t seen = 0;
+        for (ssize_t off = 0; off < n;) {
+            const auto* ev = reinterpret_cast<const inotify_event*>(buf + off);
+            off += static_cast<ssize_t>(sizeof(inotify_event) + ev->len);
+            ++seen;
+
+            if (ev->mask & IN_Q_OVERFLOW) {
+                // Events were dropped; the only safe answer is every root.
+                for (const std::string& root : options_.roots)
+                    mark_dirty(root, now);
+                std::lock_guard lock(stats_mu_);
+                ++stats_.overflows;
+                continue;
+            }
+            const auto dir_it = dir_by_wd_.find(ev->wd);
+            if (ev->mask & (IN_DELETE_SELF | IN_IGNORED)) {
+                if (dir_it != dir_by_wd_.end()) {
+                    wd_by_dir_.erase(dir_it->second);
+                    dir_by_wd_.erase(dir_it);
+                }
+                continue;
+            }
+            if (dir_it == dir_by_wd_.end())
+                continue;
+
+            // New subdirectory (mkdir or a moved-in tree): watch it before
+            // its own contents start changing.
+            if ((ev->mask & IN_ISDIR) &&
+                (ev->mask & (IN_CREATE | IN_MOVED_TO)))
+                watch_tree(dir_it->second + "/" + ev->name);
+
+            mark_dirty(dir_it->second, now);
+        }
+        std::lock_guard lock(stats_mu_);
+        stats_.events += seen;
+    }
+}
+
+void FsWatcher::flush_due(std::chrono::steady_clock::time_point now,
+                          bool force) {
+    std::vector<std::string> due;
+    for (auto it = pending_.begin(); it != pending_.end();) {
+        const Pending& p = it->second;
+        if (force || now - p.last >= options_.debounce ||
+            now - p.first >= options_.max_delay) {
+            due.push_back(it->first);
+            it = pending_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (due.empty())
+        return;
+    INTAKE_TRACE_COUNT("watch.flushed_dirs", due.size());
+    {
+        std::lock_guard lock(stats_mu_);
+        ++stats_.batches;
+        stats_.directories += due.size();
+    }
+    on_batch_(due);
+}
+
+void FsWatcher::event_loop() {
+    pollfd fds[2] = {{inotify_fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+    while (true) {
+        // Sleep until the earliest pending deadline (debounce expiry or
+        // max_delay cap), or indefinitely when nothing is pending.
+        int timeout_ms = -1;
+        const auto now = std::chrono::steady_clock::now();
+        for (const auto& [dir, p] : pending_) {
+            const auto deadline =
+                std::min(p.last + options_.debounce, p.first + options_.max_delay);
+            const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - now);
+            const int ms = static_cast<int>(std::max<std::int64_t>(wait.count(), 0));
+            if (timeout_ms < 0 || ms < timeout_ms)
+                timeout_ms = ms;
+        }
+
+        const int rc = ::poll(fds, 2, timeout_ms);
+        if (rc < 0) {
+            if (errno == EINTR)
+                continue;
+            throw_errno("poll");
+        }
+        if (fds[1].revents & POLLIN) {
+            consume_events(); // pick up anything raced with stop()
+            flush_due(std::chrono::steady_clock::now(), /*force=*/true);
+            return;
+        }
+        if (fds[0].revents & POLLIN)
+            consume_events();
+        flush_due(std::chrono::steady_clock::now(), /*force=*/false);
+    }
+}
+
+} // namespace intake
@@ -0,0 +1,588 @@
+#include "intake/git_fetch.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <netdb.h>
+#include <openssl/evp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <zlib.h>
+
+namespace intake {
+
+namespace {
+
+[[noreturn]] void fail(const std::string& what) {
+    throw std::runtime_error("git-fetch: " + what);
+}
+
+// ---------------------------------------------------------------------------
+// Transport: blocking TCP with per-operation timeouts, pkt-line framing.
+
+class PktConn {
+public:
+    PktConn(const std::string& host, std::uint16_t port, int timeout_ms) {
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* res = nullptr;
+        const std::string port_str = std::to_string(port);
+        if (getaddrinfo(host.c_str(), port_str.c_str(), &hints, &res) != 0)
+            fail("cannot resolve " + host);
+        for (addrinfo* ai = res; ai; ai = ai->ai_next) {
+            fd_ = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd_ < 0)
+                continue;
+            if (::connect(fd_, ai->ai_addr, ai->ai_addrlen) == 0)
+                break;
+            ::close(fd_);
+            fd_ = -1;
+        }
+        freeaddrinfo(res);
+        if (fd_ < 0)
+            fail("cannot connect to " + host + ":" + port_str);
+        timeval tv{timeout_ms / 1000, (timeout_ms % 1000) * 1000};
+        setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        setsockopt(fd_, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    }
+
+    ~PktConn() {
+        if (fd_ >= 0)
+            ::close(fd_);
+    }
+
+    PktConn(const PktConn&) = delete;
+    PktConn& operator=(const PktConn&) = delete;
+
+    void send_pkt(std::string_view payload) {
+        char hdr[5];
+        std::snprintf(hdr, sizeof(hdr), "%04zx", payload.size() + 4);
+        write_all(hdr, 4);
+        write_all(payload.data(), payload.size());
+    }
+
+    void send_flush() { write_all("0000", 4); }
+    void send_delim() { write_all("0001", 4); }
+
+    enum class PktType { Data, Flush, Delim, ResponseEnd };
+
+    // Reads one pkt-line; on Data, `payload` holds the body.
+    PktType read_pkt(std::string& payload) {
+        char hdr[4];
+        read_all(hdr, 4);
+        unsigned len = 0;
+        for (char c : hdr) {
+            len <<= 4;
+            if (c >= '0' && c <= '9')
+                len |= static_cast<unsigned>(c - '0');
+            else if (c >= 'a' && c <= 'f')
+                len |= static_cast<unsigned>(c - 'a' + 10);
+            else
+                fail("bad pkt-line length");
+        }
+        if (len == 0)
+            return PktType::Flush;
+        if (len == 1)
+            return PktType::Delim;
+        if (len == 2)
+            return PktType::ResponseEnd;
+        if (len < 4 || len > 65520)
+            fail("bad pkt-line length");
+        payload.resize(len - 4);
+        read_all(payload.data(), payload.size());
+        return PktType::Data;
+    }
+
+private:
+    void write_all(const char* p, std::size_t n) {
+        while (n != 0) {
+            const ssize_t w = ::write(fd_, p, n);
+            if (w <= 0)
+                fail("write failed");
+            p += w;
+            n -= static_cast<std::size_t>(w);
+        }
+    }
+
+    void read_all(char* p, std::size_t n) {
+        while (n != 0) {
+            const ssize_t r = ::read(fd_, p, n);
+            if (r <= 0)
+                fail("connection closed mid-response");
+            p += r;
+            n -= static_cast<std::size_t>(r);
+        }
+    }
+
+    int fd_ = -1;
+};
+
+// ---------------------------------------------------------------------------
+// Object ids and packfile parsing.
+
+using Oid = std::string; // 20 raw bytes
+
+std::string oid_hex(const Oid& id) {
+    static const char* digits = "0123456789abcdef";
+    std::string out;
+    out.reserve(40);
+    for (unsigned char c : id) {
+        out.push_back(digits[c >> 4]);
+        out.push_back(digits[c & 15]);
+    }
+    return out;
+}
+
+enum class ObjType : std::uint8_t { Commit = 1, Tree = 2, Blob = 3, Tag = 4 };
+
+struct PackObject {
+    ObjType type;
+    std::string data;
+};
+
+Oid object_id(ObjType type, std::string_view data) {
+    static const char* names[] = {"", "commit", "tree", "blob", "tag"};
+    char header[32];
+    const int hlen =
+        std::snprintf(header, sizeof(header), "%s %zu",
+                      names[static_cast<int>(type)], data.size()) +
+        1; // include the NUL
+    unsigned char md[20];
+    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+    EVP_DigestInit_ex(ctx, EVP_sha1(), nullptr);
+    EVP_DigestUpdate(ctx, header, static_cast<std::size_t>(hlen));
+    EVP_DigestUpdate(ctx, data.data(), data.size());
+    unsigned mdlen = 0;
+    EVP_DigestFinal_ex(ctx, md, &mdlen);
+    EVP_MD_CTX_free(ctx);
+    return Oid(reinterpret_cast<char*>(md), 20);
+}
+
+// Inflates exactly `expected` bytes starting at pack[pos]; advances pos past
+// the consumed compressed stream.
+std::string inflate_entry(const std::string& pack, std::size_t& pos,
+                          std::size_t expected) {
+    std::string out(expected, '\0');
+    z_stream zs{};
+    if (inflateInit(&zs) != Z_OK)
+        fail("inflateInit failed");
+    zs.next_in =
+        reinterpret_cast<Bytef*>(const_cast<char*>(pack.data() + pos));
+    zs.avail_in = static_cast<uInt>(pack.size() - pos);
+    zs.next_out = reinterpret_cast<Bytef*>(out.data());
+    zs.avail_out = static_cast<uInt>(out.size());
+    const int rc = inflate(&zs, Z_FINISH);
+    const std::size_t consumed = zs.total_in;
+    inflateEnd(&zs);
+    if (rc != Z_STREAM_END)
+        fail("corrupt deflate stream in packfile");
+    pos += consumed;
+    return out;
+}
+
+// Git delta format: base-size varint, result-size varint, then copy/insert
+// instructions.
+std::string apply_delta(const std::string& base, const std::string& delta) {
+    std::size_t i = 0;
+    auto varint = [&] {
+        std::size_t v = 0;
+        int shift = 0;
+        while (true) {
+            if (i >= delta.size())
+                fail("truncated delta");
+            const unsigned char c = static_cast<unsigned char>(delta[i++]);
+            v |= static_cast<std::size_t>(c & 0x7f) << shift;
+            shift += 7;
+            if (!(c & 0x80))
+                return v;
+        }
+    };
+    const std::size_t base_size = varint();
+    const std::size_t result_size = varint();
+    if (base_size != base.size())
+        fail("delta base size mismatch");
+    std::string out;
+    out.reserve(result_size);
+    while (i < delta.size()) {
+        const unsigned char op = static_cast<unsigned char>(delta[i++]);
+        if (op & 0x80) { // copy from base
+            std::size_t off = 0, len = 0;
+            for (int b = 0; b < 4; ++b)
+                if (op & (1u << b))
+                    off |= static_cast<std::size_t>(
+                               static_cast<unsigned char>(delta[i++]))
+                           << (8 * b);
+            for (int b = 0; b < 3; ++b)
+                if (op & (0x10u << b))
+                    len |= static_cast<std::size_t>(
+                               static_cast<unsigned char>(delta[i++]))
+                           << (8 * b);
+            if (len == 0)
+                len = 0x10000;
+            if (off + len > base.size())
+                fail("delta copy out of range");
+            out.append(base, off, len);
+        } else if (op != 0) { // insert literal
+            out.append(delta, i, op);
+            i += op;
+        } else {
+            fail("invalid delta opcode 0");
+        }
+    }
+    if (out.size() != result_size)
+        fail("delta result size mismatch");
+    return out;
+}
+
+class ObjectStore {
+public:
+    void add_pack(const std::string& pack) {
+        if (pack.size() < 12 + 20 || pack.compare(0, 4, "PACK") != 0)
+            fail("missing PACK header");
+        const auto be32 = [&](std::size_t at) {
+            return (static_cast<std::uint32_t>(
+                        static_cast<unsigned char>(pack[at]))
+                    << 24) |
+                   (static_cast<std::uint32_t>(
+                        static_cast<unsigned char>(pack[at + 1]))
+                    << 16) |
+                   (static_cast<std::uint32_t>(
+                        static_cast<unsigned char>(pack[at + 2]))
+                    << 8) |
+                   static_cast<std::uint32_t>(
+                       static_cast<unsigned char>(pack[at + 3]));
+        };
+        if (be32(4) != 2)
+            fail("unsupported pack version");
+        const std::uint32_t count = be32(8);
+        std::size_t pos = 12;
+        std::unordered_map<std::size_t, Oid> by_offset;
+        for (std::uint32_t n = 0; n < count; ++n) {
+            const std::size_t obj_offset = pos;
+            unsigned char c = static_cast<unsigned char>(pack[pos++]);
+            const unsigned raw_type = (c >> 4) & 7;
+            std::size_t size = c & 15;
+            int shift = 4;
+            while (c & 0x80) {
+                c = static_cast<unsigned char>(pack[pos++]);
+                size |= static_cast<std::size_t>(c & 0x7f) << shift;
+                shift += 7;
+            }
+            ObjType type;
+            std::string data;
+            if (raw_type == 6) { // OFS_DELTA
+                c = static_cast<unsigned char>(pack[pos++]);
+                std::size_t off = c & 0x7f;
+                while (c & 0x80) {
+                    c = static_cast<unsigned char>(pack[pos++]);
+                    off = ((off + 1) << 7) | (c & 0x7f);
+                }
+                const auto base_it = by_offset.find(obj_offset - off);
+                if (base_it == by_offset.end())
+                    fail("ofs-delta base not seen yet");
+                const PackObject& base = objects_.at(base_it->second);
+                data = apply_delta(base.data, inflate_entry(pack, pos, size));
+                type = base.type;
+            } else if (raw_type == 7) { // REF_DELTA
+                const Oid base_id = pack.substr(pos, 20);
+                pos += 20;
+                const auto base_it = objects_.find(base_id);
+                if (base_it == objects_.end())
+                    fail("ref-delta base " + oid_hex(base_id) +
+                         " not in pack");
+                data = apply_delta(base_it->second.data,
+                                   inflate_entry(pack, pos, size));
+                type = base_it->second.type;
+            } else if (raw_type >= 1 && raw_type <= 4) {
+                type = static_cast<ObjType>(raw_type);
+                data = inflate_entry(pack, pos, size);
+            } else {
+                fail("unknown pack object type");
+            }
+            const Oid id = object_id(type, data);
+            by_offset.emplace(obj_offset, id);
+            objects_[id] = PackObject{type, std::move(data)};
+        }
+    }
+
+    const PackObject& get(const Oid& id) const {
+        const auto it = objects_.find(id);
+        if (it == objects_.end())
+            fail("object " + oid_hex(id) + " not fetched");
+        return it->second;
+    }
+
+    bool contains(const Oid& id) const { return objects_.count(id) != 0; }
+
+private:
+    std::unordered_map<Oid, PackObject> objects_;
+};
+
+// ---------------------------------------------------------------------------
+// Protocol v2 session over git://.
+
+class Session {
+public:
+    Session(const std::string& host, const std::string& repo,
+            const GitFetchEngine::Options& options)
+        : conn_(host, options.port, options.timeout_ms) {
+        // git:// request header, then the server's capability advertisement.
+        std::string req = "git-upload-pack " + repo;
+        req.push_back('\0');
+        req += "host=" + host;
+        req.push_back('\0');
+        req.push_back('\0');
+        req += "version=2";
+        req.push_back('\0');
+        conn_.send_pkt(req);
+        std::string line;
+        bool saw_v2 = false;
+        while (conn_.read_pkt(line) == PktConn::PktType::Data) {
+            if (line.rfind("version 2", 0) == 0)
+                saw_v2 = true;
+            if (line.rfind("fetch", 0) == 0 &&
+                line.find("filter") != std::string::npos)
+                have_filter_ = true;
+        }
+        if (!saw_v2)
+            fail("server did not speak protocol v2");
+    }
+
+    // Resolves refs/heads/<branch> to its tip oid (raw 20 bytes).
+    Oid resolve_branch(const std::string& branch) {
+        conn_.send_pkt("command=ls-refs\n");
+        conn_.send_delim();
+        conn_.send_pkt("ref-prefix refs/heads/" + branch + "\n");
+        conn_.send_flush();
+        std::string line;
+        Oid found;
+        while (conn_.read_pkt(line) == PktConn::PktType::Data) {
+            if (line.size() < 41)
+                continue;
+            const std::string ref = line.substr(
+                41, line.find_first_of("\n ", 41) - 41);
+            if (ref == "refs/heads/" + branch)
+                found = hex_to_oid(line.substr(0, 40));
+        }
+        if (found.empty())
+            fail("branch '" + branch + "' not found on remote");
+        return found;
+    }
+
+    // One fetch round; `filter_blobs` requests a blob-less pack (trees and
+    // commits only). Returns the raw packfile bytes.
+    std::string fetch(const std::vector<Oid>& wants, bool filter_blobs) {
+        if (filter_blobs && !have_filter_)
+            fail("server does not support partial clone filters");
+        conn_.send_pkt("command=fetch\n");
+        conn_.send_delim();
+        conn_.send_pkt("no-progress\n");
+        if (filter_blobs)
+            conn_.send_pkt("filter blob:none\n");
+        for (const Oid& w : wants)
+            conn_.send_pkt("want " + oid_hex(w) + "\n");
+        conn_.send_pkt("done\n");
+        conn_.send_flush();
+
+        std::string pack;
+        std::string line;
+        bool in_packfile = false;
+        while (true) {
+            const PktConn::PktType t = conn_.read_pkt(line);
+            if (t == PktConn::PktType::Flush)
+                break;
+            if (t != PktConn::PktType::Data)
+                continue; // delim between sections
+            if (!in_packfile) {
+                if (line == "packfile\n")
+                    in_packfile = true;
+                continue; // acknowledgments / shallow-info lines
+            }
+            // Sideband: band 1 carries pack data, band 3 a fatal message.
+            if (line.empty())
+                continue;
+            const unsigned char band = static_cast<unsigned char>(line[0]);
+            if (band == 1)
+                pack.append(line, 1, line.size() - 1);
+            else if (band == 3)
+                fail("remote error: " + line.substr(1));
+        }
+        if (!in_packfile)
+            fail("response carried no packfile");
+        return pack;
+    }
+
+private:
+    static Oid hex_to_oid(std::string_view hex) {
+        Oid out(20, '\0');
+        for (std::size_t i = 0; i < 20; ++i) {
+            auto nibble = [&](char c) -> unsigned {
+                if (c >= '0' && c <= '9')
+                    return static_cast<unsigned>(c - '0');
+                if (c >= 'a' && c <= 'f')
+                    return static_cast<unsigned>(c - 'a' + 10);
+                fail("bad object id in ref advertisement");
+            };
+            out[i] = static_cast<char>((nibble(hex[2 * i]) << 4) |
+                                       nibble(hex[2 * i + 1]));
+        }
+        return out;
+    }
+
+    PktConn conn_;
+    bool have_filter_ = false;
+};
+
+// ---------------------------------------------------------------------------
+// Tree walking over in-memory objects.
+
+struct TreeEntry {
+    std::string name;
+    Oid id;
+    bool is_tree;
+};
+
+std::vector<TreeEntry> parse_tree(const std::string& data) {
+    std::vector<TreeEntry> out;
+    std::size_t i = 0;
+    while (i < data.size()) {
+        const std::size_t sp = data.find(' ', i);
+        const std::size_t nul = data.find('\0', sp);
+        if (sp == std::string::npos || nul == std::string::npos ||
+            nul + 20 > data.size())
+            fail("corrupt tree object");
+        TreeEntry e;
+        e.is_tree = data.compare(i, sp - i, "40000") == 0;
+        e.name = data.substr(sp + 1, nul - sp - 1);
+        e.id = data.substr(nul + 1, 20);
+        out.push_back(std::move(e));
+        i = nul + 21;
+    }
+    return out;
+}
+
+bool ends_with_pdf(std::string_view name) {
+    return name.size() >= 4 &&
+           name.compare(name.size() - 4, 4, ".pdf") == 0;
+}
+
+void walk_tree(const ObjectStore& store, const Oid& tree_id,
+               const std::string& prefix, RemoteForkSnapshot& snap,
+               std::vector<std::pair<Oid, std::size_t>>& blob_wants) {
+    for (const TreeEntry& e : parse_tree(store.get(tree_id).data)) {
+        const std::string path = prefix + e.name;
+        if (e.is_tree) {
+            if (path == ".git")
+                continue;
+            walk_tree(store, e.id, path + "/", snap, blob_wants);
+            continue;
+        }
+        snap.files.push_back({path, {}, false});
+        // Only PDF bodies get fetched: validation reads their magic, and
+        // the extractor wants the canvas. Everything else is presence-only.
+        const bool at_root = prefix.empty();
+        const bool in_pitch = prefix.rfind("pitch/", 0) == 0;
+        if (ends_with_pdf(e.name) && (at_root || in_pitch))
+            blob_wants.emplace_back(e.id, snap.files.size() - 1);
+    }
+}
+
+} // namespace
+
+GitFetchEngine::GitFetchEngine(Options options) : options_(options) {}
+
+RemoteForkSnapshot GitFetchEngine::fetch_fork(const std::string& host,
+                                              const std::string& repo,
+                                              const std::string& branch) {
+    Session session(host, repo, options_);
+    const Oid tip = session.resolve_branch(branch);
+
+    // Round 1: commit + trees only (blob:none). This is the >90% cut — a
+    // fork's history and file bodies never cross the wire.
+    ObjectStore store;
+    store.add_pack(session.fetch({tip}, /*filter_blobs=*/true));
+
+    const PackObject& commit = store.get(tip);
+    if (commit.type != ObjType::Commit)
+        fail("branch tip is not a commit");
+    if (commit.data.compare(0, 5, "tree ") != 0 || commit.data.size() < 45)
+        fail("corrupt commit object");
+    Oid root_tree(20, '\0');
+    for (std::size_t i = 0; i < 20; ++i) {
+        const auto hexval = [&](char c) {
+            return c <= '9' ? c - '0' : c - 'a' + 10;
+        };
+        root_tree[i] = static_cast<char>(
+            (hexval(commit.data[5 + 2 * i]) << 4) |
+            hexval(commit.data[5 + 2 * i + 1]));
+    }
+
+    RemoteForkSnapshot snap;
+    snap.branch = branch;
+    snap.commit_hex = oid_hex(tip);
+    std::vector<std::pair<Oid, std::size_t>> blob_wants;
+    walk_tree(store, root_tree, "", snap, blob_wants);
+
+    // Round 2: just the blobs validation reads, on the same connection.
+    if (!blob_wants.empty()) {
+        std::vector<Oid> wants;
+        for (const auto& [id, idx] : blob_wants)
+            if (!store.contains(id))
+                wants.push_back(id);
+        if (!wants.empty())
+            store.add_pack(session.fetch(wants, /*filter_blobs=*/false));
+        for (const auto& [id, idx] : blob_wants) {
+            snap.files[idx].data = store.get(id).data;
+            snap.files[idx].has_data = true;
+        }
+    }
+    return snap;
+}
+
+ValidationReport GitFetchEngine::validate_snapshot(
+    const RemoteForkSnapshot& snap) {
+    ValidationReport report;
+    report.branch = snap.branch;
+    report.files_scanned = snap.files.size();
+
+    if (!SubmissionValidator::branch_name_ok(snap.branch))
+        report.issues.push_back({ValidationIssue::Code::BadBranchName, "",
+                                 "branch '" + snap.branch +
+                                     "' does not follow the naming rules"});
+
+    bool srcs_content = false, canvas = false, pitch_pdf = false;
+    for (const RemoteFile& f : snap.files) {
+        if (f.path.rfind("srcs/", 0) == 0 && f.path != "srcs/tmp_whatever")
+            srcs_content = true;
+        const bool at_root = f.path.find('/') == std::string::npos;
+        const bool in_pitch = f.path.rfind("pitch/", 0) == 0;
+        if (ends_with_pdf(f.path) && f.has_data) {
+            if (!SubmissionValidator::looks_like_pdf(f.data)) {
+                report.issues.push_back(
+                    {ValidationIssue::Code::NotAPdf, f.path,
+                     f.path + " does not start with the PDF magic"});
+                continue;
+            }
+            if (at_root)
+                canvas = true;
+            if (in_pitch)
+                pitch_pdf = true;
+        }
+    }
+    if (!srcs_content)
+        report.issues.push_back(
+            {ValidationIssue::Code::MissingSrcs, "srcs",
+             "srcs/ is missing or holds only the placeholder"});
+    if (!canvas)
+        report.issues.push_back({ValidationIssue::Code::MissingCanvasPdf, "",
+                                 "no canvas PDF at the repo root"});
+    if (!pitch_pdf)
+        report.issues.push_back({ValidationIssue::Code::MissingPitchPdf,
+                                 "pitch", "pitch/ has no valid PDF"});
+    return report;
+}
+
+} // namespace intake
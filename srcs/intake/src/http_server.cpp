@@ -0,0 +1,429 @@
+#include "intake/http_server.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <coroutine>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace intake {
+
+namespace {
+
+[[noreturn]] void fail(const char* what) {
+    throw std::runtime_error(std::string("http: ") + what + ": " +
+                             std::strerror(errno));
+}
+
+void set_nonblocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+// Closes the fd when the owning coroutine frame is destroyed, including the
+// forced-destruction path at shutdown.
+struct FdGuard {
+    int fd = -1;
+    ~FdGuard() {
+        if (fd >= 0)
+            ::close(fd);
+    }
+};
+
+// Fire-and-forget coroutine: runs eagerly, frees its own frame on return.
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() {} // connection dies, server lives
+    };
+};
+
+// Single-threaded epoll reactor. A coroutine co_awaits readiness on an fd;
+// the loop resumes it when the kernel reports the event. One waiter per fd
+// (connections are sequential read-then-write state machines).
+class Reactor {
+public:
+    Reactor() {
+        epfd_ = epoll_create1(EPOLL_CLOEXEC);
+        if (epfd_ < 0 || pipe2(wake_, O_CLOEXEC | O_NONBLOCK) != 0)
+            fail("reactor setup failed");
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = wake_[0];
+        epoll_ctl(epfd_, EPOLL_CTL_ADD, wake_[0], &ev);
+    }
+
+    ~Reactor() {
+        ::close(epfd_);
+        ::close(wake_[0]);
+        ::close(wake_[1]);
+    }
+
+    struct IoAwaiter {
+        Reactor& reactor;
+        int fd;
+        std::uint32_t events;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) {
+            reactor.arm(fd, events, h);
+        }
+        void await_resume() const noexcept {}
+    };
+
+    IoAwaiter wait(int fd, std::uint32_t events) {
+        return {*this, fd, events};
+    }
+
+    void run() {
+        running_.store(true, std::memory_order_release);
+        epoll_event events[64];
+        while (running_.load(std::memory_order_acquire)) {
+            const int n = epoll_wait(epfd_, events, 64, -1);
+            for (int i = 0; i < n; ++i) {
+                const int fd = events[i].data.fd;
+                if (fd == wake_[0]) {
+                    char buf[16];
+                    while (::read(wake_[0], buf, sizeof(buf)) > 0)
+                        ;
+                    continue;
+                }
+                const auto it = waiters_.find(fd);
+                if (it == waiters_.end())
+                    continue;
+                const std::coroutine_handle<> h = it->second;
+                waiters_.erase(it);
+                h.resume();
+            }
+        }
+        // Tear down suspended connections; FdGuard destructors close fds.
+        auto pending = std::move(waiters_);
+        waiters_.clear();
+        for (auto& [fd, h] : pending)
+            h.destroy();
+    }
+
+    void stop() { // called from another thread; the reactor reads the flag
+        running_.store(false, std::memory_order_release);
+        const char b = 0;
+        [[maybe_unused]] ssize_t w = ::write(wake_[1], &b, 1);
+    }
+
+    void forget(int fd) {
+        waiters_.erase(fd);
+        epoll_ctl(epfd_, EPOLL_CTL_DEL, fd, nullptr);
+    }
+
+private:
+    void arm(int fd, std::uint32_t events, std::coroutine_handle<> h) {
+        epoll_event ev{};
+        ev.events = events | EPOLLONESHOT;
+        ev.data.fd = fd;
+        if (epoll_ctl(epfd_, EPOLL_CTL_MOD, fd, &ev) != 0 &&
+            epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev) != 0)
+            fail("epoll_ctl failed");
+        waiters_[fd] = h;
+    }
+
+    int epfd_ = -1;
+    int wake_[2] = {-1, -1};
+    std::atomic<bool> running_{false};
+    std::unordered_map<int, std::coroutine_handle<>> waiters_;
+};
+
+// ---------------------------------------------------------------------------
+// View rendering: one JSON document per sheet, built at startup.
+
+void json_escape_into(std::string& out, std::string_view s) {
+    for (char c : s) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                out += buf;
+            } else {
+                out.push_back(c);
+            }
+        }
+    }
+}
+
+std::string render_sheet(const ColumnarCache& cache,
+                         const ColumnarCache::Sheet& sheet,
+                         const std::string& etag) {
+    std::string out = "{\"sheet\":\"";
+    json_escape_into(out, sheet.name);
+    out += "\",\"generation\":\"" + etag + "\",\"columns\":[";
+    for (std::size_t c = 0; c < sheet.columns.size(); ++c) {
+        if (c)
+            out.push_back(',');
+        out.push_back('"');
+        json_escape_into(out, sheet.columns[c].name);
+        out.push_back('"');
+    }
+    out += "],\"rows\":[";
+    for (std::uint64_t r = 0; r < sheet.rows; ++r) {
+        if (r)
+            out.push_back(',');
+        out.push_back('[');
+        for (std::size_t c = 0; c < sheet.columns.size(); ++c) {
+            if (c)
+                out.push_back(',');
+            const ColumnarCache::Column& col = sheet.columns[c];
+            if (col.type == ColumnarCache::ColumnType::Number) {
+                const double v = col.numbers[r];
+                if (std::isnan(v)) {
+                    out += "null";
+                } else {
+                    char buf[32];
+                    std::snprintf(buf, sizeof(buf), "%.17g", v);
+                    out += buf;
+                }
+            } else {
+                const std::uint32_t id = col.strings[r];
+                if (id == ColumnarCache::kNoString) {
+                    out += "null";
+                } else {
+                    out.push_back('"');
+                    json_escape_into(out, cache.string_at(id));
+                    out.push_back('"');
+                }
+            }
+        }
+        out.push_back(']');
+    }
+    out += "]}";
+    return out;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+
+struct HttpServer::Impl {
+    Reactor reactor;
+    int listen_fd = -1;
+    std::uint16_t port = 0;
+    std::string etag; // quoted cache generation
+    std::unordered_map<std::string, std::string> views; // path -> body
+    std::atomic<std::uint64_t> requests{0};
+
+    ~Impl() {
+        if (listen_fd >= 0)
+            ::close(listen_fd);
+    }
+
+    void build_views(const ColumnarCache& cache) {
+        etag = "\"" + cache.source_digest().hex() + "\"";
+        std::string sheets_json = "{\"generation\":" + etag + ",\"sheets\":[";
+        const std::string bare = etag.substr(1, etag.size() - 2);
+        for (std::size_t i = 0; i < cache.sheets().size(); ++i) {
+            const ColumnarCache::Sheet& s = cache.sheets()[i];
+            if (i)
+                sheets_json.push_back(',');
+            sheets_json.push_back('"');
+            json_escape_into(sheets_json, s.name);
+            sheets_json.push_back('"');
+            views["/sheet/" + std::string(s.name)] =
+                render_sheet(cache, s, bare);
+        }
+        sheets_json += "]}";
+        views["/sheets"] = std::move(sheets_json);
+        const std::pair<const char*, const char*> aliases[] = {
+            {"/attendance", "/sheet/Attendance_checklist"},
+            {"/feedback", "/sheet/Feedback_Forms"},
+            {"/scoring", "/sheet/Examples of Reports"},
+        };
+        for (const auto& [alias, target] : aliases) {
+            const auto it = views.find(target);
+            if (it != views.end())
+                views[alias] = it->second;
+        }
+    }
+
+    DetachedTask accept_loop();
+    DetachedTask serve_connection(int fd);
+};
+
+namespace {
+
+// Pulls one header's value out of a raw request block; empty if absent.
+std::string_view find_header(std::string_view request, std::string_view name) {
+    std::size_t at = 0;
+    while ((at = request.find("\r\n", at)) != std::string_view::npos) {
+        at += 2;
+        if (request.size() - at < name.size() + 1)
+            break;
+        bool match = true;
+        for (std::size_t i = 0; i < name.size(); ++i)
+            if ((request[at + i] | 0x20) != (name[i] | 0x20)) {
+                match = false;
+                break;
+            }
+        if (!match || request[at + name.size()] != ':')
+            continue;
+        std::size_t v = at + name.size() + 1;
+        while (v < request.size() && request[v] == ' ')
+            ++v;
+        const std::size_t end = request.find("\r\n", v);
+        return request.substr(v, end - v);
+    }
+    return {};
+}
+
+} // namespace
+
+DetachedTask HttpServer::Impl::accept_loop() {
+    while (true) {
+        co_await reactor.wait(listen_fd, EPOLLIN);
+        while (true) {
+            const int fd =
+                accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0)
+                break; // EAGAIN: batch drained
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            serve_connection(fd);
+        }
+    }
+}
+
+DetachedTask HttpServer::Impl::serve_connection(int fd) {
+    FdGuard guard{fd};
+    std::string buf;
+    while (true) {
+        // Read until the end of the request head (GETs have no body).
+        std::size_t head_end;
+        while ((head_end = buf.find("\r\n\r\n")) == std::string::npos) {
+            if (buf.size() > 16 * 1024)
+                co_return; // oversized head: drop the connection
+            char chunk[4096];
+            const ssize_t r = ::read(fd, chunk, sizeof(chunk));
+            if (r > 0) {
+                buf.append(chunk, static_cast<std::size_t>(r));
+                continue;
+            }
+            if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                co_await reactor.wait(fd, EPOLLIN);
+                continue;
+            }
+            reactor.forget(fd);
+            co_return; // peer closed
+        }
+        const std::string_view head(buf.data(), head_end + 4);
+        requests.fetch_add(1, std::memory_order_relaxed);
+
+        // Request line: METHOD SP PATH SP VERSION.
+        const std::size_t sp1 = head.find(' ');
+        const std::size_t sp2 = head.find(' ', sp1 + 1);
+        std::string response;
+        bool keep_alive = true;
+        if (sp1 == std::string_view::npos || sp2 == std::string_view::npos) {
+            response = "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n"
+                       "Connection: close\r\n\r\n";
+            keep_alive = false;
+        } else {
+            const std::string_view method = head.substr(0, sp1);
+            const std::string path(head.substr(sp1 + 1, sp2 - sp1 - 1));
+            const std::string_view conn = find_header(head, "Connection");
+            if (conn == "close")
+                keep_alive = false;
+            if (method != "GET") {
+                response = "HTTP/1.1 405 Method Not Allowed\r\n"
+                           "Content-Length: 0\r\n\r\n";
+            } else if (const auto it = views.find(path); it == views.end()) {
+                response = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n"
+                           "\r\n";
+            } else if (find_header(head, "If-None-Match") == etag) {
+                // Dashboard steady state: nothing moved, nothing sent.
+                response = "HTTP/1.1 304 Not Modified\r\nETag: " + etag +
+                           "\r\n\r\n";
+            } else {
+                response = "HTTP/1.1 200 OK\r\n"
+                           "Content-Type: application/json\r\n"
+                           "ETag: " +
+                           etag + "\r\nContent-Length: " +
+                           std::to_string(it->second.size()) + "\r\n\r\n" +
+                           it->second;
+            }
+        }
+        buf.erase(0, head_end + 4);
+
+        std::size_t sent = 0;
+        while (sent < response.size()) {
+            const ssize_t w =
+                ::write(fd, response.data() + sent, response.size() - sent);
+            if (w > 0) {
+                sent += static_cast<std::size_t>(w);
+                continue;
+            }
+            if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                co_await reactor.wait(fd, EPOLLOUT);
+                continue;
+            }
+            reactor.forget(fd);
+            co_return;
+        }
+        if (!keep_alive) {
+            reactor.forget(fd);
+            co_return;
+        }
+    }
+}
+
+HttpServer::HttpServer(const ColumnarCache& cache, Options options)
+    : impl_(std::make_unique<Impl>()) {
+    impl_->build_views(cache);
+
+    impl_->listen_fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (impl_->listen_fd < 0)
+        fail("socket failed");
+    int one = 1;
+    setsockopt(impl_->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(options.port);
+    if (bind(impl_->listen_fd, reinterpret_cast<sockaddr*>(&addr),
+             sizeof(addr)) != 0 ||
+        listen(impl_->listen_fd, options.backlog) != 0)
+        fail("bind/listen failed");
+    socklen_t len = sizeof(addr);
+    getsockname(impl_->listen_fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    impl_->port = ntohs(addr.sin_port);
+    set_nonblocking(impl_->listen_fd);
+}
+
+HttpServer::~HttpServer() = default;
+
+void HttpServer::run() {
+    impl_->accept_loop();
+    impl_->reactor.run();
+}
+
+void HttpServer::stop() { impl_->reactor.stop(); }
+
+std::uint16_t HttpServer::port() const { return impl_->port; }
+
+std::uint64_t HttpServer::requests_served() const {
+    return impl_->requests.load(std::memory_order_relaxed);
+}
+
+} // namespace intake
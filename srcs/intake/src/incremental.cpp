@@ -0,0 +1,163 @@
+#include "intake/incremental.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include "intake/mmap_file.hpp"
+
+namespace fs = std::filesystem;
+
+namespace intake {
+
+FileManifest FileManifest::load(const std::string& path) {
+    FileManifest m;
+    std::ifstream in(path);
+    if (!in)
+        return m; // first run
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+        const std::size_t tab1 = line.find('\t');
+        const std::size_t tab2 =
+            tab1 == std::string::npos ? std::string::npos
+                                      : line.find('\t', tab1 + 1);
+        if (tab2 == std::string::npos)
+            throw std::runtime_error("manifest: malformed line in " + path);
+        auto digest = Digest::from_hex(std::string_view(line).substr(0, tab1));
+        if (!digest)
+            throw std::runtime_error("manifest: bad digest in " + path);
+        Entry e;
+        e.digest = *digest;
+        e.size = std::strtoull(line.c_str() + tab1 + 1, nullptr, 10);
+        m.entries_[line.substr(tab2 + 1)] = e;
+    }
+    return m;
+}
+
+void FileManifest::save(const std::string& path) const {
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        if (!out)
+            throw std::runtime_error("manifest: cannot write " + tmp);
+        out << "# intake manifest v1\n";
+        for (const auto& [rel, e] : entries_)
+            out << e.digest.hex() << '\t' << e.size << '\t' << rel << '\n';
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        throw std::runtime_error("manifest: cannot finalize " + path);
+    }
+}
+
+const FileManifest::Entry* FileManifest::find(std::string_view rel) const {
+    auto it = entries_.find(rel);
+    return it == entries_.end() ? nullptr : &it->second;
+}
+
+void FileManifest::set(std::string rel, Entry entry) {
+    entries_[std::move(rel)] = entry;
+}
+
+IncrementalValidator::IncrementalValidator(ThreadPool& pool,
+                                           std::string manifest_dir)
+    : pool_(pool), validator_(pool), manifest_dir_(std::move(manifest_dir)) {
+    std::error_code ec;
+    fs::create_directories(manifest_dir_, ec);
+    if (ec)
+        throw std::runtime_error("manifest: cannot create " + manifest_dir_);
+}
+
+std::string IncrementalValidator::manifest_path(const ForkRef& fork) const {
+    Blake2b hasher;
+    hasher.update(fork.root);
+    hasher.update("\0", 1);
+    hasher.update(fork.branch);
+    return manifest_dir_ + "/" + hasher.finish().hex() + ".manifest";
+}
+
+DeltaReport IncrementalValidator::revalidate(const ForkRef& fork) {
+    const std::string mpath = manifest_path(fork);
+    const FileManifest previous = FileManifest::load(mpath);
+
+    // Hash the current tree in parallel; one task per file.
+    struct HashResult {
+        std::string rel;
+        FileManifest::Entry entry;
+    };
+    std::vector<HashResult> results;
+    std::mutex results_mu;
+    std::atomic<std::size_t> outstanding{0};
+
+    const fs::path root(fork.root);
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(root, ec), end; !ec && it != end;
+         it.increment(ec)) {
+        if (it->is_directory(ec)) {
+            if (it->path().filename() == ".git")
+                it.disable_recursion_pending();
+            continue;
+        }
+        if (!it->is_regular_file(ec))
+            continue;
+        outstanding.fetch_add(1, std::memory_order_relaxed);
+        pool_.submit([path = it->path(), &root, &results, &results_mu,
+                      &outstanding] {
+            try {
+                MmapFile file(path.string());
+                HashResult r;
+                r.rel = path.lexically_relative(root).string();
+                r.entry.digest = Blake2b::hash(file.view());
+                r.entry.size = file.size();
+                std::lock_guard<std::mutex> lk(results_mu);
+                results.push_back(std::move(r));
+            } catch (const std::exception&) {
+                // Racing deletion mid-push: treat as absent.
+            }
+            outstanding.fetch_sub(1, std::memory_order_acq_rel);
+        });
+    }
+    while (outstanding.load(std::memory_order_acquire) != 0)
+        if (!pool_.try_run_one())
+            std::this_thread::yield();
+
+    // Diff against the previous run.
+    DeltaReport report;
+    FileManifest current;
+    for (HashResult& r : results) {
+        const FileManifest::Entry* old = previous.find(r.rel);
+        if (old == nullptr || !(old->digest == r.entry.digest)) {
+            report.changed.push_back(r.rel);
+            const fs::path rel(r.rel);
+            if (rel == rel.filename() && rel.extension() == ".pdf")
+                report.canvas_changed = true;
+        }
+        current.set(std::move(r.rel), r.entry);
+    }
+    for (const auto& [rel, entry] : previous.entries()) {
+        if (current.find(rel) == nullptr) {
+            report.removed.push_back(rel);
+            const fs::path relp(rel);
+            if (relp == relp.filename() && relp.extension() == ".pdf")
+                report.canvas_changed = true;
+        }
+    }
+
+    // First run (empty previous manifest) always validates; later runs only
+    // when the delta is non-empty.
+    if (!report.unchanged() || previous.entries().empty()) {
+        report.validation = validator_.validate_fork(fork);
+        report.validation_ran = true;
+    }
+
+    current.save(mpath);
+    return report;
+}
+
+} // namespace intake
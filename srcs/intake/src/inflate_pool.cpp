@@ -0,0 +1,132 @@
+#include "intake/inflate_pool.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <zlib.h>
+
+namespace intake {
+
+namespace {
+
+// Inflates one part into `dest` (exactly `size` bytes expected).
+void inflate_exact(const ParallelInflater::Part& part, char* dest,
+                   std::size_t size, std::string& error) {
+    z_stream zs{};
+    if (inflateInit2(&zs, part.raw_deflate ? -MAX_WBITS : 15 + 32) != Z_OK) {
+        error = "inflateInit failed";
+        return;
+    }
+    zs.next_in = const_cast<Bytef*>(part.data);
+    zs.avail_in = static_cast<uInt>(part.compressed_size);
+    zs.next_out = reinterpret_cast<Bytef*>(dest);
+    zs.avail_out = static_cast<uInt>(size);
+    const int rc = inflate(&zs, Z_FINISH);
+    const std::size_t got = zs.total_out;
+    inflateEnd(&zs);
+    if (rc != Z_STREAM_END || got != size)
+        error = "corrupt deflate stream";
+}
+
+// Unknown output size: grow a local buffer in doubling steps.
+void inflate_grow(const ParallelInflater::Part& part, std::string& dest,
+                  std::string& error) {
+    z_stream zs{};
+    if (inflateInit2(&zs, part.raw_deflate ? -MAX_WBITS : 15 + 32) != Z_OK) {
+        error = "inflateInit failed";
+        return;
+    }
+    zs.next_in = const_cast<Bytef*>(part.data);
+    zs.avail_in = static_cast<uInt>(part.compressed_size);
+    dest.resize(part.compressed_size * 4 + 1024);
+    int rc;
+    do {
+        zs.next_out = reinterpret_cast<Bytef*>(dest.data()) + zs.total_out;
+        zs.avail_out = static_cast<uInt>(dest.size() - zs.total_out);
+        rc = inflate(&zs, Z_NO_FLUSH);
+        if (rc == Z_OK && zs.avail_out == 0)
+            dest.resize(dest.size() * 2);
+    } while (rc == Z_OK);
+    dest.resize(zs.total_out);
+    inflateEnd(&zs);
+    if (rc != Z_STREAM_END)
+        error = "corrupt deflate stream";
+}
+
+} // namespace
+
+void ParallelInflater::inflate_all(std::span<Part> parts, Arena& arena) {
+    // Arena carving happens here, on the calling thread: workers only ever
+    // write into their pre-assigned slices.
+    std::vector<char*> dests(parts.size(), nullptr);
+    std::vector<std::string> scratch(parts.size());
+    for (std::size_t i = 0; i < parts.size(); ++i)
+        if (parts[i].uncompressed_size != 0)
+            dests[i] = static_cast<char*>(
+                arena.allocate(parts[i].uncompressed_size, 1));
+
+    std::atomic<std::size_t> remaining{parts.size()};
+    for (std::size_t i = 0; i < parts.size(); ++i) {
+        pool_.submit([&, i] {
+            Part& p = parts[i];
+            if (p.uncompressed_size != 0)
+                inflate_exact(p, dests[i], p.uncompressed_size, p.error);
+            else
+                inflate_grow(p, scratch[i], p.error);
+            remaining.fetch_sub(1, std::memory_order_release);
+        });
+    }
+    while (remaining.load(std::memory_order_acquire) != 0)
+        if (!pool_.try_run_one())
+            std::this_thread::yield();
+
+    for (std::size_t i = 0; i < parts.size(); ++i) {
+        Part& p = parts[i];
+        if (!p.ok())
+            continue;
+        if (p.uncompressed_size != 0)
+            p.out = {dests[i], p.uncompressed_size};
+        else
+            p.out = arena.copy(scratch[i]);
+    }
+}
+
+void ParallelInflater::read_entries(
+    const MmapFile& archive,
+    std::span<const ZipReader::Entry* const> entries,
+    std::span<std::string_view> out, Arena& arena) {
+    std::vector<Part> parts;
+    std::vector<std::size_t> part_index(entries.size(), SIZE_MAX);
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        const ZipReader::Entry& e = *entries[i];
+        if (e.method == 0) { // stored: zero-copy view, no pool round-trip
+            out[i] = {reinterpret_cast<const char*>(archive.data()) +
+                          e.data_offset,
+                      static_cast<std::size_t>(e.uncompressed_size)};
+            continue;
+        }
+        Part p;
+        p.data = archive.data() + e.data_offset;
+        p.compressed_size = e.compressed_size;
+        p.raw_deflate = true;
+        p.uncompressed_size = e.uncompressed_size;
+        part_index[i] = parts.size();
+        parts.push_back(p);
+    }
+    inflate_all(parts, arena);
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        if (part_index[i] == SIZE_MAX)
+            continue;
+        const Part& p = parts[part_index[i]];
+        if (!p.ok())
+            throw std::runtime_error("zip: inflate failed for " +
+                                     std::string(entries[i]->name) + ": " +
+                                     p.error);
+        out[i] = p.out;
+    }
+}
+
+} // namespace intake
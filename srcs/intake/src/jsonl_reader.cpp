@@ -0,0 +1,253 @@
+#include "intake/jsonl_reader.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+#include "intake/xml_scan.hpp"
+
+namespace intake {
+
+namespace {
+
+bool is_ws(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+const char* skip_ws(const char* p, const char* end) {
+    while (p < end && is_ws(*p))
+        ++p;
+    return p;
+}
+
+// Closing quote of a string whose opening quote sits just before `p`.
+// The SIMD scanner finds candidate quotes; backslash parity rejects the
+// escaped ones. Returns `end` on an unterminated string.
+const char* string_end(const char* p, const char* end) {
+    while (true) {
+        const char* q = xmlscan::find_byte(p, end, '"');
+        if (q == end)
+            return end;
+        const char* b = q;
+        while (b > p && b[-1] == '\\')
+            --b;
+        if ((q - b) % 2 == 0)
+            return q;
+        p = q + 1;
+    }
+}
+
+// End of a balanced {...} or [...] slice, string-aware. Returns `end` on
+// malformed input.
+const char* balanced_end(const char* p, const char* end) {
+    int depth = 0;
+    while (p < end) {
+        const char c = *p;
+        if (c == '"') {
+            p = string_end(p + 1, end);
+            if (p == end)
+                return end;
+        } else if (c == '{' || c == '[') {
+            ++depth;
+        } else if (c == '}' || c == ']') {
+            if (--depth == 0)
+                return p + 1;
+        }
+        ++p;
+    }
+    return end;
+}
+
+// Tokenizes one line into the flat field table. Returns false when the line
+// is not a well-formed flat object scan (tailers tolerate torn writes).
+bool parse_line(const char* p, const char* end, std::vector<JsonField>& out) {
+    out.clear();
+    p = skip_ws(p, end);
+    if (p == end || *p != '{')
+        return false;
+    p = skip_ws(p + 1, end);
+    if (p < end && *p == '}')
+        return true; // empty object
+    while (p < end) {
+        if (*p != '"')
+            return false;
+        const char* key_end = string_end(p + 1, end);
+        if (key_end == end)
+            return false;
+        JsonField f;
+        f.key = {p + 1, static_cast<std::size_t>(key_end - p - 1)};
+        p = skip_ws(key_end + 1, end);
+        if (p == end || *p != ':')
+            return false;
+        p = skip_ws(p + 1, end);
+        if (p == end)
+            return false;
+
+        if (*p == '"') {
+            const char* vend = string_end(p + 1, end);
+            if (vend == end)
+                return false;
+            f.type = JsonField::Type::String;
+            f.raw = {p + 1, static_cast<std::size_t>(vend - p - 1)};
+            p = vend + 1;
+        } else if (*p == '{' || *p == '[') {
+            const char* vend = balanced_end(p, end);
+            if (vend == end)
+                return false;
+            f.type = *p == '{' ? JsonField::Type::Object
+                               : JsonField::Type::Array;
+            f.raw = {p, static_cast<std::size_t>(vend - p)};
+            p = vend;
+        } else if (end - p >= 4 && memcmp(p, "true", 4) == 0) {
+            f.type = JsonField::Type::Bool;
+            f.raw = {p, 4};
+            p += 4;
+        } else if (end - p >= 5 && memcmp(p, "false", 5) == 0) {
+            f.type = JsonField::Type::Bool;
+            f.raw = {p, 5};
+            p += 5;
+        } else if (end - p >= 4 && memcmp(p, "null", 4) == 0) {
+            f.type = JsonField::Type::Null;
+            f.raw = {p, 4};
+            p += 4;
+        } else {
+            const char* vend = p;
+            while (vend < end && *vend != ',' && *vend != '}' &&
+                   !is_ws(*vend))
+                ++vend;
+            if (vend == p)
+                return false;
+            f.type = JsonField::Type::Number;
+            f.raw = {p, static_cast<std::size_t>(vend - p)};
+            p = vend;
+        }
+        out.push_back(f);
+
+        p = skip_ws(p, end);
+        if (p == end)
+            return false;
+        if (*p == '}')
+            return true;
+        if (*p != ',')
+            return false;
+        p = skip_ws(p + 1, end);
+    }
+    return false;
+}
+
+// JSON string unescape into the arena; only called for the rare escaped
+// string. \uXXXX is decoded to UTF-8 (surrogate pairs included).
+std::string_view unescape(std::string_view raw, Arena& arena) {
+    ArenaStringBuilder out(arena);
+    for (std::size_t i = 0; i < raw.size(); ++i) {
+        if (raw[i] != '\\') {
+            out.push_back(raw[i]);
+            continue;
+        }
+        if (++i >= raw.size())
+            break;
+        switch (raw[i]) {
+        case 'n': out.push_back('\n'); break;
+        case 't': out.push_back('\t'); break;
+        case 'r': out.push_back('\r'); break;
+        case 'b': out.push_back('\b'); break;
+        case 'f': out.push_back('\f'); break;
+        case 'u': {
+            if (i + 4 >= raw.size())
+                break;
+            char hex[5] = {raw[i + 1], raw[i + 2], raw[i + 3], raw[i + 4], 0};
+            std::uint32_t cp =
+                static_cast<std::uint32_t>(std::strtoul(hex, nullptr, 16));
+            i += 4;
+            if (cp >= 0xd800 && cp < 0xdc00 && i + 6 < raw.size() &&
+                raw[i + 1] == '\\' && raw[i + 2] == 'u') {
+                char hex2[5] = {raw[i + 3], raw[i + 4], raw[i + 5],
+                                raw[i + 6], 0};
+                const std::uint32_t lo = static_cast<std::uint32_t>(
+                    std::strtoul(hex2, nullptr, 16));
+                if (lo >= 0xdc00 && lo < 0xe000) {
+                    cp = 0x10000 + ((cp - 0xd800) << 10) + (lo - 0xdc00);
+                    i += 6;
+                }
+            }
+            if (cp < 0x80) {
+                out.push_back(static_cast<char>(cp));
+            } else if (cp < 0x800) {
+                out.push_back(static_cast<char>(0xc0 | (cp >> 6)));
+                out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+            } else if (cp < 0x10000) {
+                out.push_back(static_cast<char>(0xe0 | (cp >> 12)));
+                out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+                out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+            } else {
+                out.push_back(static_cast<char>(0xf0 | (cp >> 18)));
+                out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3f)));
+                out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+                out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+            }
+            break;
+        }
+        default: out.push_back(raw[i]); break; // covers \" \\ \/
+        }
+    }
+    return out.view();
+}
+
+} // namespace
+
+const JsonField* JsonRecord::find(std::string_view key) const {
+    for (const JsonField& f : fields_)
+        if (f.key == key)
+            return &f;
+    return nullptr;
+}
+
+std::string_view JsonRecord::string(std::string_view key) const {
+    const JsonField* f = find(key);
+    if (!f || f->type != JsonField::Type::String)
+        return {};
+    if (f->raw.find('\\') == std::string_view::npos)
+        return f->raw; // zero-copy fast path
+    return unescape(f->raw, *arena_);
+}
+
+double JsonRecord::number(std::string_view key) const {
+    const JsonField* f = find(key);
+    if (!f || f->type != JsonField::Type::Number)
+        return 0.0;
+    char buf[64];
+    const std::size_t n = f->raw.size() < 63 ? f->raw.size() : 63;
+    memcpy(buf, f->raw.data(), n);
+    buf[n] = '\0';
+    return std::strtod(buf, nullptr);
+}
+
+bool JsonRecord::boolean(std::string_view key) const {
+    const JsonField* f = find(key);
+    return f && f->type == JsonField::Type::Bool && f->raw == "true";
+}
+
+JsonlReader::JsonlReader(const std::string& path) : file_(path) {
+    record_.arena_ = &arena_;
+}
+
+std::size_t JsonlReader::for_each_record(std::size_t from,
+                                         const RecordCallback& cb) {
+    const char* base = reinterpret_cast<const char*>(file_.data());
+    const char* end = base + file_.size();
+    const char* p = base + (from < file_.size() ? from : file_.size());
+    std::size_t line_no = 0;
+    while (p < end) {
+        const char* nl = xmlscan::find_byte(p, end, '\n');
+        if (nl == end)
+            break; // incomplete tail line: resume here next round
+        if (parse_line(p, nl, record_.fields_)) {
+            cb(line_no, record_);
+            arena_.reset();
+        }
+        ++line_no;
+        p = nl + 1;
+    }
+    return static_cast<std::size_t>(p - base);
+}
+
+} // namespace intake
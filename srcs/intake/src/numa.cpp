@@ -0,0 +1,278 @@
+#include "intake/numa.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "intake/mmap_file.hpp"
+
+namespace intake::numa {
+
+namespace {
+
+// Raw policy syscalls; both fail cleanly (ENOSYS/EPERM) where unsupported.
+long sys_mbind(void* addr, unsigned long len, int mode,
+               const unsigned long* nodemask, unsigned long maxnode) {
+    return ::syscall(SYS_mbind, addr, len, mode, nodemask, maxnode, 0UL);
+}
+
+long sys_get_mempolicy(int* mode, unsigned long* nodemask,
+                       unsigned long maxnode, void* addr,
+                       unsigned long flags) {
+    return ::syscall(SYS_get_mempolicy, mode, nodemask, maxnode, addr, flags);
+}
+
+constexpr int kMpolBind = 2;
+constexpr unsigned long kMpolFNode = 1UL << 0;
+constexpr unsigned long kMpolFAddr = 1UL << 1;
+
+// Parses "0-3,8,10-11" into CPU numbers.
+std::vector<int> parse_cpulist(const std::string& list) {
+    std::vector<int> out;
+    std::size_t at = 0;
+    while (at < list.size()) {
+        char* end = nullptr;
+        const long lo = std::strtol(list.c_str() + at, &end, 10);
+        long hi = lo;
+        if (*end == '-')
+            hi = std::strtol(end + 1, &end, 10);
+        for (long c = lo; c <= hi; ++c)
+            out.push_back(static_cast<int>(c));
+        at = static_cast<std::size_t>(end - list.c_str());
+        while (at < list.size() && (list[at] == ',' || list[at] == '\n'))
+            ++at;
+    }
+    return out;
+}
+
+struct Topology {
+    std::vector<std::vector<int>> node_cpus; // at least one node
+    std::vector<std::size_t> cpu_node;       // cpu -> node
+
+    Topology() {
+        for (std::size_t n = 0;; ++n) {
+            std::ifstream in("/sys/devices/system/node/node" +
+                             std::to_string(n) + "/cpulist");
+            if (!in)
+                break;
+            std::string list;
+            std::getline(in, list);
+            node_cpus.push_back(parse_cpulist(list));
+        }
+        if (node_cpus.empty()) { // no sysfs: treat as one node, all CPUs
+            std::vector<int> all;
+            const long n = ::sysconf(_SC_NPROCESSORS_ONLN);
+            for (long c = 0; c < n; ++c)
+                all.push_back(static_cast<int>(c));
+            node_cpus.push_back(std::move(all));
+        }
+        for (std::size_t n = 0; n < node_cpus.size(); ++n)
+            for (int cpu : node_cpus[n]) {
+                if (cpu_node.size() <= static_cast<std::size_t>(cpu))
+                    cpu_node.resize(static_cast<std::size_t>(cpu) + 1, 0);
+                cpu_node[static_cast<std::size_t>(cpu)] = n;
+            }
+    }
+};
+
+const Topology& topology() {
+    static const Topology topo;
+    return topo;
+}
+
+void bind_range_to_node(void* addr, std::size_t len, std::size_t node) {
+    if (topology().node_cpus.size() < 2)
+        return; // single node: the default policy is already local
+    unsigned long mask = 1UL << node;
+    sys_mbind(addr, len, kMpolBind, &mask, sizeof(mask) * 8);
+}
+
+} // namespace
+
+std::size_t node_count() { return topology().node_cpus.size(); }
+
+const std::vector<int>& cpus_of_node(std::size_t node) {
+    return topology().node_cpus.at(node);
+}
+
+std::size_t node_of_address(const void* addr) {
+    int node = -1;
+    if (sys_get_mempolicy(&node, nullptr, 0, const_cast<void*>(addr),
+                          kMpolFNode | kMpolFAddr) != 0 ||
+        node < 0)
+        return 0;
+    return static_cast<std::size_t>(node);
+}
+
+std::size_t current_node() {
+    const int cpu = ::sched_getcpu();
+    const Topology& topo = topology();
+    if (cpu < 0 || static_cast<std::size_t>(cpu) >= topo.cpu_node.size())
+        return 0;
+    return topo.cpu_node[static_cast<std::size_t>(cpu)];
+}
+
+bool bind_current_thread(std::size_t node) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus_of_node(node))
+        CPU_SET(cpu, &set);
+    return ::sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+// ---------------------------------------------------------------------------
+// NodeArena.
+
+NodeArena::NodeArena(std::size_t node, std::size_t first_block)
+    : node_(node), first_block_size_(first_block) {}
+
+NodeArena::~NodeArena() {
+    for (Block& b : blocks_)
+        ::munmap(b.data, b.size);
+}
+
+NodeArena::Block NodeArena::map_block(std::size_t size) const {
+    void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+        throw std::runtime_error("numa: arena mmap failed");
+    // Policy must be set before first touch; faults then land on the node.
+    bind_range_to_node(p, size, node_);
+    return {static_cast<unsigned char*>(p), size, 0};
+}
+
+void* NodeArena::allocate(std::size_t size, std::size_t align) {
+    if (!blocks_.empty()) {
+        Block& b = blocks_.back();
+        const std::size_t aligned = (b.used + align - 1) & ~(align - 1);
+        if (aligned + size <= b.size) {
+            b.used = aligned + size;
+            return b.data + aligned;
+        }
+    }
+    return allocate_slow(size, align);
+}
+
+void* NodeArena::allocate_slow(std::size_t size, std::size_t align) {
+    const std::size_t page = 4096;
+    std::size_t block_size =
+        blocks_.empty() ? first_block_size_ : blocks_.back().size * 2;
+    if (block_size < size + align)
+        block_size = size + align;
+    block_size = (block_size + page - 1) & ~(page - 1);
+    blocks_.push_back(map_block(block_size));
+    Block& b = blocks_.back();
+    // mmap returns page-aligned memory, so offset 0 satisfies any sane
+    // alignment request.
+    b.used = size;
+    return b.data;
+}
+
+void NodeArena::reset() {
+    if (blocks_.empty())
+        return;
+    std::size_t largest = 0;
+    for (std::size_t i = 1; i < blocks_.size(); ++i)
+        if (blocks_[i].size > blocks_[largest].size)
+            largest = i;
+    for (std::size_t i = 0; i < blocks_.size(); ++i)
+        if (i != largest)
+            ::munmap(blocks_[i].data, blocks_[i].size);
+    Block keep = blocks_[largest];
+    keep.used = 0;
+    blocks_.clear();
+    blocks_.push_back(keep);
+}
+
+std::size_t NodeArena::bytes_reserved() const {
+    std::size_t total = 0;
+    for (const Block& b : blocks_)
+        total += b.size;
+    return total;
+}
+
+// ---------------------------------------------------------------------------
+// NumaPoolSet.
+
+NumaPoolSet::NumaPoolSet(std::size_t threads_per_node) {
+    for (std::size_t n = 0; n < node_count(); ++n) {
+        const std::size_t threads =
+            threads_per_node != 0 ? threads_per_node : cpus_of_node(n).size();
+        auto pool = std::make_unique<ThreadPool>(threads);
+        // Bind the pool's workers from inside: one pinning task per worker,
+        // held together so each worker runs exactly one of them.
+        std::atomic<std::size_t> ready{0};
+        for (std::size_t t = 0; t < threads; ++t)
+            pool->submit([n, threads, &ready] {
+                bind_current_thread(n);
+                ready.fetch_add(1);
+                while (ready.load() < threads)
+                    std::this_thread::yield();
+            });
+        pool->wait_idle();
+        pools_.push_back(std::move(pool));
+    }
+}
+
+void NumaPoolSet::submit_for(const void* input, std::function<void()> fn) {
+    std::size_t node = input ? node_of_address(input) : current_node();
+    if (node >= pools_.size())
+        node = 0;
+    pools_[node]->submit(std::move(fn));
+}
+
+void NumaPoolSet::wait_idle() {
+    for (auto& pool : pools_)
+        pool->wait_idle();
+}
+
+// ---------------------------------------------------------------------------
+// ReplicatedCache.
+
+ReplicatedCache::ReplicatedCache(const std::string& cache_path) {
+    MmapFile source(cache_path);
+    for (std::size_t n = 0; n < node_count(); ++n) {
+        // Copy into a memfd from a thread bound to the node: first touch of
+        // both the copy pages and the replica's mapping lands locally.
+        const int fd = static_cast<int>(
+            ::syscall(SYS_memfd_create, "intake-cache-replica", 0U));
+        if (fd < 0)
+            throw std::runtime_error("numa: memfd_create failed");
+        std::unique_ptr<ColumnarCache> replica;
+        std::exception_ptr error;
+        std::thread worker([&, fd, n] {
+            try {
+                bind_current_thread(n);
+                const unsigned char* p = source.data();
+                std::size_t left = source.size();
+                while (left > 0) {
+                    const ssize_t w = ::write(fd, p, left);
+                    if (w <= 0)
+                        throw std::runtime_error("numa: replica write failed");
+                    p += w;
+                    left -= static_cast<std::size_t>(w);
+                }
+                replica = std::make_unique<ColumnarCache>(ColumnarCache::open(
+                    "/proc/self/fd/" + std::to_string(fd)));
+            } catch (...) {
+                error = std::current_exception();
+            }
+        });
+        worker.join();
+        ::close(fd); // the replica's mapping keeps the memfd alive
+        if (error)
+            std::rethrow_exception(error);
+        replicas_.push_back(std::move(replica));
+    }
+}
+
+} // namespace intake::numa
@@ -0,0 +1,337 @@
+#include "intake/pack_index.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+#include <openssl/evp.h>
+#include <zlib.h>
+
+#include "intake/trace.hpp"
+
+namespace intake {
+
+namespace {
+
+[[noreturn]] void fail(const std::string& why) {
+    throw std::runtime_error("pack-index: " + why);
+}
+
+std::uint32_t be32(std::string_view pack, std::size_t at) {
+    return (static_cast<std::uint32_t>(static_cast<unsigned char>(pack[at]))
+            << 24) |
+           (static_cast<std::uint32_t>(static_cast<unsigned char>(pack[at + 1]))
+            << 16) |
+           (static_cast<std::uint32_t>(static_cast<unsigned char>(pack[at + 2]))
+            << 8) |
+           static_cast<std::uint32_t>(static_cast<unsigned char>(pack[at + 3]));
+}
+
+std::string object_oid(std::uint8_t type, std::string_view data) {
+    static const char* names[] = {"", "commit", "tree", "blob", "tag"};
+    char header[32];
+    const int hlen = std::snprintf(header, sizeof(header), "%s %zu",
+                                   names[type], data.size()) +
+                     1; // include the NUL
+    unsigned char md[20];
+    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+    EVP_DigestInit_ex(ctx, EVP_sha1(), nullptr);
+    EVP_DigestUpdate(ctx, header, static_cast<std::size_t>(hlen));
+    EVP_DigestUpdate(ctx, data.data(), data.size());
+    unsigned mdlen = 0;
+    EVP_DigestFinal_ex(ctx, md, &mdlen);
+    EVP_MD_CTX_free(ctx);
+    return std::string(reinterpret_cast<char*>(md), 20);
+}
+
+std::string_view oid_to_hex(const std::string& oid, Arena& arena) {
+    static const char* digits = "0123456789abcdef";
+    char* p = static_cast<char*>(arena.allocate(40, 1));
+    for (std::size_t i = 0; i < 20; ++i) {
+        const unsigned char c = static_cast<unsigned char>(oid[i]);
+        p[2 * i] = digits[c >> 4];
+        p[2 * i + 1] = digits[c & 15];
+    }
+    return {p, 40};
+}
+
+std::size_t delta_varint(std::string_view delta, std::size_t& i) {
+    std::size_t v = 0;
+    int shift = 0;
+    unsigned char c;
+    do {
+        if (i >= delta.size())
+            fail("truncated delta");
+        c = static_cast<unsigned char>(delta[i++]);
+        v |= static_cast<std::size_t>(c & 0x7f) << shift;
+        shift += 7;
+    } while (c & 0x80);
+    return v;
+}
+
+// Git delta format, applied straight into the arena: base-size varint,
+// result-size varint, then copy-from-base / insert-literal opcodes.
+std::string_view apply_delta(std::string_view base, std::string_view delta,
+                             Arena& arena) {
+    std::size_t i = 0;
+    if (delta_varint(delta, i) != base.size())
+        fail("delta base size mismatch");
+    const std::size_t result_size = delta_varint(delta, i);
+    char* out = static_cast<char*>(arena.allocate(result_size, 1));
+    std::size_t at = 0;
+    while (i < delta.size()) {
+        const unsigned char op = static_cast<unsigned char>(delta[i++]);
+        if (op & 0x80) { // copy from base
+            std::size_t off = 0, len = 0;
+            for (int bit = 0; bit < 4; ++bit)
+                if (op & (1u << bit))
+                    off |= static_cast<std::size_t>(
+                               static_cast<unsigned char>(delta[i++]))
+                           << (8 * bit);
+            for (int bit = 0; bit < 3; ++bit)
+                if (op & (0x10u << bit))
+                    len |= static_cast<std::size_t>(
+                               static_cast<unsigned char>(delta[i++]))
+                           << (8 * bit);
+            if (len == 0)
+                len = 0x10000;
+            if (off + len > base.size() || at + len > result_size)
+                fail("delta copy out of range");
+            std::memcpy(out + at, base.data() + off, len);
+            at += len;
+        } else if (op) { // insert literal
+            if (i + op > delta.size() || at + op > result_size)
+                fail("delta insert out of range");
+            std::memcpy(out + at, delta.data() + i, op);
+            i += op;
+            at += op;
+        } else {
+            fail("invalid delta opcode 0");
+        }
+    }
+    if (at != result_size)
+        fail("delta result size mismatch");
+    return {out, result_size};
+}
+
+// Parses "author Name <email> 1712345678 +0200"; returns the name+email
+// view and fills the timestamp and timezone.
+std::string_view parse_ident(std::string_view line, std::int64_t& time,
+                             std::int32_t& tz_minutes) {
+    const std::size_t email_end = line.rfind('>');
+    if (email_end == std::string_view::npos)
+        return line;
+    std::string_view rest = line.substr(email_end + 1);
+    std::int64_t t = 0;
+    std::size_t i = 0;
+    while (i < rest.size() && rest[i] == ' ')
+        ++i;
+    while (i < rest.size() && rest[i] >= '0' && rest[i] <= '9')
+        t = t * 10 + (rest[i++] - '0');
+    time = t;
+    while (i < rest.size() && rest[i] == ' ')
+        ++i;
+    if (i + 4 < rest.size() && (rest[i] == '+' || rest[i] == '-')) {
+        const int sign = rest[i] == '-' ? -1 : 1;
+        const int hh = (rest[i + 1] - '0') * 10 + (rest[i + 2] - '0');
+        const int mm = (rest[i + 3] - '0') * 10 + (rest[i + 4] - '0');
+        tz_minutes = sign * (hh * 60 + mm);
+    }
+    return line.substr(0, email_end + 1);
+}
+
+} // namespace
+
+std::string_view PackIndex::inflate_into(std::string_view pack,
+                                         std::size_t& pos,
+                                         std::size_t expected) {
+    char* out = static_cast<char*>(arena_.allocate(expected, 1));
+    z_stream zs{};
+    if (inflateInit(&zs) != Z_OK)
+        fail("inflateInit failed");
+    zs.next_in =
+        reinterpret_cast<Bytef*>(const_cast<char*>(pack.data() + pos));
+    zs.avail_in = static_cast<uInt>(pack.size() - pos);
+    zs.next_out = reinterpret_cast<Bytef*>(out);
+    zs.avail_out = static_cast<uInt>(expected);
+    const int rc = inflate(&zs, Z_FINISH);
+    pos += zs.total_in;
+    inflateEnd(&zs);
+    if (rc != Z_STREAM_END || zs.total_out != expected)
+        fail("corrupt deflate stream in packfile");
+    return {out, expected};
+}
+
+std::uint32_t PackIndex::record_commit(std::string_view hex,
+                                       std::string_view data) {
+    CommitRecord rec;
+    rec.oid_hex = hex;
+    rec.parent_begin = static_cast<std::uint32_t>(parents_.size());
+    const std::uint32_t index = static_cast<std::uint32_t>(commits_.size());
+
+    std::size_t pos = 0;
+    while (pos < data.size()) {
+        const std::size_t eol = data.find('\n', pos);
+        const std::string_view line =
+            data.substr(pos, eol == std::string_view::npos ? std::string_view::npos
+                                                           : eol - pos);
+        if (line.empty())
+            break; // header/message separator
+        if (line.starts_with("parent ") && line.size() >= 7 + 40) {
+            unresolved_.emplace_back(
+                static_cast<std::uint32_t>(parents_.size()),
+                std::string(line.substr(7, 40)));
+            parents_.push_back(kMissingParent);
+            ++rec.parent_count;
+        } else if (line.starts_with("author ")) {
+            rec.author = parse_ident(line.substr(7), rec.author_time,
+                                     rec.tz_minutes);
+        } else if (line.starts_with("committer ")) {
+            std::int32_t tz = 0;
+            parse_ident(line.substr(10), rec.commit_time, tz);
+        }
+        if (eol == std::string_view::npos)
+            break;
+        pos = eol + 1;
+    }
+
+    commits_.push_back(rec);
+    commit_by_hex_[hex] = index;
+    return index;
+}
+
+void PackIndex::link_parents() {
+    // Resolve what this pack made visible; the rest waits for later packs
+    // (or stays missing past a shallow cutoff).
+    std::vector<std::pair<std::uint32_t, std::string>> still;
+    for (auto& [slot, hex] : unresolved_) {
+        const auto it = commit_by_hex_.find(hex);
+        if (it != commit_by_hex_.end())
+            parents_[slot] = it->second;
+        else
+            still.emplace_back(slot, std::move(hex));
+    }
+    unresolved_.swap(still);
+}
+
+void PackIndex::add_pack_file(const std::string& path) {
+    MmapFile file(path);
+    add_pack(file.view());
+}
+
+void PackIndex::add_pack(std::string_view pack) {
+    INTAKE_TRACE_SCOPE("pack.index");
+    if (pack.size() < 12 + 20 || pack.compare(0, 4, "PACK") != 0)
+        fail("missing PACK header");
+    if (be32(pack, 4) != 2)
+        fail("unsupported pack version");
+    const std::uint32_t count = be32(pack, 8);
+
+    std::unordered_map<std::size_t, std::uint32_t> by_offset;
+    std::size_t pos = 12;
+    for (std::uint32_t n = 0; n < count; ++n) {
+        const std::size_t obj_offset = pos;
+        unsigned char c = static_cast<unsigned char>(pack[pos++]);
+        const unsigned raw_type = (c >> 4) & 7;
+        std::size_t size = c & 15;
+        int shift = 4;
+        while (c & 0x80) {
+            c = static_cast<unsigned char>(pack[pos++]);
+            size |= static_cast<std::size_t>(c & 0x7f) << shift;
+            shift += 7;
+        }
+
+        Object obj;
+        if (raw_type == 6) { // OFS_DELTA
+            c = static_cast<unsigned char>(pack[pos++]);
+            std::size_t off = c & 0x7f;
+            while (c & 0x80) {
+                c = static_cast<unsigned char>(pack[pos++]);
+                off = ((off + 1) << 7) | (c & 0x7f);
+            }
+            const auto base_it = by_offset.find(obj_offset - off);
+            if (base_it == by_offset.end())
+                fail("ofs-delta base not seen yet");
+            const Object& base = objects_[base_it->second];
+            obj.type = base.type;
+            obj.data =
+                apply_delta(base.data, inflate_into(pack, pos, size), arena_);
+        } else if (raw_type == 7) { // REF_DELTA
+            const std::string base_id(pack.substr(pos, 20));
+            pos += 20;
+            const auto base_it = object_by_oid_.find(base_id);
+            if (base_it == object_by_oid_.end())
+                fail("ref-delta base not in any added pack");
+            const Object& base = objects_[base_it->second];
+            obj.type = base.type;
+            obj.data =
+                apply_delta(base.data, inflate_into(pack, pos, size), arena_);
+        } else if (raw_type >= 1 && raw_type <= 4) {
+            obj.type = static_cast<std::uint8_t>(raw_type);
+            obj.data = inflate_into(pack, pos, size);
+        } else {
+            fail("unknown pack object type");
+        }
+
+        const std::uint32_t obj_index =
+            static_cast<std::uint32_t>(objects_.size());
+        const std::string oid = object_oid(obj.type, obj.data);
+        by_offset.emplace(obj_offset, obj_index);
+        object_by_oid_.emplace(oid, obj_index);
+        if (obj.type == 1) // commit
+            record_commit(oid_to_hex(oid, arena_), obj.data);
+        objects_.push_back(obj);
+    }
+    link_parents();
+}
+
+std::uint32_t PackIndex::find(std::string_view hex) const {
+    const auto it = commit_by_hex_.find(hex);
+    return it == commit_by_hex_.end() ? kMissingParent : it->second;
+}
+
+std::vector<std::uint32_t> PackIndex::history(std::uint32_t tip) const {
+    std::vector<std::uint32_t> out;
+    if (tip >= commits_.size())
+        return out;
+    std::vector<bool> seen(commits_.size(), false);
+    std::vector<std::uint32_t> stack{tip};
+    seen[tip] = true;
+    while (!stack.empty()) {
+        const std::uint32_t at = stack.back();
+        stack.pop_back();
+        out.push_back(at);
+        const CommitRecord& rec = commits_[at];
+        for (std::uint32_t p = 0; p < rec.parent_count; ++p) {
+            const std::uint32_t parent = parents_[rec.parent_begin + p];
+            if (parent == kMissingParent || seen[parent])
+                continue;
+            seen[parent] = true;
+            stack.push_back(parent);
+        }
+    }
+    std::sort(out.begin(), out.end(),
+              [this](std::uint32_t a, std::uint32_t b) {
+                  return commits_[a].commit_time > commits_[b].commit_time;
+              });
+    return out;
+}
+
+PackIndex::Cadence PackIndex::cadence(std::uint32_t tip,
+                                      std::int64_t final_window_s) const {
+    Cadence c;
+    const std::vector<std::uint32_t> hist = history(tip);
+    if (hist.empty())
+        return c;
+    c.total = hist.size();
+    c.last_time = commits_[hist.front()].commit_time;
+    c.first_time = commits_[hist.back()].commit_time;
+    for (std::uint32_t idx : hist) {
+        if (c.last_time - commits_[idx].commit_time > final_window_s)
+            break; // newest-first, so the rest are older still
+        ++c.final_window;
+    }
+    return c;
+}
+
+} // namespace intake
@@ -0,0 +1,1120 @@
+#include "intake/pdf_extractor.hpp"
+
+#include <zlib.h>
+
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "intake/mmap_file.hpp"
+#include "intake/trace.hpp"
+
+namespace intake {
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Object model and lexer. PDF bodies are small object graphs; the heavy
+// bytes live in streams, which we keep as offsets into the mapping and only
+// inflate on the page tasks.
+
+struct PdfRef {
+    std::uint32_t num = 0;
+    std::uint32_t gen = 0;
+};
+
+struct Obj {
+    enum class Kind : std::uint8_t {
+        Null, Bool, Number, String, Name, Array, Dict, Stream, Ref
+    };
+
+    Kind kind = Kind::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string text; // String payload or Name (no leading '/')
+    std::vector<Obj> array;
+    std::map<std::string, Obj, std::less<>> dict;
+    PdfRef ref;
+    std::size_t stream_off = 0; // raw stream bytes in the mapped file
+    std::size_t stream_len = 0;
+
+    bool is(Kind k) const { return kind == k; }
+    int as_int() const { return static_cast<int>(number); }
+    const Obj* find(std::string_view key) const {
+        auto it = dict.find(key);
+        return it == dict.end() ? nullptr : &it->second;
+    }
+};
+
+bool is_ws(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' ||
+           c == '\0';
+}
+
+bool is_delim(char c) {
+    return c == '(' || c == ')' || c == '<' || c == '>' || c == '[' ||
+           c == ']' || c == '{' || c == '}' || c == '/' || c == '%';
+}
+
+int hex_val(char c) {
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+class Lexer {
+public:
+    Lexer(std::string_view data, std::size_t pos) : s_(data), pos_(pos) {}
+
+    std::size_t pos() const { return pos_; }
+    void seek(std::size_t pos) { pos_ = pos; }
+    bool eof() const { return pos_ >= s_.size(); }
+
+    void skip_ws() {
+        while (pos_ < s_.size()) {
+            if (is_ws(s_[pos_])) {
+                ++pos_;
+            } else if (s_[pos_] == '%') {
+                while (pos_ < s_.size() && s_[pos_] != '\n' && s_[pos_] != '\r')
+                    ++pos_;
+            } else {
+                return;
+            }
+        }
+    }
+
+    // Bare token (operator or keyword); empty at a delimiter.
+    std::string_view token() {
+        skip_ws();
+        std::size_t start = pos_;
+        while (pos_ < s_.size() && !is_ws(s_[pos_]) && !is_delim(s_[pos_]))
+            ++pos_;
+        return s_.substr(start, pos_ - start);
+    }
+
+    bool match(std::string_view word) {
+        skip_ws();
+        if (s_.compare(pos_, word.size(), word) == 0) {
+            pos_ += word.size();
+            return true;
+        }
+        return false;
+    }
+
+    Obj parse();
+
+private:
+    Obj parse_string();
+    Obj parse_hex_string();
+    Obj parse_name();
+
+    std::string_view s_;
+    std::size_t pos_ = 0;
+};
+
+Obj Lexer::parse_string() {
+    Obj o;
+    o.kind = Obj::Kind::String;
+    ++pos_; // '('
+    int depth = 1;
+    while (pos_ < s_.size()) {
+        char c = s_[pos_++];
+        if (c == '\\') {
+            if (pos_ >= s_.size())
+                break;
+            char e = s_[pos_++];
+            switch (e) {
+            case 'n': o.text.push_back('\n'); break;
+            case 'r': o.text.push_back('\r'); break;
+            case 't': o.text.push_back('\t'); break;
+            case 'b': o.text.push_back('\b'); break;
+            case 'f': o.text.push_back('\f'); break;
+            case '\n': break; // line continuation
+            case '\r':
+                if (pos_ < s_.size() && s_[pos_] == '\n')
+                    ++pos_;
+                break;
+            default:
+                if (e >= '0' && e <= '7') {
+                    int v = e - '0';
+                    for (int i = 0; i < 2 && pos_ < s_.size() &&
+                                    s_[pos_] >= '0' && s_[pos_] <= '7'; ++i)
+                        v = v * 8 + (s_[pos_++] - '0');
+                    o.text.push_back(static_cast<char>(v));
+                } else {
+                    o.text.push_back(e); // covers \( \) \\ and unknowns
+                }
+            }
+        } else if (c == '(') {
+            ++depth;
+            o.text.push_back(c);
+        } else if (c == ')') {
+            if (--depth == 0)
+                return o;
+            o.text.push_back(c);
+        } else {
+            o.text.push_back(c);
+        }
+    }
+    return o;
+}
+
+Obj Lexer::parse_hex_string() {
+    Obj o;
+    o.kind = Obj::Kind::String;
+    ++pos_; // '<'
+    int hi = -1;
+    while (pos_ < s_.size() && s_[pos_] != '>') {
+        int v = hex_val(s_[pos_++]);
+        if (v < 0)
+            continue;
+        if (hi < 0) {
+            hi = v;
+        } else {
+            o.text.push_back(static_cast<char>(hi * 16 + v));
+            hi = -1;
+        }
+    }
+    if (hi >= 0)
+        o.text.push_back(static_cast<char>(hi * 16));
+    if (pos_ < s_.size())
+        ++pos_; // '>'
+    return o;
+}
+
+Obj Lexer::parse_name() {
+    Obj o;
+    o.kind = Obj::Kind::Name;
+    ++pos_; // '/'
+    while (pos_ < s_.size() && !is_ws(s_[pos_]) && !is_delim(s_[pos_])) {
+        char c = s_[pos_++];
+        if (c == '#' && pos_ + 1 < s_.size()) {
+            int a = hex_val(s_[pos_]), b = hex_val(s_[pos_ + 1]);
+            if (a >= 0 && b >= 0) {
+                c = static_cast<char>(a * 16 + b);
+                pos_ += 2;
+            }
+        }
+        o.text.push_back(c);
+    }
+    return o;
+}
+
+Obj Lexer::parse() {
+    skip_ws();
+    if (eof())
+        return {};
+    char c = s_[pos_];
+    if (c == '/')
+        return parse_name();
+    if (c == '(')
+        return parse_string();
+    if (c == '<') {
+        if (pos_ + 1 < s_.size() && s_[pos_ + 1] == '<') {
+            pos_ += 2;
+            Obj o;
+            o.kind = Obj::Kind::Dict;
+            while (true) {
+                skip_ws();
+                if (eof())
+                    break;
+                if (s_.compare(pos_, 2, ">>") == 0) {
+                    pos_ += 2;
+                    break;
+                }
+                if (s_[pos_] != '/') { // malformed key; bail out of the dict
+                    ++pos_;
+                    continue;
+                }
+                Obj key = parse_name();
+                o.dict[std::move(key.text)] = parse();
+            }
+            return o;
+        }
+        return parse_hex_string();
+    }
+    if (c == '[') {
+        ++pos_;
+        Obj o;
+        o.kind = Obj::Kind::Array;
+        while (true) {
+            skip_ws();
+            if (eof() || s_[pos_] == ']') {
+                if (!eof())
+                    ++pos_;
+                break;
+            }
+            o.array.push_back(parse());
+        }
+        return o;
+    }
+    if (c == '+' || c == '-' || c == '.' || (c >= '0' && c <= '9')) {
+        std::size_t start = pos_;
+        while (pos_ < s_.size() &&
+               (s_[pos_] == '+' || s_[pos_] == '-' || s_[pos_] == '.' ||
+                (s_[pos_] >= '0' && s_[pos_] <= '9')))
+            ++pos_;
+        Obj o;
+        o.kind = Obj::Kind::Number;
+        char buf[32];
+        std::size_t n = std::min(pos_ - start, sizeof(buf) - 1);
+        memcpy(buf, s_.data() + start, n);
+        buf[n] = '\0';
+        o.number = std::strtod(buf, nullptr);
+
+        // "num gen R" is an indirect reference; try the lookahead.
+        std::size_t save = pos_;
+        skip_ws();
+        std::size_t gen_start = pos_;
+        while (pos_ < s_.size() && s_[pos_] >= '0' && s_[pos_] <= '9')
+            ++pos_;
+        if (pos_ > gen_start) {
+            std::size_t gen_end = pos_;
+            skip_ws();
+            if (pos_ < s_.size() && s_[pos_] == 'R' &&
+                (pos_ + 1 >= s_.size() || is_ws(s_[pos_ + 1]) ||
+                 is_delim(s_[pos_ + 1]))) {
+                ++pos_;
+                Obj r;
+                r.kind = Obj::Kind::Ref;
+                r.ref.num = static_cast<std::uint32_t>(o.number);
+                r.ref.gen = static_cast<std::uint32_t>(
+                    std::strtoul(std::string(s_.substr(gen_start,
+                                                       gen_end - gen_start))
+                                     .c_str(),
+                                 nullptr, 10));
+                return r;
+            }
+        }
+        pos_ = save;
+        return o;
+    }
+    // Keyword.
+    std::string_view t = token();
+    Obj o;
+    if (t == "true") {
+        o.kind = Obj::Kind::Bool;
+        o.boolean = true;
+    } else if (t == "false") {
+        o.kind = Obj::Kind::Bool;
+        o.boolean = false;
+    } else if (t.empty()) {
+        ++pos_; // unexpected delimiter; skip so callers make progress
+    }
+    return o; // "null" and unknown keywords land here as Null
+}
+
+// ---------------------------------------------------------------------------
+// Inflation helpers.
+
+void inflate_zlib(const unsigned char* src, std::size_t len,
+                  std::vector<unsigned char>& out) {
+    out.clear();
+    out.resize(std::max<std::size_t>(len * 4, 4096));
+    z_stream zs{};
+    // 15 + 32: accept zlib or gzip wrapping, which covers PDF FlateDecode.
+    if (inflateInit2(&zs, 15 + 32) != Z_OK)
+        throw std::runtime_error("pdf: inflateInit failed");
+    zs.next_in = const_cast<unsigned char*>(src);
+    zs.avail_in = static_cast<uInt>(len);
+    std::size_t written = 0;
+    int rc = Z_OK;
+    while (rc != Z_STREAM_END) {
+        if (written == out.size())
+            out.resize(out.size() * 2);
+        zs.next_out = out.data() + written;
+        zs.avail_out = static_cast<uInt>(out.size() - written);
+        rc = inflate(&zs, Z_NO_FLUSH);
+        written = out.size() - zs.avail_out;
+        if (rc == Z_BUF_ERROR && zs.avail_in == 0)
+            break; // truncated stream: keep what we got
+        if (rc != Z_OK && rc != Z_STREAM_END) {
+            inflateEnd(&zs);
+            throw std::runtime_error("pdf: inflate failed");
+        }
+    }
+    inflateEnd(&zs);
+    out.resize(written);
+}
+
+// PNG-style predictor used by xref streams (/Predictor >= 10).
+void undo_png_predictor(std::vector<unsigned char>& data, std::size_t columns) {
+    const std::size_t stride = columns + 1;
+    std::vector<unsigned char> out;
+    out.reserve(data.size());
+    std::vector<unsigned char> prev(columns, 0);
+    for (std::size_t row = 0; row + stride <= data.size() + stride - 1 &&
+                              row * stride < data.size();
+         ++row) {
+        const std::size_t base = row * stride;
+        if (base + 1 > data.size())
+            break;
+        const unsigned char tag = data[base];
+        const std::size_t avail =
+            std::min(columns, data.size() - base - 1);
+        std::vector<unsigned char> cur(columns, 0);
+        for (std::size_t i = 0; i < avail; ++i) {
+            unsigned char raw = data[base + 1 + i];
+            unsigned char left = i > 0 ? cur[i - 1] : 0;
+            unsigned char up = prev[i];
+            switch (tag) {
+            case 0: cur[i] = raw; break;
+            case 1: cur[i] = static_cast<unsigned char>(raw + left); break;
+            case 2: cur[i] = static_cast<unsigned char>(raw + up); break;
+            case 3:
+                cur[i] = static_cast<unsigned char>(raw + ((left + up) >> 1));
+                break;
+            case 4: { // Paeth
+                int upleft = i > 0 ? prev[i - 1] : 0;
+                int p = left + up - upleft;
+                int pa = std::abs(p - left), pb = std::abs(p - up),
+                    pc = std::abs(p - upleft);
+                int pred =
+                    (pa <= pb && pa <= pc) ? left : (pb <= pc ? up : upleft);
+                cur[i] = static_cast<unsigned char>(raw + pred);
+                break;
+            }
+            default: cur[i] = raw; break;
+            }
+        }
+        out.insert(out.end(), cur.begin(), cur.end());
+        prev = cur;
+        if (avail < columns)
+            break;
+    }
+    data = std::move(out);
+}
+
+// ---------------------------------------------------------------------------
+// Document: xref resolution and object access. Built single-threaded in the
+// document task; page tasks only read their own pre-gathered inputs.
+
+struct XrefEntry {
+    std::uint8_t type = 0;  // 1 = at offset, 2 = inside object stream
+    std::uint64_t a = 0;    // offset, or object-stream number
+    std::uint32_t b = 0;    // index within the object stream
+};
+
+class Document {
+public:
+    explicit Document(const std::string& path) : map_(path), data_(map_.view()) {
+        if (!data_.starts_with("%PDF-"))
+            throw std::runtime_error("pdf: missing header");
+        parse_xref_chain();
+    }
+
+    const Obj& get(std::uint32_t num);
+    const Obj& resolve(const Obj& o) {
+        const Obj* p = &o;
+        for (int i = 0; i < 32 && p->is(Obj::Kind::Ref); ++i)
+            p = &get(p->ref.num);
+        return *p;
+    }
+
+    // Inflated stream payload (FlateDecode or raw). Returns false for
+    // filters we do not handle (images etc.).
+    bool stream_data(const Obj& stream, std::vector<unsigned char>& out);
+
+    // Raw (still compressed) bytes plus whether they are Flate-compressed;
+    // page tasks use this to inflate off the document thread.
+    struct RawStream {
+        const unsigned char* data = nullptr;
+        std::size_t len = 0;
+        bool flate = false;
+        bool supported = true;
+    };
+    RawStream raw_stream(const Obj& stream) const;
+
+    const Obj& trailer() const { return trailer_; }
+    std::string_view bytes() const { return data_; }
+
+private:
+    void parse_xref_chain();
+    void parse_classic_xref(Lexer& lex, std::set<std::uint64_t>& visited,
+                            std::vector<std::uint64_t>& todo);
+    void parse_xref_stream(std::uint64_t offset,
+                           std::vector<std::uint64_t>& todo);
+    Obj parse_indirect_at(std::uint64_t offset);
+    const Obj& get_from_objstm(const XrefEntry& e, std::uint32_t num);
+
+    MmapFile map_;
+    std::string_view data_;
+    std::unordered_map<std::uint32_t, XrefEntry> xref_;
+    Obj trailer_;
+    std::unordered_map<std::uint32_t, Obj> cache_;
+    struct ObjStm {
+        std::vector<unsigned char> bytes;
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> index; // num, off
+        std::size_t first = 0;
+    };
+    std::unordered_map<std::uint32_t, ObjStm> objstms_;
+    static const Obj null_obj_;
+};
+
+const Obj Document::null_obj_{};
+
+void Document::parse_xref_chain() {
+    // startxref lives in the last KB of the file.
+    std::size_t sx = data_.rfind("startxref");
+    if (sx == std::string_view::npos)
+        throw std::runtime_error("pdf: startxref not found");
+    Lexer lex(data_, sx + 9);
+    Obj off = lex.parse();
+    if (!off.is(Obj::Kind::Number))
+        throw std::runtime_error("pdf: bad startxref");
+
+    std::set<std::uint64_t> visited;
+    std::vector<std::uint64_t> todo{static_cast<std::uint64_t>(off.number)};
+    while (!todo.empty()) {
+        std::uint64_t at = todo.back();
+        todo.pop_back();
+        if (at >= data_.size() || !visited.insert(at).second)
+            continue;
+        Lexer x(data_, at);
+        if (x.match("xref"))
+            parse_classic_xref(x, visited, todo);
+        else
+            parse_xref_stream(at, todo);
+    }
+    if (trailer_.find("Root") == nullptr)
+        throw std::runtime_error("pdf: no /Root in trailer");
+}
+
+void Document::parse_classic_xref(Lexer& lex, std::set<std::uint64_t>&,
+                                  std::vector<std::uint64_t>& todo) {
+    while (true) {
+        if (lex.match("trailer")) {
+            Obj t = lex.parse();
+            for (auto& [k, v] : t.dict)
+                trailer_.dict.try_emplace(k, std::move(v)); // newest wins
+            trailer_.kind = Obj::Kind::Dict;
+            if (const Obj* prev = trailer_.find("Prev");
+                prev != nullptr && prev->is(Obj::Kind::Number)) {
+                todo.push_back(static_cast<std::uint64_t>(prev->number));
+                trailer_.dict.erase("Prev"); // each section consumes its own
+            }
+            if (const Obj* hx = trailer_.find("XRefStm");
+                hx != nullptr && hx->is(Obj::Kind::Number)) {
+                todo.push_back(static_cast<std::uint64_t>(hx->number));
+                trailer_.dict.erase("XRefStm");
+            }
+            return;
+        }
+        Obj start = lex.parse();
+        Obj count = lex.parse();
+        if (!start.is(Obj::Kind::Number) || !count.is(Obj::Kind::Number))
+            return; // malformed section
+        for (int i = 0; i < count.as_int(); ++i) {
+            lex.skip_ws();
+            const std::size_t p = lex.pos();
+            if (p + 18 > bytes().size())
+                return;
+            const std::string_view entry = bytes().substr(p, 18);
+            lex.seek(p + 18);
+            const char kind = entry[17];
+            const std::uint32_t num =
+                static_cast<std::uint32_t>(start.as_int() + i);
+            if (kind == 'n' && xref_.find(num) == xref_.end()) {
+                XrefEntry e;
+                e.type = 1;
+                e.a = std::strtoull(std::string(entry.substr(0, 10)).c_str(),
+                                    nullptr, 10);
+                xref_[num] = e;
+            }
+        }
+    }
+}
+
+void Document::parse_xref_stream(std::uint64_t offset,
+                                 std::vector<std::uint64_t>& todo) {
+    Obj stream = parse_indirect_at(offset);
+    if (!stream.is(Obj::Kind::Stream))
+        throw std::runtime_error("pdf: expected xref stream");
+    std::vector<unsigned char> data;
+    if (!stream_data(stream, data))
+        throw std::runtime_error("pdf: unsupported xref stream filter");
+
+    const Obj* w = stream.find("W");
+    if (w == nullptr || !w->is(Obj::Kind::Array) || w->array.size() < 3)
+        throw std::runtime_error("pdf: xref stream missing /W");
+    const std::size_t w0 = static_cast<std::size_t>(w->array[0].as_int());
+    const std::size_t w1 = static_cast<std::size_t>(w->array[1].as_int());
+    const std::size_t w2 = static_cast<std::size_t>(w->array[2].as_int());
+    const std::size_t rec = w0 + w1 + w2;
+
+    // /Index defaults to [0 Size].
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> ranges;
+    if (const Obj* idx = stream.find("Index");
+        idx != nullptr && idx->is(Obj::Kind::Array)) {
+        for (std::size_t i = 0; i + 1 < idx->array.size(); i += 2)
+            ranges.emplace_back(idx->array[i].as_int(),
+                                idx->array[i + 1].as_int());
+    } else if (const Obj* size = stream.find("Size"); size != nullptr) {
+        ranges.emplace_back(0, size->as_int());
+    }
+
+    auto read_field = [](const unsigned char* p, std::size_t n,
+                         std::uint64_t dflt) -> std::uint64_t {
+        if (n == 0)
+            return dflt;
+        std::uint64_t v = 0;
+        for (std::size_t i = 0; i < n; ++i)
+            v = (v << 8) | p[i];
+        return v;
+    };
+
+    std::size_t at = 0;
+    for (auto [start, count] : ranges) {
+        for (std::uint32_t i = 0; i < count && at + rec <= data.size();
+             ++i, at += rec) {
+            const unsigned char* p = data.data() + at;
+            const std::uint64_t type = read_field(p, w0, 1);
+            const std::uint64_t f2 = read_field(p + w0, w1, 0);
+            const std::uint64_t f3 = read_field(p + w0 + w1, w2, 0);
+            const std::uint32_t num = start + i;
+            if ((type == 1 || type == 2) && xref_.find(num) == xref_.end()) {
+                XrefEntry e;
+                e.type = static_cast<std::uint8_t>(type);
+                e.a = f2;
+                e.b = static_cast<std::uint32_t>(f3);
+                xref_[num] = e;
+            }
+        }
+    }
+
+    for (auto& [k, v] : stream.dict)
+        if (k != "Prev")
+            trailer_.dict.try_emplace(k, v);
+    trailer_.kind = Obj::Kind::Dict;
+    if (const Obj* prev = stream.find("Prev");
+        prev != nullptr && prev->is(Obj::Kind::Number))
+        todo.push_back(static_cast<std::uint64_t>(prev->number));
+}
+
+Obj Document::parse_indirect_at(std::uint64_t offset) {
+    Lexer lex(data_, offset);
+    Obj num = lex.parse();
+    Obj gen = lex.parse();
+    if (!num.is(Obj::Kind::Number) || !gen.is(Obj::Kind::Number) ||
+        !lex.match("obj"))
+        throw std::runtime_error("pdf: malformed indirect object");
+    Obj o = lex.parse();
+    if (o.is(Obj::Kind::Dict) && lex.match("stream")) {
+        // EOL after the keyword, then /Length raw bytes.
+        std::size_t p = lex.pos();
+        if (p < data_.size() && data_[p] == '\r')
+            ++p;
+        if (p < data_.size() && data_[p] == '\n')
+            ++p;
+        const Obj* len_obj = o.find("Length");
+        std::size_t len = 0;
+        if (len_obj != nullptr) {
+            const Obj& resolved = resolve(*len_obj);
+            if (resolved.is(Obj::Kind::Number))
+                len = static_cast<std::size_t>(resolved.number);
+        }
+        if (len == 0 || p + len > data_.size()) {
+            // Broken /Length: scan for endstream.
+            std::size_t e = data_.find("endstream", p);
+            len = e == std::string_view::npos ? 0 : e - p;
+        }
+        o.kind = Obj::Kind::Stream;
+        o.stream_off = p;
+        o.stream_len = len;
+    }
+    return o;
+}
+
+Document::RawStream Document::raw_stream(const Obj& stream) const {
+    RawStream r;
+    r.data = reinterpret_cast<const unsigned char*>(data_.data()) +
+             stream.stream_off;
+    r.len = stream.stream_len;
+    const Obj* filter = stream.find("Filter");
+    if (filter == nullptr) {
+        r.flate = false;
+    } else if (filter->is(Obj::Kind::Name)) {
+        if (filter->text == "FlateDecode")
+            r.flate = true;
+        else
+            r.supported = false;
+    } else if (filter->is(Obj::Kind::Array)) {
+        if (filter->array.size() == 1 &&
+            filter->array[0].is(Obj::Kind::Name) &&
+            filter->array[0].text == "FlateDecode")
+            r.flate = true;
+        else if (!filter->array.empty())
+            r.supported = false;
+    }
+    return r;
+}
+
+bool Document::stream_data(const Obj& stream, std::vector<unsigned char>& out) {
+    RawStream r = raw_stream(stream);
+    if (!r.supported)
+        return false;
+    if (r.flate)
+        inflate_zlib(r.data, r.len, out);
+    else
+        out.assign(r.data, r.data + r.len);
+
+    if (const Obj* parms = stream.find("DecodeParms");
+        parms != nullptr && parms->is(Obj::Kind::Dict)) {
+        const Obj* pred = parms->find("Predictor");
+        if (pred != nullptr && pred->as_int() >= 10) {
+            const Obj* cols = parms->find("Columns");
+            undo_png_predictor(out, cols != nullptr
+                                        ? static_cast<std::size_t>(cols->as_int())
+                                        : 1);
+        }
+    }
+    return true;
+}
+
+const Obj& Document::get_from_objstm(const XrefEntry& e, std::uint32_t num) {
+    const std::uint32_t stm_num = static_cast<std::uint32_t>(e.a);
+    auto it = objstms_.find(stm_num);
+    if (it == objstms_.end()) {
+        ObjStm stm;
+        const Obj& container = get(stm_num);
+        if (!container.is(Obj::Kind::Stream) ||
+            !stream_data(container, stm.bytes))
+            return null_obj_;
+        const Obj* n = container.find("N");
+        const Obj* first = container.find("First");
+        if (n == nullptr || first == nullptr)
+            return null_obj_;
+        stm.first = static_cast<std::size_t>(first->as_int());
+        std::string_view body(reinterpret_cast<const char*>(stm.bytes.data()),
+                              stm.bytes.size());
+        Lexer hdr(body, 0);
+        for (int i = 0; i < n->as_int(); ++i) {
+            Obj onum = hdr.parse();
+            Obj ooff = hdr.parse();
+            if (!onum.is(Obj::Kind::Number) || !ooff.is(Obj::Kind::Number))
+                break;
+            stm.index.emplace_back(onum.as_int(), ooff.as_int());
+        }
+        it = objstms_.emplace(stm_num, std::move(stm)).first;
+    }
+
+    const ObjStm& stm = it->second;
+    for (auto [onum, ooff] : stm.index) {
+        if (onum == num) {
+            std::string_view body(
+                reinterpret_cast<const char*>(stm.bytes.data()),
+                stm.bytes.size());
+            Lexer lex(body, stm.first + ooff);
+            return cache_.emplace(num, lex.parse()).first->second;
+        }
+    }
+    return null_obj_;
+}
+
+const Obj& Document::get(std::uint32_t num) {
+    auto cached = cache_.find(num);
+    if (cached != cache_.end())
+        return cached->second;
+    auto entry = xref_.find(num);
+    if (entry == xref_.end())
+        return null_obj_;
+    if (entry->second.type == 2)
+        return get_from_objstm(entry->second, num);
+    Obj o = parse_indirect_at(entry->second.a);
+    return cache_.emplace(num, std::move(o)).first->second;
+}
+
+// ---------------------------------------------------------------------------
+// Text decoding: /ToUnicode CMaps and the content-stream interpreter.
+
+struct FontMap {
+    bool present = false;
+    int code_bytes = 1;
+    std::unordered_map<std::uint32_t, std::string> to_unicode;
+};
+
+void append_utf8(std::string& out, std::uint32_t cp) {
+    if (cp < 0x80) {
+        out.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+// The CMap's destination strings are UTF-16BE.
+std::string utf16be_to_utf8(std::string_view s) {
+    std::string out;
+    for (std::size_t i = 0; i + 1 < s.size(); i += 2) {
+        std::uint32_t u = (static_cast<unsigned char>(s[i]) << 8) |
+                          static_cast<unsigned char>(s[i + 1]);
+        if (u >= 0xD800 && u < 0xDC00 && i + 3 < s.size()) {
+            std::uint32_t lo = (static_cast<unsigned char>(s[i + 2]) << 8) |
+                               static_cast<unsigned char>(s[i + 3]);
+            if (lo >= 0xDC00 && lo < 0xE000) {
+                u = 0x10000 + ((u - 0xD800) << 10) + (lo - 0xDC00);
+                i += 2;
+            }
+        }
+        append_utf8(out, u);
+    }
+    return out;
+}
+
+std::uint32_t code_of(std::string_view bytes) {
+    std::uint32_t v = 0;
+    for (char c : bytes)
+        v = (v << 8) | static_cast<unsigned char>(c);
+    return v;
+}
+
+FontMap parse_tounicode(std::string_view cmap) {
+    FontMap fm;
+    fm.present = true;
+    Lexer lex(cmap, 0);
+    std::vector<Obj> operands;
+    while (!lex.eof()) {
+        lex.skip_ws();
+        if (lex.eof())
+            break;
+        char c = cmap[lex.pos()];
+        if (c == '<' || c == '(' || c == '[' || c == '/' || c == '+' ||
+            c == '-' || c == '.' || (c >= '0' && c <= '9')) {
+            operands.push_back(lex.parse());
+            continue;
+        }
+        std::string_view op = lex.token();
+        if (op.empty()) {
+            lex.seek(lex.pos() + 1);
+            continue;
+        }
+        if (op == "endcodespacerange") {
+            if (!operands.empty() && operands[0].is(Obj::Kind::String))
+                fm.code_bytes =
+                    std::max<int>(1, static_cast<int>(operands[0].text.size()));
+        } else if (op == "endbfchar") {
+            for (std::size_t i = 0; i + 1 < operands.size(); i += 2) {
+                if (operands[i].is(Obj::Kind::String) &&
+                    operands[i + 1].is(Obj::Kind::String)) {
+                    fm.code_bytes = std::max<int>(
+                        fm.code_bytes,
+                        static_cast<int>(operands[i].text.size()));
+                    fm.to_unicode[code_of(operands[i].text)] =
+                        utf16be_to_utf8(operands[i + 1].text);
+                }
+            }
+        } else if (op == "endbfrange") {
+            for (std::size_t i = 0; i + 2 < operands.size(); i += 3) {
+                if (!operands[i].is(Obj::Kind::String) ||
+                    !operands[i + 1].is(Obj::Kind::String))
+                    continue;
+                const std::uint32_t lo = code_of(operands[i].text);
+                const std::uint32_t hi = code_of(operands[i + 1].text);
+                if (hi - lo > 65535)
+                    continue;
+                fm.code_bytes = std::max<int>(
+                    fm.code_bytes, static_cast<int>(operands[i].text.size()));
+                const Obj& dst = operands[i + 2];
+                if (dst.is(Obj::Kind::String)) {
+                    std::string base = dst.text;
+                    for (std::uint32_t code = lo; code <= hi; ++code) {
+                        fm.to_unicode[code] = utf16be_to_utf8(base);
+                        // increment the last UTF-16 unit
+                        for (std::size_t b = base.size(); b >= 2; b -= 2) {
+                            if (++reinterpret_cast<unsigned char&>(
+                                    base[b - 1]) != 0)
+                                break;
+                            ++reinterpret_cast<unsigned char&>(base[b - 2]);
+                            break;
+                        }
+                    }
+                } else if (dst.is(Obj::Kind::Array)) {
+                    for (std::uint32_t code = lo;
+                         code <= hi && code - lo < dst.array.size(); ++code)
+                        if (dst.array[code - lo].is(Obj::Kind::String))
+                            fm.to_unicode[code] =
+                                utf16be_to_utf8(dst.array[code - lo].text);
+                }
+            }
+        }
+        if (op.starts_with("end") || op.starts_with("begin"))
+            operands.clear();
+    }
+    return fm;
+}
+
+using FontTable = std::map<std::string, FontMap, std::less<>>;
+
+void decode_string(const std::string& bytes, const FontMap* font,
+                   std::string& out) {
+    if (font != nullptr && font->present && !font->to_unicode.empty()) {
+        const int step = font->code_bytes;
+        for (std::size_t i = 0; i + step <= bytes.size();
+             i += static_cast<std::size_t>(step)) {
+            const std::uint32_t code =
+                code_of(std::string_view(bytes).substr(i, step));
+            auto it = font->to_unicode.find(code);
+            if (it != font->to_unicode.end())
+                out.append(it->second);
+            else if (step == 1 && code >= 0x20 && code < 0x7F)
+                out.push_back(static_cast<char>(code));
+        }
+        return;
+    }
+    // No map: assume text bytes (covers the simple-font producers).
+    for (char c : bytes) {
+        const unsigned char u = static_cast<unsigned char>(c);
+        if (u >= 0x20 || c == '\n' || c == '\t')
+            out.push_back(c);
+    }
+}
+
+void run_content(std::string_view content, const FontTable& fonts,
+                 std::string& out) {
+    Lexer lex(content, 0);
+    std::vector<Obj> operands;
+    const FontMap* cur_font = nullptr;
+
+    auto newline = [&out] {
+        if (!out.empty() && out.back() != '\n')
+            out.push_back('\n');
+    };
+    auto emit = [&](const Obj& o) {
+        if (o.is(Obj::Kind::String))
+            decode_string(o.text, cur_font, out);
+    };
+
+    while (!lex.eof()) {
+        lex.skip_ws();
+        if (lex.eof())
+            break;
+        const char c = content[lex.pos()];
+        if (c == '<' || c == '(' || c == '[' || c == '/' || c == '+' ||
+            c == '-' || c == '.' || (c >= '0' && c <= '9')) {
+            if (operands.size() < 64)
+                operands.push_back(lex.parse());
+            else
+                lex.parse();
+            continue;
+        }
+        std::string_view op = lex.token();
+        if (op.empty()) {
+            lex.seek(lex.pos() + 1);
+            continue;
+        }
+        if (op == "Tf") {
+            cur_font = nullptr;
+            if (operands.size() >= 2 && operands[0].is(Obj::Kind::Name)) {
+                auto it = fonts.find(operands[0].text);
+                if (it != fonts.end())
+                    cur_font = &it->second;
+            }
+        } else if (op == "Tj") {
+            if (!operands.empty())
+                emit(operands.back());
+        } else if (op == "'") {
+            newline();
+            if (!operands.empty())
+                emit(operands.back());
+        } else if (op == "\"") {
+            newline();
+            if (!operands.empty())
+                emit(operands.back());
+        } else if (op == "TJ") {
+            if (!operands.empty() && operands.back().is(Obj::Kind::Array)) {
+                for (const Obj& el : operands.back().array) {
+                    if (el.is(Obj::Kind::String))
+                        emit(el);
+                    else if (el.is(Obj::Kind::Number) && el.number < -150 &&
+                             !out.empty() && out.back() != ' ' &&
+                             out.back() != '\n')
+                        out.push_back(' ');
+                }
+            }
+        } else if (op == "Td" || op == "TD") {
+            // Only a vertical displacement is a line break; producers that
+            // position every glyph emit zero-ty Td moves mid-line.
+            if (operands.size() >= 2 &&
+                operands.back().is(Obj::Kind::Number) &&
+                operands.back().number != 0.0)
+                newline();
+        } else if (op == "T*" || op == "ET") {
+            newline();
+        } else if (op == "BI") {
+            // Inline image: skip to EI so binary data never hits the lexer.
+            std::size_t ei = content.find("EI", lex.pos());
+            lex.seek(ei == std::string_view::npos ? content.size() : ei + 2);
+        }
+        operands.clear();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Page gathering and the extraction driver.
+
+struct PageInput {
+    std::uint32_t page = 0;
+    std::vector<Document::RawStream> parts;
+    std::shared_ptr<FontTable> fonts;
+};
+
+void collect_pages(Document& doc, const Obj& node, const Obj* inherited_res,
+                   std::vector<PageInput>& out, int depth);
+
+std::shared_ptr<FontTable> build_fonts(Document& doc, const Obj* res) {
+    auto table = std::make_shared<FontTable>();
+    if (res == nullptr)
+        return table;
+    const Obj& resources = doc.resolve(*res);
+    const Obj* fonts = resources.find("Font");
+    if (fonts == nullptr)
+        return table;
+    const Obj& font_dict = doc.resolve(*fonts);
+    std::vector<unsigned char> buf;
+    for (const auto& [name, ref] : font_dict.dict) {
+        const Obj& font = doc.resolve(ref);
+        const Obj* tu = font.find("ToUnicode");
+        if (tu == nullptr)
+            continue;
+        const Obj& stream = doc.resolve(*tu);
+        if (!stream.is(Obj::Kind::Stream) || !doc.stream_data(stream, buf))
+            continue;
+        (*table)[name] = parse_tounicode(
+            std::string_view(reinterpret_cast<const char*>(buf.data()),
+                             buf.size()));
+    }
+    return table;
+}
+
+void collect_pages(Document& doc, const Obj& node, const Obj* inherited_res,
+                   std::vector<PageInput>& out, int depth) {
+    if (depth > 64)
+        return;
+    const Obj* type = node.find("Type");
+    const Obj* res = node.find("Resources");
+    if (res == nullptr)
+        res = inherited_res;
+
+    if (type != nullptr && type->is(Obj::Kind::Name) && type->text == "Page") {
+        PageInput pi;
+        pi.page = static_cast<std::uint32_t>(out.size() + 1);
+        pi.fonts = build_fonts(doc, res);
+        if (const Obj* contents = node.find("Contents")) {
+            const Obj& c = doc.resolve(*contents);
+            if (c.is(Obj::Kind::Stream)) {
+                pi.parts.push_back(doc.raw_stream(c));
+            } else if (c.is(Obj::Kind::Array)) {
+                for (const Obj& el : c.array) {
+                    const Obj& part = doc.resolve(el);
+                    if (part.is(Obj::Kind::Stream))
+                        pi.parts.push_back(doc.raw_stream(part));
+                }
+            }
+        }
+        out.push_back(std::move(pi));
+        return;
+    }
+    if (const Obj* kids = node.find("Kids")) {
+        const Obj& arr = doc.resolve(*kids);
+        for (const Obj& kid : arr.array)
+            collect_pages(doc, doc.resolve(kid), res, out, depth + 1);
+    }
+}
+
+} // namespace
+
+void PdfExtractor::extract_file(const std::string& path,
+                                const PageCallback& cb) {
+    INTAKE_TRACE_SCOPE("pdf.extract_file");
+    Document doc(path);
+    const Obj& root = doc.resolve(*doc.trailer().find("Root"));
+    const Obj* pages_ref = root.find("Pages");
+    if (pages_ref == nullptr)
+        throw std::runtime_error("pdf: catalog has no /Pages");
+
+    std::vector<PageInput> pages;
+    collect_pages(doc, doc.resolve(*pages_ref), nullptr, pages, 0);
+
+    // Pages inflate and decode as independent tasks; the document (and its
+    // mapping) stays alive until every page has reported in.
+    std::atomic<std::size_t> remaining(pages.size());
+    for (PageInput& pi : pages) {
+        pool_.submit([&pi, &cb, &remaining] {
+            std::string text;
+            std::vector<unsigned char> buf;
+            for (const Document::RawStream& part : pi.parts) {
+                if (!part.supported)
+                    continue;
+                try {
+                    std::string_view body;
+                    if (part.flate) {
+                        inflate_zlib(part.data, part.len, buf);
+                        body = std::string_view(
+                            reinterpret_cast<const char*>(buf.data()),
+                            buf.size());
+                    } else {
+                        body = std::string_view(
+                            reinterpret_cast<const char*>(part.data),
+                            part.len);
+                    }
+                    run_content(body, *pi.fonts, text);
+                } catch (const std::exception&) {
+                    // Corrupt part: keep whatever earlier parts produced.
+                }
+            }
+            cb(pi.page, text);
+            remaining.fetch_sub(1, std::memory_order_acq_rel);
+        });
+    }
+    while (remaining.load(std::memory_order_acquire) != 0)
+        if (!pool_.try_run_one())
+            std::this_thread::yield();
+}
+
+void PdfExtractor::extract_batch(std::span<const std::string> paths,
+                                 const BatchCallback& cb,
+                                 const ErrorCallback& on_error) {
+    std::atomic<std::size_t> remaining(paths.size());
+    for (const std::string& path : paths) {
+        pool_.submit([this, &path, &cb, &on_error, &remaining] {
+            try {
+                extract_file(path, [&](std::uint32_t page,
+                                       std::string_view text) {
+                    cb(path, page, text);
+                });
+            } catch (const std::exception& e) {
+                if (on_error)
+                    on_error(path, e.what());
+            }
+            remaining.fetch_sub(1, std::memory_order_acq_rel);
+        });
+    }
+    while (remaining.load(std::memory_order_acquire) != 0)
+        if (!pool_.try_run_one())
+            std::this_thread::yield();
+}
+
+} // namespace intake
@@ -0,0 +1,88 @@
+#include "intake/pipeline.hpp"
+
+#include <filesystem>
+#include <mutex>
+
+namespace fs = std::filesystem;
+
+namespace intake {
+
+Scheduler::TaskId IntakePipeline::enqueue(ForkRef fork, DoneFn on_done) {
+    auto outcome = std::make_shared<SubmissionOutcome>();
+    outcome->fork = std::move(fork);
+
+    // Stage 1a: write the submission's PDFs through the blob store. Runs in
+    // parallel with validation; dedup means a re-pushed deck costs a hash.
+    Scheduler::TaskId hash_task = scheduler_.submit([this, outcome] {
+        std::error_code ec;
+        const fs::path root(outcome->fork.root);
+        auto store_pdf = [&](const fs::path& p) {
+            try {
+                outcome->stored_pdfs.push_back(blobs_.put_file(p.string()));
+            } catch (const std::exception&) {
+                // unreadable blob: validation will report the real problem
+            }
+        };
+        for (fs::directory_iterator it(root, ec), end; !ec && it != end;
+             it.increment(ec))
+            if (it->is_regular_file(ec) && it->path().extension() == ".pdf")
+                store_pdf(it->path());
+        for (fs::directory_iterator it(root / "pitch", ec), end;
+             !ec && it != end; it.increment(ec))
+            if (it->is_regular_file(ec) && it->path().extension() == ".pdf")
+                store_pdf(it->path());
+    });
+
+    // Stage 1b: incremental validation (hash-diff against the last run).
+    Scheduler::TaskId validate_task = scheduler_.submit([this, outcome] {
+        try {
+            outcome->delta = validator_.revalidate(outcome->fork);
+        } catch (const std::exception& e) {
+            outcome->error = e.what();
+        }
+    });
+
+    // Stage 2: canvas extraction, gated on the validation delta so a
+    // byte-identical canvas re-push skips the parse entirely.
+    Scheduler::TaskId extract_task = scheduler_.submit_after(
+        {{validate_task}}, [this, outcome] {
+            if (!outcome->error.empty())
+                return;
+            if (!outcome->delta.canvas_changed)
+                return; // canvas untouched (covers the no-op push too: an
+                        // unchanged tree never sets it, and a first run
+                        // always does via the empty previous manifest)
+            std::error_code ec;
+            const fs::path root(outcome->fork.root);
+            for (fs::directory_iterator it(root, ec), end; !ec && it != end;
+                 it.increment(ec)) {
+                if (!it->is_regular_file(ec) ||
+                    it->path().extension() != ".pdf")
+                    continue;
+                std::mutex mu;
+                try {
+                    extractor_.extract_file(
+                        it->path().string(),
+                        [&](std::uint32_t page, std::string_view text) {
+                            std::lock_guard<std::mutex> lk(mu);
+                            outcome->canvas_pages.emplace_back(
+                                page, std::string(text));
+                        });
+                } catch (const std::exception& e) {
+                    outcome->error =
+                        "canvas extraction failed: " + std::string(e.what());
+                }
+                break; // one canvas per fork root
+            }
+        });
+
+    // Stage 3: completion once both branches are in.
+    const Scheduler::TaskId deps[] = {hash_task, extract_task};
+    return scheduler_.submit_after(deps, [outcome,
+                                          on_done = std::move(on_done)] {
+        if (on_done)
+            on_done(outcome);
+    });
+}
+
+} // namespace intake
@@ -0,0 +1,156 @@
+#include "intake/prefetch.hpp"
+
+#include <algorithm>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "intake/trace.hpp"
+
+namespace intake {
+
+Prefetcher::Prefetcher(Options options) : options_(options) {
+    thread_ = std::thread([this] { run(); });
+}
+
+Prefetcher::~Prefetcher() {
+    {
+        std::lock_guard lock(mu_);
+        stopping_ = true;
+    }
+    work_cv_.notify_all();
+    thread_.join();
+}
+
+Prefetcher::Ticket Prefetcher::publish(std::vector<std::string> files) {
+    Ticket ticket;
+    {
+        std::lock_guard lock(mu_);
+        ticket = next_ticket_++;
+        lists_.push_back({ticket, std::move(files), 0, false, false});
+        ++stats_.lists;
+    }
+    work_cv_.notify_one();
+    return ticket;
+}
+
+void Prefetcher::retire(Ticket ticket) {
+    {
+        std::lock_guard lock(mu_);
+        for (List& l : lists_) {
+            if (l.ticket != ticket)
+                continue;
+            if (!l.retired) {
+                l.retired = true;
+                if (l.advised)
+                    inflight_bytes_ -= l.bytes;
+            }
+            break;
+        }
+        // Drop the fully-finished prefix; partially processed lists stay so
+        // out-of-order retires keep their bookkeeping.
+        while (!lists_.empty() && lists_.front().advised &&
+               lists_.front().retired)
+            lists_.pop_front();
+    }
+    work_cv_.notify_one();
+}
+
+void Prefetcher::drain() {
+    std::unique_lock lock(mu_);
+    drain_cv_.wait(lock, [this] {
+        return std::all_of(lists_.begin(), lists_.end(),
+                           [](const List& l) { return l.advised; });
+    });
+}
+
+Prefetcher::Stats Prefetcher::stats() const {
+    std::lock_guard lock(mu_);
+    return stats_;
+}
+
+std::uint64_t Prefetcher::advise_file(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return 0;
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        return 0;
+    }
+    const std::uint64_t len = std::min<std::uint64_t>(
+        static_cast<std::uint64_t>(st.st_size), options_.max_file_bytes);
+    // WILLNEED starts asynchronous readahead and returns; the pages land
+    // while earlier DAGs run. Failure (NFS, tmpfs quirks) costs nothing —
+    // the task just reads cold.
+    if (len > 0)
+        posix_fadvise(fd, 0, static_cast<off_t>(len), POSIX_FADV_WILLNEED);
+    ::close(fd);
+    return len;
+}
+
+void Prefetcher::run() {
+    std::unique_lock lock(mu_);
+    while (true) {
+        // Next unadvised list, budget permitting.
+        List* next = nullptr;
+        for (List& l : lists_) {
+            if (!l.advised) {
+                next = &l;
+                break;
+            }
+        }
+        if (next == nullptr) {
+            drain_cv_.notify_all();
+            if (stopping_)
+                return;
+            work_cv_.wait(lock);
+            continue;
+        }
+        if (inflight_bytes_ >= options_.budget_bytes) {
+            // Execution has fallen behind the data front; wait for a
+            // retire instead of flooding the page cache.
+            ++stats_.stalls;
+            work_cv_.wait(lock, [this] {
+                return stopping_ || inflight_bytes_ < options_.budget_bytes;
+            });
+            if (stopping_)
+                return;
+            continue;
+        }
+
+        // Advise outside the lock; publish()/retire() must not block on
+        // file metadata I/O.
+        const Ticket ticket = next->ticket;
+        std::vector<std::string> files = std::move(next->files);
+        lock.unlock();
+        INTAKE_TRACE_SCOPE("prefetch.list");
+        std::uint64_t bytes = 0, skipped = 0;
+        for (const std::string& path : files) {
+            const std::uint64_t got = advise_file(path);
+            if (got == 0)
+                ++skipped;
+            bytes += got;
+        }
+        lock.lock();
+        for (List& l : lists_) {
+            if (l.ticket != ticket)
+                continue;
+            l.advised = true;
+            l.bytes = bytes;
+            if (!l.retired)
+                inflight_bytes_ += bytes;
+            break;
+        }
+        stats_.files += files.size();
+        stats_.bytes += bytes;
+        stats_.skipped += skipped;
+        while (!lists_.empty() && lists_.front().advised &&
+               lists_.front().retired)
+            lists_.pop_front();
+        drain_cv_.notify_all();
+    }
+}
+
+} // namespace intake
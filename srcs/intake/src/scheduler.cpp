@@ -0,0 +1,325 @@
+#include "intake/scheduler.hpp"
+
+#include <chrono>
+
+#include "intake/trace.hpp"
+
+namespace intake {
+
+thread_local std::size_t Scheduler::tls_worker_index_ = SIZE_MAX;
+
+// ---------------------------------------------------------------------------
+// Task.
+
+struct Scheduler::Task {
+    TaskFn fn;
+    std::atomic<std::uint32_t> unmet{0};
+    std::atomic<bool> done{false};
+
+    // Dependents registered before completion. Guarded by a per-task
+    // spinlock; registration races completion only for a moment per edge,
+    // so contention is negligible next to the queue traffic.
+    std::atomic_flag edge_lock = ATOMIC_FLAG_INIT;
+    std::vector<Task*> children;
+    bool completed_under_lock = false;
+
+    void lock_edges() {
+        while (edge_lock.test_and_set(std::memory_order_acquire))
+            std::this_thread::yield();
+    }
+    void unlock_edges() { edge_lock.clear(std::memory_order_release); }
+};
+
+// ---------------------------------------------------------------------------
+// Chase-Lev work-stealing deque (Le et al. fenced formulation). Fixed
+// capacity; overflow spills to the injection queue.
+
+struct Scheduler::Deque {
+    static constexpr std::size_t kCapacity = 1 << 13;
+    static constexpr std::size_t kMask = kCapacity - 1;
+
+    std::atomic<std::int64_t> top{0};
+    std::atomic<std::int64_t> bottom{0};
+    std::atomic<Task*> buffer[kCapacity];
+
+    bool push(Task* t) {
+        const std::int64_t b = bottom.load(std::memory_order_relaxed);
+        const std::int64_t tp = top.load(std::memory_order_acquire);
+        if (b - tp >= static_cast<std::int64_t>(kCapacity) - 1)
+            return false; // full
+        buffer[b & kMask].store(t, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    Task* pop() {
+        const std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top.load(std::memory_order_relaxed);
+        Task* task = nullptr;
+        if (t <= b) {
+            task = buffer[b & kMask].load(std::memory_order_relaxed);
+            if (t == b) {
+                if (!top.compare_exchange_strong(t, t + 1,
+                                                 std::memory_order_seq_cst,
+                                                 std::memory_order_relaxed))
+                    task = nullptr; // lost the race to a thief
+                bottom.store(b + 1, std::memory_order_relaxed);
+            }
+        } else {
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    Task* steal() {
+        std::int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b)
+            return nullptr;
+        Task* task = buffer[t & kMask].load(std::memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                         std::memory_order_relaxed))
+            return nullptr; // another thief won; caller retries elsewhere
+        return task;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Bounded MPMC ring (Vyukov) for external submissions and deque overflow.
+
+struct Scheduler::InjectQueue {
+    static constexpr std::size_t kCapacity = 1 << 14;
+    static constexpr std::size_t kMask = kCapacity - 1;
+
+    struct Cell {
+        std::atomic<std::size_t> seq;
+        Task* task;
+    };
+
+    Cell cells[kCapacity];
+    alignas(64) std::atomic<std::size_t> head{0};
+    alignas(64) std::atomic<std::size_t> tail{0};
+
+    InjectQueue() {
+        for (std::size_t i = 0; i < kCapacity; ++i)
+            cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    bool push(Task* t) {
+        std::size_t pos = tail.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & kMask];
+            const std::size_t seq = cell.seq.load(std::memory_order_acquire);
+            const std::intptr_t diff =
+                static_cast<std::intptr_t>(seq) -
+                static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+                    cell.task = t;
+                    cell.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // full
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    Task* pop() {
+        std::size_t pos = head.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & kMask];
+            const std::size_t seq = cell.seq.load(std::memory_order_acquire);
+            const std::intptr_t diff =
+                static_cast<std::intptr_t>(seq) -
+                static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+                    Task* t = cell.task;
+                    cell.seq.store(pos + kCapacity,
+                                   std::memory_order_release);
+                    return t;
+                }
+            } else if (diff < 0) {
+                return nullptr; // empty
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+// ---------------------------------------------------------------------------
+
+Scheduler::Scheduler(std::size_t threads)
+    : inject_(std::make_unique<InjectQueue>()) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+        if (threads == 0)
+            threads = 1;
+    }
+    deques_.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i)
+        deques_.push_back(std::make_unique<Deque>());
+    workers_.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i)
+        workers_.emplace_back([this, i] { worker_loop(i); });
+}
+
+Scheduler::~Scheduler() {
+    wait_all();
+    stopping_.store(true, std::memory_order_release);
+    wake_cv_.notify_all();
+    for (std::thread& t : workers_)
+        t.join();
+}
+
+Scheduler::Task* Scheduler::allocate(TaskFn fn) {
+    auto task = std::make_unique<Task>();
+    task->fn = std::move(fn);
+    Task* raw = task.get();
+    std::lock_guard<std::mutex> lk(alloc_mu_);
+    tasks_.push_back(std::move(task));
+    return raw;
+}
+
+void Scheduler::make_ready(Task* task, std::size_t hint) {
+    // Workers push onto their own deque; everyone else injects.
+    if (hint != SIZE_MAX && deques_[hint]->push(task)) {
+        wake_cv_.notify_one();
+        return;
+    }
+    while (!inject_->push(task)) {
+        // Ring full: run something ourselves to make room.
+        Task* t = inject_->pop();
+        if (t != nullptr)
+            run_task(t);
+    }
+    wake_cv_.notify_one();
+}
+
+Scheduler::TaskId Scheduler::submit(TaskFn fn) {
+    Task* task = allocate(std::move(fn));
+    unfinished_.fetch_add(1, std::memory_order_relaxed);
+    make_ready(task, tls_worker_index_);
+    return task;
+}
+
+Scheduler::TaskId Scheduler::submit_after(std::span<const TaskId> deps,
+                                          TaskFn fn) {
+    Task* task = allocate(std::move(fn));
+    unfinished_.fetch_add(1, std::memory_order_relaxed);
+
+    // Arm with one extra count so the task cannot fire while edges are
+    // still being wired. Each edge bumps unmet before it is published into
+    // the dependency's child list — a dependency that completes mid-wiring
+    // then decrements a count that already includes its edge, instead of
+    // eating the guard and firing the task early (and a second time once
+    // the guard dropped).
+    task->unmet.store(1, std::memory_order_relaxed);
+    for (TaskId dep : deps) {
+        if (dep == nullptr)
+            continue;
+        dep->lock_edges();
+        if (!dep->completed_under_lock) {
+            task->unmet.fetch_add(1, std::memory_order_relaxed);
+            dep->children.push_back(task);
+        }
+        dep->unlock_edges();
+    }
+    if (task->unmet.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        make_ready(task, tls_worker_index_);
+    return task;
+}
+
+void Scheduler::run_task(Task* task) {
+    INTAKE_TRACE_COUNT("scheduler.tasks", 1);
+    task->fn();
+    task->fn = nullptr; // release captures eagerly
+
+    task->lock_edges();
+    task->completed_under_lock = true;
+    std::vector<Task*> children = std::move(task->children);
+    task->unlock_edges();
+    task->done.store(true, std::memory_order_release);
+
+    for (Task* child : children)
+        if (child->unmet.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            make_ready(child, tls_worker_index_);
+
+    if (unfinished_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lk(wake_mu_);
+        idle_cv_.notify_all();
+    }
+}
+
+Scheduler::Task* Scheduler::find_work(std::size_t index) {
+    if (index != SIZE_MAX) {
+        if (Task* t = deques_[index]->pop())
+            return t;
+    }
+    if (Task* t = inject_->pop())
+        return t;
+    const std::size_t n = deques_.size();
+    const std::size_t start = index == SIZE_MAX ? 0 : index;
+    for (std::size_t i = 1; i <= n; ++i) {
+        if (Task* t = deques_[(start + i) % n]->steal())
+            return t;
+    }
+    return nullptr;
+}
+
+void Scheduler::worker_loop(std::size_t index) {
+    tls_worker_index_ = index;
+    while (true) {
+        Task* task = find_work(index);
+        if (task != nullptr) {
+            run_task(task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lk(wake_mu_);
+        if (stopping_.load(std::memory_order_acquire))
+            return;
+        wake_cv_.wait_for(lk, std::chrono::milliseconds(1));
+    }
+}
+
+void Scheduler::wait(TaskId task) {
+    while (!task->done.load(std::memory_order_acquire)) {
+        Task* t = find_work(tls_worker_index_);
+        if (t != nullptr)
+            run_task(t);
+        else
+            std::this_thread::yield();
+    }
+}
+
+void Scheduler::wait_all() {
+    while (unfinished_.load(std::memory_order_acquire) != 0) {
+        Task* t = find_work(tls_worker_index_);
+        if (t != nullptr) {
+            run_task(t);
+            continue;
+        }
+        std::unique_lock<std::mutex> lk(wake_mu_);
+        idle_cv_.wait_for(lk, std::chrono::milliseconds(1), [this] {
+            return unfinished_.load(std::memory_order_acquire) == 0;
+        });
+    }
+}
+
+void Scheduler::reset() {
+    wait_all();
+    std::lock_guard<std::mutex> lk(alloc_mu_);
+    tasks_.clear();
+}
+
+} // namespace intake
@@ -0,0 +1,322 @@
+#include "intake/score_store.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include "intake/mmap_file.hpp"
+
+namespace fs = std::filesystem;
+
+namespace intake {
+
+namespace {
+
+// WAL record: u32 payload_len, u32 crc32(payload), payload. Payload:
+// u64 ts, f64 value, then three u16-length-prefixed strings. A torn tail
+// (short read or crc mismatch) ends replay; everything before it is good.
+//
+// Snapshot ("INTAKSC1"): u64 row_count, then per row the same payload
+// layout back to back. Columnar in access pattern (scores() walks it once
+// in key order) but kept row-major on disk for replay simplicity.
+
+constexpr char kSnapshotMagic[8] = {'I', 'N', 'T', 'A', 'K', 'S', 'C', '1'};
+
+void put_u16_string(std::string& out, std::string_view s) {
+    const std::uint16_t len =
+        static_cast<std::uint16_t>(s.size() < 65535 ? s.size() : 65535);
+    out.append(reinterpret_cast<const char*>(&len), 2);
+    out.append(s.data(), len);
+}
+
+std::string serialize(const Score& s) {
+    std::string out;
+    out.append(reinterpret_cast<const char*>(&s.ts_ns), 8);
+    out.append(reinterpret_cast<const char*>(&s.value), 8);
+    put_u16_string(out, s.team);
+    put_u16_string(out, s.judge);
+    put_u16_string(out, s.criterion);
+    return out;
+}
+
+bool deserialize(const char* p, std::size_t len, Score& out) {
+    std::size_t at = 0;
+    auto need = [&](std::size_t n) { return at + n <= len; };
+    if (!need(16))
+        return false;
+    std::memcpy(&out.ts_ns, p, 8);
+    std::memcpy(&out.value, p + 8, 8);
+    at = 16;
+    for (std::string* field : {&out.team, &out.judge, &out.criterion}) {
+        if (!need(2))
+            return false;
+        std::uint16_t slen;
+        std::memcpy(&slen, p + at, 2);
+        at += 2;
+        if (!need(slen))
+            return false;
+        field->assign(p + at, slen);
+        at += slen;
+    }
+    return at == len;
+}
+
+std::string score_key(std::string_view team, std::string_view judge,
+                      std::string_view criterion) {
+    std::string key;
+    key.reserve(team.size() + judge.size() + criterion.size() + 2);
+    key.append(team);
+    key.push_back('\0');
+    key.append(judge);
+    key.push_back('\0');
+    key.append(criterion);
+    return key;
+}
+
+void write_fully(int fd, const char* p, std::size_t n) {
+    while (n > 0) {
+        const ssize_t w = ::write(fd, p, n);
+        if (w < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::runtime_error("scores: wal write failed: " +
+                                     std::string(std::strerror(errno)));
+        }
+        p += w;
+        n -= static_cast<std::size_t>(w);
+    }
+}
+
+} // namespace
+
+ScoreStore::ScoreStore(std::string dir) : dir_(std::move(dir)) {
+    std::error_code ec;
+    fs::create_directories(dir_, ec);
+    if (ec)
+        throw std::runtime_error("scores: cannot create " + dir_ + ": " +
+                                 ec.message());
+    load_snapshot();
+    replay_wal();
+    wal_fd_ = ::open((dir_ + "/scores.wal").c_str(),
+                     O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    if (wal_fd_ < 0)
+        throw std::runtime_error("scores: cannot open wal: " +
+                                 std::string(std::strerror(errno)));
+}
+
+ScoreStore::~ScoreStore() {
+    if (wal_fd_ >= 0)
+        ::close(wal_fd_);
+}
+
+void ScoreStore::load_snapshot() {
+    const std::string path = dir_ + "/scores.snapshot";
+    std::error_code ec;
+    if (!fs::exists(path, ec))
+        return;
+    MmapFile file(path);
+    const char* p = reinterpret_cast<const char*>(file.data());
+    if (file.size() < 16 || std::memcmp(p, kSnapshotMagic, 8) != 0)
+        throw std::runtime_error("scores: bad snapshot header");
+    std::uint64_t rows;
+    std::memcpy(&rows, p + 8, 8);
+    std::size_t at = 16;
+    for (std::uint64_t i = 0; i < rows; ++i) {
+        Score s;
+        // Rows are self-delimiting; walk field lengths to find the end.
+        std::size_t len = 16;
+        for (int f = 0; f < 3; ++f) {
+            if (at + len + 2 > file.size())
+                throw std::runtime_error("scores: truncated snapshot");
+            std::uint16_t slen;
+            std::memcpy(&slen, p + at + len, 2);
+            len += 2 + slen;
+        }
+        if (at + len > file.size() || !deserialize(p + at, len, s))
+            throw std::runtime_error("scores: truncated snapshot");
+        latest_[score_key(s.team, s.judge, s.criterion)] = std::move(s);
+        at += len;
+    }
+}
+
+void ScoreStore::replay_wal() {
+    const std::string path = dir_ + "/scores.wal";
+    std::error_code ec;
+    if (!fs::exists(path, ec) || fs::file_size(path, ec) == 0)
+        return;
+    MmapFile file(path);
+    const char* p = reinterpret_cast<const char*>(file.data());
+    std::size_t at = 0;
+    std::size_t good_end = 0;
+    while (at + 8 <= file.size()) {
+        std::uint32_t len, crc;
+        std::memcpy(&len, p + at, 4);
+        std::memcpy(&crc, p + at + 4, 4);
+        if (at + 8 + len > file.size())
+            break; // torn tail
+        const char* payload = p + at + 8;
+        if (crc32(0, reinterpret_cast<const Bytef*>(payload), len) != crc)
+            break;
+        Score s;
+        if (!deserialize(payload, len, s))
+            break;
+        latest_[score_key(s.team, s.judge, s.criterion)] = std::move(s);
+        ++stats_.replayed;
+        at += 8 + len;
+        good_end = at;
+    }
+    if (good_end != file.size()) {
+        // Drop the torn tail so the next append starts on a record edge.
+        fs::resize_file(path, good_end, ec);
+    }
+}
+
+void ScoreStore::commit_locked(std::unique_lock<std::mutex>& lk) {
+    // Leader: drain the queue in batches, one write + one fdatasync per
+    // batch, with the lock released around the I/O so writers keep queueing.
+    while (!queue_.empty()) {
+        std::string batch;
+        std::uint64_t batch_last = 0;
+        for (const auto& [seq, record] : queue_) {
+            batch += record;
+            batch_last = seq;
+        }
+        auto taken = std::move(queue_);
+        queue_.clear();
+        lk.unlock();
+        try {
+            write_fully(wal_fd_, batch.data(), batch.size());
+            ::fdatasync(wal_fd_);
+        } catch (...) {
+            // Failed batch goes back on the queue (newer appends queued
+            // during the I/O come after it, preserving seq order) so a
+            // later leader retries it rather than losing the records.
+            lk.lock();
+            queue_.insert(queue_.begin(),
+                          std::make_move_iterator(taken.begin()),
+                          std::make_move_iterator(taken.end()));
+            throw;
+        }
+        lk.lock();
+        durable_seq_ = batch_last;
+        ++stats_.commits;
+        commit_cv_.notify_all();
+    }
+}
+
+void ScoreStore::append(const Score& score) {
+    const std::string payload = serialize(score);
+    std::string record;
+    const std::uint32_t len = static_cast<std::uint32_t>(payload.size());
+    const std::uint32_t crc = static_cast<std::uint32_t>(crc32(
+        0, reinterpret_cast<const Bytef*>(payload.data()), payload.size()));
+    record.append(reinterpret_cast<const char*>(&len), 4);
+    record.append(reinterpret_cast<const char*>(&crc), 4);
+    record += payload;
+
+    std::unique_lock<std::mutex> lk(mu_);
+    const std::uint64_t my_seq = ++next_seq_;
+    queue_.emplace_back(my_seq, std::move(record));
+    latest_[score_key(score.team, score.judge, score.criterion)] = score;
+    ++stats_.appends;
+
+    while (durable_seq_ < my_seq) {
+        if (committing_) {
+            // A leader is already at the disk; ride its (or a later) batch.
+            // Also wake if the leader fails — its exception cleared
+            // committing_, and someone still has to get this record down.
+            commit_cv_.wait(lk,
+                            [&] { return durable_seq_ >= my_seq || !committing_; });
+            continue;
+        }
+        committing_ = true;
+        try {
+            commit_locked(lk);
+        } catch (...) {
+            // commit_locked re-queued the failed batch and relocked; clear
+            // leadership and wake the followers so the next one retries
+            // (or fails for its own record) instead of waiting forever on
+            // a leader that no longer exists.
+            committing_ = false;
+            commit_cv_.notify_all();
+            throw;
+        }
+        committing_ = false;
+        commit_cv_.notify_all();
+    }
+}
+
+bool ScoreStore::latest(std::string_view team, std::string_view judge,
+                        std::string_view criterion, Score& out) const {
+    std::lock_guard<std::mutex> lk(mu_);
+    const auto it = latest_.find(score_key(team, judge, criterion));
+    if (it == latest_.end())
+        return false;
+    out = it->second;
+    return true;
+}
+
+std::vector<Score> ScoreStore::scores() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    std::vector<Score> out;
+    out.reserve(latest_.size());
+    for (const auto& [key, score] : latest_)
+        out.push_back(score);
+    return out;
+}
+
+void ScoreStore::compact() {
+    std::unique_lock<std::mutex> lk(mu_);
+    // Drain in-flight appends so the snapshot covers them.
+    while (!queue_.empty()) {
+        if (committing_) {
+            commit_cv_.wait(lk, [&] { return !committing_; });
+            continue; // re-check: the leader may have failed mid-queue
+        }
+        committing_ = true;
+        try {
+            commit_locked(lk);
+        } catch (...) {
+            committing_ = false;
+            commit_cv_.notify_all();
+            throw;
+        }
+        committing_ = false;
+        commit_cv_.notify_all();
+    }
+
+    std::string bytes(kSnapshotMagic, 8);
+    const std::uint64_t rows = latest_.size();
+    bytes.append(reinterpret_cast<const char*>(&rows), 8);
+    for (const auto& [key, score] : latest_)
+        bytes += serialize(score);
+
+    const std::string path = dir_ + "/scores.snapshot";
+    const std::string tmp = path + ".tmp";
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                    0644);
+    if (fd < 0)
+        throw std::runtime_error("scores: snapshot open failed");
+    write_fully(fd, bytes.data(), bytes.size());
+    ::fdatasync(fd);
+    ::close(fd);
+    if (::rename(tmp.c_str(), path.c_str()) != 0) {
+        ::unlink(tmp.c_str());
+        throw std::runtime_error("scores: snapshot rename failed");
+    }
+    // Snapshot is durable; the log can restart from empty.
+    if (::ftruncate(wal_fd_, 0) != 0)
+        throw std::runtime_error("scores: wal truncate failed");
+}
+
+ScoreStore::Stats ScoreStore::stats() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return stats_;
+}
+
+} // namespace intake
@@ -0,0 +1,366 @@
+#include "intake/shard.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "intake/blake2b.hpp"
+
+namespace intake {
+
+namespace {
+
+// Wire format: every frame is {u32 payload_len (LE), u8 type, payload}.
+// Strings inside payloads are u32-length-prefixed. Numbers are LE.
+enum class Frame : std::uint8_t {
+    NeedWork = 1, // worker -> coord
+    Result = 2,   // worker -> coord: u64 job_id, u8 ok, string payload
+    Job = 3,      // coord -> worker: u64 job_id, string root, string branch
+    NoWork = 4,   // coord -> worker: queue momentarily empty, ask again
+    Shutdown = 5, // coord -> worker: drain complete, disconnect
+};
+
+[[noreturn]] void fail(const std::string& what) {
+    throw std::runtime_error("shard: " + what);
+}
+
+void write_all(int fd, const void* p, std::size_t n) {
+    const char* c = static_cast<const char*>(p);
+    while (n != 0) {
+        const ssize_t w = ::write(fd, c, n);
+        if (w <= 0)
+            fail("connection write failed");
+        c += w;
+        n -= static_cast<std::size_t>(w);
+    }
+}
+
+bool read_all(int fd, void* p, std::size_t n) {
+    char* c = static_cast<char*>(p);
+    while (n != 0) {
+        const ssize_t r = ::read(fd, c, n);
+        if (r <= 0)
+            return false; // peer gone
+        c += r;
+        n -= static_cast<std::size_t>(r);
+    }
+    return true;
+}
+
+void put_u32(std::string& out, std::uint32_t v) {
+    out.append(reinterpret_cast<const char*>(&v), 4);
+}
+
+void put_u64(std::string& out, std::uint64_t v) {
+    out.append(reinterpret_cast<const char*>(&v), 8);
+}
+
+void put_string(std::string& out, std::string_view s) {
+    put_u32(out, static_cast<std::uint32_t>(s.size()));
+    out.append(s);
+}
+
+void send_frame(int fd, Frame type, const std::string& payload) {
+    std::string head;
+    put_u32(head, static_cast<std::uint32_t>(payload.size()));
+    head.push_back(static_cast<char>(type));
+    write_all(fd, head.data(), head.size());
+    write_all(fd, payload.data(), payload.size());
+}
+
+bool recv_frame(int fd, Frame& type, std::string& payload) {
+    char head[5];
+    if (!read_all(fd, head, 5))
+        return false;
+    std::uint32_t len;
+    std::memcpy(&len, head, 4);
+    if (len > 64 * 1024 * 1024)
+        fail("oversized frame");
+    type = static_cast<Frame>(head[4]);
+    payload.resize(len);
+    return len == 0 || read_all(fd, payload.data(), len);
+}
+
+// Cursor over a received payload.
+struct Reader {
+    const std::string& buf;
+    std::size_t at = 0;
+
+    std::uint64_t u64() {
+        std::uint64_t v;
+        if (at + 8 > buf.size())
+            fail("truncated frame");
+        std::memcpy(&v, buf.data() + at, 8);
+        at += 8;
+        return v;
+    }
+
+    std::uint8_t u8() {
+        if (at >= buf.size())
+            fail("truncated frame");
+        return static_cast<std::uint8_t>(buf[at++]);
+    }
+
+    std::string str() {
+        std::uint32_t len;
+        if (at + 4 > buf.size())
+            fail("truncated frame");
+        std::memcpy(&len, buf.data() + at, 4);
+        at += 4;
+        if (at + len > buf.size())
+            fail("truncated frame");
+        std::string s = buf.substr(at, len);
+        at += len;
+        return s;
+    }
+};
+
+int connect_to(const std::string& host, std::uint16_t port) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* res = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints,
+                    &res) != 0)
+        fail("cannot resolve " + host);
+    int fd = -1;
+    for (addrinfo* ai = res; ai; ai = ai->ai_next) {
+        fd = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0)
+            continue;
+        if (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0)
+            break;
+        ::close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    if (fd < 0)
+        fail("cannot connect to " + host);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+std::uint32_t fork_shard(const ForkRef& fork, std::uint32_t shards) {
+    const Digest d = Blake2b::hash(fork.root + "\0" + fork.branch);
+    std::uint32_t v;
+    std::memcpy(&v, d.bytes.data(), 4);
+    return v % shards;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Coordinator.
+
+ShardCoordinator::ShardCoordinator(Options options, MergeFn merge)
+    : options_(options), merge_(std::move(merge)),
+      shard_queues_(options.shards) {
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0)
+        fail("socket failed");
+    int one = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(options.port);
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) !=
+            0 ||
+        listen(listen_fd_, 64) != 0)
+        fail("bind/listen failed");
+    socklen_t len = sizeof(addr);
+    getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+    accept_thread_ = std::thread([this] { accept_loop(); });
+}
+
+ShardCoordinator::~ShardCoordinator() { shutdown(); }
+
+void ShardCoordinator::enqueue(ForkRef fork) {
+    const std::uint32_t shard = fork_shard(fork, options_.shards);
+    std::lock_guard<std::mutex> lk(mu_);
+    jobs_.push_back({std::move(fork), false});
+    shard_queues_[shard].push_back(jobs_.size() - 1);
+    ++enqueued_;
+}
+
+bool ShardCoordinator::next_job(std::uint32_t preferred_shard,
+                                std::uint64_t& job_id) {
+    std::lock_guard<std::mutex> lk(mu_);
+    std::deque<std::uint64_t>* q = &shard_queues_[preferred_shard];
+    if (q->empty()) {
+        // Steal from whoever is deepest in backlog.
+        std::size_t best = 0, best_size = 0;
+        for (std::size_t i = 0; i < shard_queues_.size(); ++i)
+            if (shard_queues_[i].size() > best_size) {
+                best = i;
+                best_size = shard_queues_[i].size();
+            }
+        if (best_size == 0)
+            return false;
+        q = &shard_queues_[best];
+        steals_.fetch_add(1, std::memory_order_relaxed);
+    }
+    job_id = q->front();
+    q->pop_front();
+    jobs_[job_id].dispatched = true;
+    return true;
+}
+
+void ShardCoordinator::accept_loop() {
+    while (!stopping_.load()) {
+        const int fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0)
+            break; // listener closed by shutdown()
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        const std::uint32_t index = next_worker_.fetch_add(1);
+        std::lock_guard<std::mutex> lk(workers_mu_);
+        worker_threads_.emplace_back(
+            [this, fd, index] { serve_worker(fd, index); });
+    }
+}
+
+void ShardCoordinator::serve_worker(int fd, std::uint32_t worker_index) {
+    const std::uint32_t preferred = worker_index % options_.shards;
+    Frame type;
+    std::string payload;
+    // Jobs sent down this connection whose result has not come back yet;
+    // re-enqueued if the worker drops.
+    std::vector<std::uint64_t> inflight;
+    try {
+        while (recv_frame(fd, type, payload)) {
+            if (type == Frame::NeedWork) {
+                std::uint64_t job_id;
+                if (next_job(preferred, job_id)) {
+                    inflight.push_back(job_id);
+                    std::string out;
+                    put_u64(out, job_id);
+                    std::lock_guard<std::mutex> lk(mu_);
+                    put_string(out, jobs_[job_id].fork.root);
+                    put_string(out, jobs_[job_id].fork.branch);
+                    send_frame(fd, Frame::Job, out);
+                } else {
+                    std::uint64_t enqueued;
+                    {
+                        std::lock_guard<std::mutex> lk(mu_);
+                        enqueued = enqueued_;
+                    }
+                    if (stopping_.load() || done_.load() >= enqueued)
+                        send_frame(fd, Frame::Shutdown, {});
+                    else
+                        send_frame(fd, Frame::NoWork, {});
+                }
+            } else if (type == Frame::Result) {
+                Reader r{payload};
+                ShardJobResult result;
+                const std::uint64_t job_id = r.u64();
+                std::erase(inflight, job_id);
+                result.ok = r.u8() != 0;
+                result.payload = r.str();
+                {
+                    std::lock_guard<std::mutex> lk(mu_);
+                    if (job_id >= jobs_.size())
+                        fail("result for unknown job");
+                    result.fork = jobs_[job_id].fork;
+                }
+                if (merge_) {
+                    std::lock_guard<std::mutex> lk(merge_mu_);
+                    merge_(result);
+                }
+                {
+                    // Lock pairs with wait_all's predicate check so the
+                    // final notification can't slip between check and wait.
+                    std::lock_guard<std::mutex> lk(mu_);
+                    done_.fetch_add(1);
+                }
+                all_done_cv_.notify_all();
+            }
+        }
+    } catch (const std::exception&) {
+        // Dropped worker: fall through to the re-enqueue below.
+    }
+    if (!inflight.empty()) {
+        // Put the connection's unfinished jobs back on their shard queues
+        // so survivors drain them — otherwise done_ never reaches
+        // enqueued_ and wait_all() blocks forever on a crashed worker.
+        std::lock_guard<std::mutex> lk(mu_);
+        for (std::uint64_t id : inflight) {
+            jobs_[id].dispatched = false;
+            shard_queues_[fork_shard(jobs_[id].fork, options_.shards)]
+                .push_back(id);
+        }
+    }
+    ::close(fd);
+}
+
+void ShardCoordinator::wait_all() {
+    std::unique_lock<std::mutex> lk(mu_);
+    all_done_cv_.wait(lk, [this] { return done_.load() >= enqueued_; });
+}
+
+void ShardCoordinator::shutdown() {
+    if (stopping_.exchange(true))
+        return;
+    ::shutdown(listen_fd_, SHUT_RDWR);
+    ::close(listen_fd_);
+    if (accept_thread_.joinable())
+        accept_thread_.join();
+    std::lock_guard<std::mutex> lk(workers_mu_);
+    for (std::thread& t : worker_threads_)
+        if (t.joinable())
+            t.join();
+}
+
+// ---------------------------------------------------------------------------
+// Worker.
+
+ShardWorker::ShardWorker(std::string host, std::uint16_t port, JobFn job_fn)
+    : host_(std::move(host)), port_(port), job_fn_(std::move(job_fn)) {}
+
+void ShardWorker::run() {
+    const int fd = connect_to(host_, port_);
+    Frame type;
+    std::string payload;
+    while (true) {
+        send_frame(fd, Frame::NeedWork, {});
+        if (!recv_frame(fd, type, payload))
+            break;
+        if (type == Frame::Shutdown)
+            break;
+        if (type == Frame::NoWork) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            continue;
+        }
+        if (type != Frame::Job)
+            continue;
+        Reader r{payload};
+        const std::uint64_t job_id = r.u64();
+        ForkRef fork;
+        fork.root = r.str();
+        fork.branch = r.str();
+
+        std::string out;
+        put_u64(out, job_id);
+        try {
+            const std::string result = job_fn_(fork);
+            out.push_back(1);
+            put_string(out, result);
+        } catch (const std::exception& e) {
+            out.push_back(0);
+            put_string(out, e.what());
+        }
+        send_frame(fd, Frame::Result, out);
+        ++jobs_run_;
+    }
+    ::close(fd);
+}
+
+} // namespace intake
@@ -0,0 +1,192 @@
+#include "intake/similarity.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace intake {
+
+namespace {
+
+constexpr std::size_t kWindow = 16; // shingle width in bytes
+constexpr std::size_t kBands = 16;  // LSH bands of kRows slots each
+constexpr std::size_t kRows = MinHashSignature::kSlots / kBands;
+
+std::uint64_t splitmix64(std::uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// Buzhash byte table, filled once from a fixed seed.
+const std::array<std::uint64_t, 256>& byte_table() {
+    static const std::array<std::uint64_t, 256> table = [] {
+        std::array<std::uint64_t, 256> t;
+        for (std::size_t i = 0; i < t.size(); ++i)
+            t[i] = splitmix64(0x5eed0fdeadbeefULL + i);
+        return t;
+    }();
+    return table;
+}
+
+std::uint64_t rotl(std::uint64_t v, unsigned n) {
+    return (v << n) | (v >> (64 - n));
+}
+
+} // namespace
+
+MinHashSignature MinHashSignature::from_bytes(std::string_view data) {
+    MinHashSignature sig;
+    sig.mins.fill(~0ULL);
+    const auto& table = byte_table();
+    const unsigned char* p =
+        reinterpret_cast<const unsigned char*>(data.data());
+
+    auto feed = [&](std::uint64_t shingle_hash) {
+        const std::uint64_t h = splitmix64(shingle_hash);
+        std::uint64_t& slot = sig.mins[h >> (64 - 6)]; // top bits pick a slot
+        slot = std::min(slot, h);
+    };
+
+    if (data.size() < kWindow) {
+        // Tiny file: the whole content is the one shingle.
+        std::uint64_t h = 0;
+        for (std::size_t i = 0; i < data.size(); ++i)
+            h = rotl(h, 1) ^ table[p[i]];
+        if (!data.empty())
+            feed(h);
+    } else {
+        // Buzhash keeps the window rolling at one rotate+xor per byte.
+        std::uint64_t h = 0;
+        for (std::size_t i = 0; i < kWindow; ++i)
+            h = rotl(h, 1) ^ table[p[i]];
+        feed(h);
+        for (std::size_t i = kWindow; i < data.size(); ++i) {
+            h = rotl(h, 1) ^ rotl(table[p[i - kWindow]], kWindow) ^ table[p[i]];
+            feed(h);
+        }
+    }
+
+    // Densify by rotation: an empty slot borrows the next filled one, so
+    // small files still fill every band and the equal-slot fraction stays a
+    // usable Jaccard estimate.
+    std::size_t filled = 0;
+    for (std::uint64_t v : sig.mins)
+        if (v != ~0ULL)
+            ++filled;
+    if (filled > 0 && filled < kSlots) {
+        for (std::size_t i = 0; i < kSlots; ++i) {
+            if (sig.mins[i] != ~0ULL)
+                continue;
+            for (std::size_t d = 1; d < kSlots; ++d) {
+                const std::uint64_t v = sig.mins[(i + d) % kSlots];
+                if (v != ~0ULL) {
+                    sig.mins[i] = v;
+                    break;
+                }
+            }
+        }
+    }
+    return sig;
+}
+
+double MinHashSignature::jaccard(const MinHashSignature& other) const {
+    std::size_t equal = 0;
+    for (std::size_t i = 0; i < kSlots; ++i)
+        if (mins[i] == other.mins[i])
+            ++equal;
+    return static_cast<double>(equal) / kSlots;
+}
+
+std::uint32_t SimilarityIndex::add(std::string name,
+                                   const MinHashSignature& sig) {
+    names_.push_back(std::move(name));
+    signatures_.push_back(sig);
+    return static_cast<std::uint32_t>(names_.size() - 1);
+}
+
+std::vector<SimilarityIndex::CandidatePair>
+SimilarityIndex::candidates(double min_jaccard) const {
+    stats_ = {};
+    stats_.files = names_.size();
+
+    // Band keys, one per (file, band).
+    std::vector<std::uint64_t> keys;
+    keys.reserve(signatures_.size() * kBands);
+    for (const MinHashSignature& sig : signatures_) {
+        for (std::size_t b = 0; b < kBands; ++b) {
+            std::uint64_t key = splitmix64(b + 1);
+            for (std::size_t r = 0; r < kRows; ++r)
+                key = splitmix64(key ^ sig.mins[b * kRows + r]);
+            keys.push_back(key);
+        }
+    }
+    stats_.bands = keys.size();
+
+    // Bloom front: `seen` marks keys met once, `dup` keys met again. Only
+    // dup keys get buckets below; a Bloom false positive just lets one
+    // singleton band through to the exact pass, it never loses a pair.
+    std::size_t bits = 64;
+    while (bits < keys.size() * 8)
+        bits <<= 1;
+    std::vector<std::uint64_t> seen(bits / 64), dup(bits / 64);
+    auto probe = [&](std::vector<std::uint64_t>& set, std::uint64_t key) {
+        const std::uint64_t h1 = key & (bits - 1);
+        const std::uint64_t h2 = splitmix64(key) & (bits - 1);
+        const bool present = (set[h1 / 64] >> (h1 % 64) & 1) &&
+                             (set[h2 / 64] >> (h2 % 64) & 1);
+        set[h1 / 64] |= 1ULL << (h1 % 64);
+        set[h2 / 64] |= 1ULL << (h2 % 64);
+        return present;
+    };
+    for (std::uint64_t key : keys)
+        if (probe(seen, key))
+            probe(dup, key);
+
+    auto is_dup = [&](std::uint64_t key) {
+        const std::uint64_t h1 = key & (bits - 1);
+        const std::uint64_t h2 = splitmix64(key) & (bits - 1);
+        return (dup[h1 / 64] >> (h1 % 64) & 1) &&
+               (dup[h2 / 64] >> (h2 % 64) & 1);
+    };
+    std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> buckets;
+    for (std::uint32_t f = 0; f < signatures_.size(); ++f) {
+        for (std::size_t b = 0; b < kBands; ++b) {
+            const std::uint64_t key = keys[f * kBands + b];
+            if (!is_dup(key))
+                continue;
+            std::vector<std::uint32_t>& bucket = buckets[key];
+            if (bucket.empty() || bucket.back() != f) // same file, same key
+                bucket.push_back(f);
+        }
+    }
+    stats_.repeated_bands = buckets.size();
+
+    std::vector<CandidatePair> out;
+    std::unordered_set<std::uint64_t> scored;
+    for (const auto& [key, bucket] : buckets) {
+        for (std::size_t i = 0; i < bucket.size(); ++i) {
+            for (std::size_t j = i + 1; j < bucket.size(); ++j) {
+                const std::uint64_t pair =
+                    (static_cast<std::uint64_t>(bucket[i]) << 32) | bucket[j];
+                if (!scored.insert(pair).second)
+                    continue;
+                ++stats_.pairs_scored;
+                const double jac =
+                    signatures_[bucket[i]].jaccard(signatures_[bucket[j]]);
+                if (jac >= min_jaccard)
+                    out.push_back({bucket[i], bucket[j], jac});
+            }
+        }
+    }
+    std::sort(out.begin(), out.end(),
+              [](const CandidatePair& a, const CandidatePair& b) {
+                  return a.estimated_jaccard > b.estimated_jaccard;
+              });
+    return out;
+}
+
+SimilarityIndex::Stats SimilarityIndex::stats() const { return stats_; }
+
+} // namespace intake
@@ -0,0 +1,130 @@
+#include "intake/thread_pool.hpp"
+
+namespace intake {
+
+ThreadPool::ThreadPool(std::size_t threads) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+        if (threads == 0)
+            threads = 1;
+    }
+    queues_.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i)
+        queues_.push_back(std::make_unique<Queue>());
+    workers_.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i)
+        workers_.emplace_back([this, i] { worker_loop(i); });
+}
+
+ThreadPool::~ThreadPool() {
+    wait_idle();
+    {
+        std::lock_guard<std::mutex> lk(wake_mu_);
+        stopping_.store(true, std::memory_order_release);
+    }
+    wake_cv_.notify_all();
+    for (std::thread& t : workers_)
+        t.join();
+}
+
+void ThreadPool::submit(std::function<void()> fn) {
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    queued_.fetch_add(1, std::memory_order_relaxed);
+    const std::size_t idx =
+        next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    {
+        std::lock_guard<std::mutex> lk(queues_[idx]->mu);
+        queues_[idx]->tasks.push_back(std::move(fn));
+    }
+    // Empty wake_mu_ scope before the notify: a worker that evaluated the
+    // wait predicate (saw queued_ == 0) but has not finished blocking still
+    // holds wake_mu_ inside wait(), so acquiring it here orders this notify
+    // after the worker is actually enqueued — otherwise the wakeup is lost
+    // and the task sits until the next submit.
+    { std::lock_guard<std::mutex> lk(wake_mu_); }
+    wake_cv_.notify_one();
+}
+
+bool ThreadPool::try_pop(std::size_t index, std::function<void()>& out) {
+    // Own queue, newest first.
+    {
+        Queue& q = *queues_[index];
+        std::lock_guard<std::mutex> lk(q.mu);
+        if (!q.tasks.empty()) {
+            out = std::move(q.tasks.back());
+            q.tasks.pop_back();
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    // Steal oldest-first from the others.
+    for (std::size_t i = 1; i < queues_.size(); ++i) {
+        Queue& q = *queues_[(index + i) % queues_.size()];
+        std::lock_guard<std::mutex> lk(q.mu);
+        if (!q.tasks.empty()) {
+            out = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::worker_loop(std::size_t index) {
+    std::function<void()> task;
+    while (true) {
+        if (try_pop(index, task)) {
+            task();
+            task = nullptr;
+            if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                // Same lost-wakeup barrier as submit(), against wait_idle().
+                { std::lock_guard<std::mutex> lk(wake_mu_); }
+                idle_cv_.notify_all();
+            }
+            continue;
+        }
+        std::unique_lock<std::mutex> lk(wake_mu_);
+        if (stopping_.load(std::memory_order_acquire))
+            return;
+        if (queued_.load(std::memory_order_acquire) != 0)
+            continue; // work appeared between the failed pop and the lock
+        wake_cv_.wait(lk, [this] {
+            return stopping_.load(std::memory_order_acquire) ||
+                   queued_.load(std::memory_order_acquire) != 0;
+        });
+        if (stopping_.load(std::memory_order_acquire))
+            return;
+    }
+}
+
+bool ThreadPool::try_run_one() {
+    std::function<void()> task;
+    for (std::size_t i = 0; i < queues_.size(); ++i) {
+        Queue& q = *queues_[i];
+        std::lock_guard<std::mutex> lk(q.mu);
+        if (!q.tasks.empty()) {
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            break;
+        }
+    }
+    if (!task)
+        return false;
+    task();
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        { std::lock_guard<std::mutex> lk(wake_mu_); }
+        idle_cv_.notify_all();
+    }
+    return true;
+}
+
+void ThreadPool::wait_idle() {
+    std::unique_lock<std::mutex> lk(wake_mu_);
+    idle_cv_.wait(lk, [this] {
+        return pending_.load(std::memory_order_acquire) == 0;
+    });
+}
+
+} // namespace intake
@@ -0,0 +1,131 @@
+#include "intake/trace.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+#include <unistd.h>
+
+namespace intake::trace {
+
+namespace {
+
+constexpr std::size_t kRingSize = 1 << 16; // 2 MiB of records
+
+Record g_ring[kRingSize];
+std::atomic<std::uint64_t> g_head{0}; // total records ever written
+
+std::mutex g_names_mu;
+std::vector<std::string> g_names;
+
+const std::chrono::steady_clock::time_point g_start =
+    std::chrono::steady_clock::now();
+
+std::uint32_t thread_id() {
+    static std::atomic<std::uint32_t> next{1};
+    thread_local std::uint32_t id = next.fetch_add(1);
+    return id;
+}
+
+} // namespace
+
+std::uint64_t now_ns() {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - g_start)
+            .count());
+}
+
+std::uint32_t intern(std::string_view name) {
+    std::lock_guard<std::mutex> lk(g_names_mu);
+    for (std::size_t i = 0; i < g_names.size(); ++i)
+        if (g_names[i] == name)
+            return static_cast<std::uint32_t>(i);
+    g_names.emplace_back(name);
+    return static_cast<std::uint32_t>(g_names.size() - 1);
+}
+
+void record(std::uint32_t event, Kind kind, std::uint64_t value) {
+    const std::uint64_t slot =
+        g_head.fetch_add(1, std::memory_order_relaxed) % kRingSize;
+    Record& r = g_ring[slot];
+    r.ts_ns = now_ns();
+    r.value = value;
+    r.event = event;
+    r.tid = thread_id();
+    r.kind = kind;
+}
+
+std::vector<Record> snapshot() {
+    const std::uint64_t head = g_head.load(std::memory_order_relaxed);
+    const std::uint64_t count = head < kRingSize ? head : kRingSize;
+    const std::uint64_t first = head - count;
+    std::vector<Record> out;
+    out.reserve(count);
+    for (std::uint64_t i = 0; i < count; ++i)
+        out.push_back(g_ring[(first + i) % kRingSize]);
+    return out;
+}
+
+const std::vector<std::string>& event_names() {
+    // Append-only; callers racing against interning sites should copy.
+    return g_names;
+}
+
+bool dump(const std::string& path) {
+    std::vector<std::string> names;
+    {
+        std::lock_guard<std::mutex> lk(g_names_mu);
+        names = g_names;
+    }
+    const std::vector<Record> records = snapshot();
+
+    FILE* f = std::fopen((path + ".tmp").c_str(), "wb");
+    if (!f)
+        return false;
+    bool ok = std::fwrite("INTAKTR1", 1, 8, f) == 8;
+    const std::uint32_t name_count = static_cast<std::uint32_t>(names.size());
+    ok = ok && std::fwrite(&name_count, 4, 1, f) == 1;
+    for (const std::string& n : names) {
+        const std::uint32_t len = static_cast<std::uint32_t>(n.size());
+        ok = ok && std::fwrite(&len, 4, 1, f) == 1 &&
+             std::fwrite(n.data(), 1, n.size(), f) == n.size();
+    }
+    ok = ok && std::fwrite(records.data(), sizeof(Record), records.size(),
+                           f) == records.size();
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok) {
+        ::unlink((path + ".tmp").c_str());
+        return false;
+    }
+    return ::rename((path + ".tmp").c_str(), path.c_str()) == 0;
+}
+
+std::vector<EventSummary> summary() {
+    // Snapshot the name table so the returned views survive later interns.
+    static std::mutex storage_mu;
+    static std::vector<std::string> name_storage;
+    std::lock_guard<std::mutex> storage_lk(storage_mu);
+    {
+        std::lock_guard<std::mutex> lk(g_names_mu);
+        name_storage = g_names;
+    }
+    std::vector<EventSummary> out(name_storage.size());
+    for (std::size_t i = 0; i < out.size(); ++i)
+        out[i].name = name_storage[i];
+    for (const Record& r : snapshot()) {
+        if (r.event >= out.size())
+            continue;
+        EventSummary& s = out[r.event];
+        s.kind = r.kind;
+        ++s.samples;
+        s.total += r.value;
+        if (r.value > s.max)
+            s.max = r.value;
+        s.last = r.value;
+    }
+    return out;
+}
+
+} // namespace intake::trace
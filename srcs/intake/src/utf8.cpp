@@ -0,0 +1,435 @@
+#include "intake/utf8.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define INTAKE_X86 1
+#endif
+
+#include "intake/xml_scan.hpp"
+
+namespace intake::utf8 {
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Scalar validation: length of the well-formed sequence starting at s, or 0.
+
+std::size_t check_one(const unsigned char* s, std::size_t n) {
+    const unsigned char c = s[0];
+    if (c < 0x80)
+        return 1;
+    if (c < 0xC2) // continuation byte or overlong 2-byte lead
+        return 0;
+    if (c < 0xE0) { // 110xxxxx
+        if (n < 2 || (s[1] & 0xC0) != 0x80)
+            return 0;
+        return 2;
+    }
+    if (c < 0xF0) { // 1110xxxx
+        if (n < 3 || (s[1] & 0xC0) != 0x80 || (s[2] & 0xC0) != 0x80)
+            return 0;
+        if (c == 0xE0 && s[1] < 0xA0) // overlong
+            return 0;
+        if (c == 0xED && s[1] >= 0xA0) // surrogate
+            return 0;
+        return 3;
+    }
+    if (c < 0xF5) { // 11110xxx
+        if (n < 4 || (s[1] & 0xC0) != 0x80 || (s[2] & 0xC0) != 0x80 ||
+            (s[3] & 0xC0) != 0x80)
+            return 0;
+        if (c == 0xF0 && s[1] < 0x90) // overlong
+            return 0;
+        if (c == 0xF4 && s[1] > 0x8F) // beyond U+10FFFF
+            return 0;
+        return 4;
+    }
+    return 0; // 0xF5..0xFF can never appear
+}
+
+std::size_t scan_scalar(const unsigned char* s, std::size_t n) {
+    std::size_t i = 0;
+    while (i < n) {
+        const std::size_t len = check_one(s + i, n - i);
+        if (len == 0)
+            return i;
+        i += len;
+    }
+    return std::string_view::npos;
+}
+
+#ifdef INTAKE_X86
+
+bool have_avx2() {
+    static const bool v = __builtin_cpu_supports("avx2");
+    return v;
+}
+
+// Skips a pure-ASCII run with movemask so the scalar decoder only ever
+// touches the multibyte stretches. SSE2 is always present on x86-64.
+const unsigned char* skip_ascii_sse2(const unsigned char* p,
+                                     const unsigned char* end) {
+    while (end - p >= 16) {
+        const __m128i chunk =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const int mask = _mm_movemask_epi8(chunk);
+        if (mask != 0)
+            return p + __builtin_ctz(static_cast<unsigned>(mask));
+        p += 16;
+    }
+    while (p != end && *p < 0x80)
+        ++p;
+    return p;
+}
+
+// ---------------------------------------------------------------------------
+// Lookup-table validation (AVX2). Each byte pair (prev1, cur) is classified
+// by three nibble shuffles whose AND is nonzero exactly for the two-byte
+// error patterns (too short, too long, overlong, surrogate, too large);
+// 3-/4-byte sequences additionally require that bytes at distance 2/3 after
+// an E0-/F0-class lead are continuations, checked via saturating subtract.
+
+constexpr std::uint8_t TOO_SHORT = 1 << 0;  // lead followed by non-cont
+constexpr std::uint8_t TOO_LONG = 1 << 1;   // ASCII followed by cont
+constexpr std::uint8_t OVERLONG_3 = 1 << 2; // E0 followed by 80..9F
+constexpr std::uint8_t TOO_LARGE = 1 << 3;  // F4 followed by 90..BF, F5..
+constexpr std::uint8_t SURROGATE = 1 << 4;  // ED followed by A0..BF
+constexpr std::uint8_t OVERLONG_2 = 1 << 5; // C0/C1 lead
+constexpr std::uint8_t TOO_LARGE_1000 = 1 << 6;
+constexpr std::uint8_t OVERLONG_4 = 1 << 6; // F0 followed by 80..8F
+constexpr std::uint8_t TWO_CONTS = 1 << 7;  // two continuations in a row
+constexpr std::uint8_t CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+__attribute__((target("avx2"))) inline __m256i prev_bytes(__m256i cur,
+                                                          __m256i prev,
+                                                          int n) {
+    // Bytes of the combined (prev ++ cur) stream, shifted back by n (1..3).
+    const __m256i joined = _mm256_permute2x128_si256(prev, cur, 0x21);
+    switch (n) {
+    case 1: return _mm256_alignr_epi8(cur, joined, 15);
+    case 2: return _mm256_alignr_epi8(cur, joined, 14);
+    default: return _mm256_alignr_epi8(cur, joined, 13);
+    }
+}
+
+__attribute__((target("avx2"))) inline __m256i
+classify(__m256i cur, __m256i prev1) {
+    const __m256i shuf = _mm256_setr_epi8(
+        // high nibble of the previous byte
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+        TOO_LONG, TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+        TOO_SHORT | OVERLONG_2, TOO_SHORT,
+        TOO_SHORT | OVERLONG_3 | SURROGATE,
+        TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4,
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+        TOO_LONG, TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+        TOO_SHORT | OVERLONG_2, TOO_SHORT,
+        TOO_SHORT | OVERLONG_3 | SURROGATE,
+        TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4);
+    const __m256i shuf_low = _mm256_setr_epi8(
+        // low nibble of the previous byte
+        CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4, CARRY | OVERLONG_2,
+        CARRY, CARRY, CARRY | TOO_LARGE, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE, // low nibble D: ED
+        CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4, CARRY | OVERLONG_2,
+        CARRY, CARRY, CARRY | TOO_LARGE, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE, // low nibble D: ED
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000);
+    const char c8 = static_cast<char>(TOO_LONG | OVERLONG_2 | TWO_CONTS |
+                                      OVERLONG_3 | TOO_LARGE_1000 |
+                                      OVERLONG_4);
+    const char c9 = static_cast<char>(TOO_LONG | OVERLONG_2 | TWO_CONTS |
+                                      OVERLONG_3 | TOO_LARGE);
+    const char cab = static_cast<char>(TOO_LONG | OVERLONG_2 | TWO_CONTS |
+                                       SURROGATE | TOO_LARGE);
+    const __m256i shuf_cur = _mm256_setr_epi8(
+        // high nibble of the current byte
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        TOO_SHORT, TOO_SHORT, c8, c9, cab, cab, TOO_SHORT, TOO_SHORT,
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, c8, c9, cab, cab,
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT);
+
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    const __m256i b1_high = _mm256_shuffle_epi8(
+        shuf, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low_mask));
+    const __m256i b1_low =
+        _mm256_shuffle_epi8(shuf_low, _mm256_and_si256(prev1, low_mask));
+    const __m256i b2_high = _mm256_shuffle_epi8(
+        shuf_cur, _mm256_and_si256(_mm256_srli_epi16(cur, 4), low_mask));
+    return _mm256_and_si256(_mm256_and_si256(b1_high, b1_low), b2_high);
+}
+
+__attribute__((target("avx2"))) inline __m256i
+check_chunk(__m256i cur, __m256i prev, __m256i error) {
+    const __m256i sc = classify(cur, prev_bytes(cur, prev, 1));
+    // An E0-/F0-class lead promises continuations at distance 2/3; the
+    // saturating subtract leaves the high bit set exactly for such leads,
+    // and TWO_CONTS (0x80) in sc marks actual continuations — the XOR is
+    // nonzero when promise and reality disagree.
+    const __m256i is_third = _mm256_subs_epu8(
+        prev_bytes(cur, prev, 2), _mm256_set1_epi8(0xE0 - 0x80));
+    const __m256i is_fourth = _mm256_subs_epu8(
+        prev_bytes(cur, prev, 3), _mm256_set1_epi8(0xF0 - 0x80));
+    const __m256i must23_80 =
+        _mm256_and_si256(_mm256_or_si256(is_third, is_fourth),
+                         _mm256_set1_epi8(static_cast<char>(0x80)));
+    return _mm256_or_si256(error, _mm256_xor_si256(must23_80, sc));
+}
+
+__attribute__((target("avx2"))) bool validate_avx2(const unsigned char* s,
+                                                   std::size_t n) {
+    __m256i prev = _mm256_setzero_si256();
+    __m256i error = _mm256_setzero_si256();
+    // A chunk ending in a truncated lead is only caught when the next chunk
+    // is processed; this mask flags such tails so the ASCII fast path can
+    // check them without running the shuffles.
+    __m256i incomplete = _mm256_setzero_si256();
+    const __m256i max_complete = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1),
+        static_cast<char>(0xC0 - 1));
+
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const __m256i cur =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        if (_mm256_movemask_epi8(cur) == 0) { // pure ASCII
+            error = _mm256_or_si256(error, incomplete);
+            incomplete = _mm256_setzero_si256();
+        } else {
+            error = check_chunk(cur, prev, error);
+            incomplete = _mm256_subs_epu8(cur, max_complete);
+        }
+        prev = cur;
+    }
+    // Final chunk, zero padded: a truncated sequence at the end meets 0x00
+    // instead of its continuation and is flagged like any other error.
+    alignas(32) unsigned char tail[32] = {};
+    std::memcpy(tail, s + i, n - i);
+    const __m256i cur =
+        _mm256_load_si256(reinterpret_cast<const __m256i*>(tail));
+    error = check_chunk(cur, prev, error);
+    return _mm256_testz_si256(error, error) != 0;
+}
+
+#endif // INTAKE_X86
+
+// ---------------------------------------------------------------------------
+// NFC composition table: (base, combining mark) -> precomposed codepoint,
+// sorted by (base, mark) for binary search. Scope is the Latin letters with
+// the marks teams actually type — Czech, Slovak and Polish names included.
+
+struct Composition {
+    std::uint16_t base;
+    std::uint16_t mark;
+    std::uint16_t composed;
+};
+
+// U+0300 grave, 0301 acute, 0302 circumflex, 0303 tilde, 0307 dot above,
+// 0308 diaeresis, 030A ring above, 030C caron, 0327 cedilla.
+constexpr Composition kCompositions[] = {
+    {0x41, 0x300, 0xC0},  {0x41, 0x301, 0xC1},  {0x41, 0x302, 0xC2},
+    {0x41, 0x303, 0xC3},  {0x41, 0x308, 0xC4},  {0x41, 0x30A, 0xC5},
+    {0x43, 0x301, 0x106}, {0x43, 0x30C, 0x10C}, {0x43, 0x327, 0xC7},
+    {0x44, 0x30C, 0x10E}, {0x45, 0x300, 0xC8},  {0x45, 0x301, 0xC9},
+    {0x45, 0x302, 0xCA},  {0x45, 0x308, 0xCB},  {0x45, 0x30C, 0x11A},
+    {0x49, 0x300, 0xCC},  {0x49, 0x301, 0xCD},  {0x49, 0x302, 0xCE},
+    {0x49, 0x308, 0xCF},  {0x4C, 0x301, 0x139}, {0x4C, 0x30C, 0x13D},
+    {0x4E, 0x301, 0x143}, {0x4E, 0x303, 0xD1},  {0x4E, 0x30C, 0x147},
+    {0x4F, 0x300, 0xD2},  {0x4F, 0x301, 0xD3},  {0x4F, 0x302, 0xD4},
+    {0x4F, 0x303, 0xD5},  {0x4F, 0x308, 0xD6},  {0x52, 0x301, 0x154},
+    {0x52, 0x30C, 0x158}, {0x53, 0x301, 0x15A}, {0x53, 0x30C, 0x160},
+    {0x54, 0x30C, 0x164}, {0x55, 0x300, 0xD9},  {0x55, 0x301, 0xDA},
+    {0x55, 0x302, 0xDB},  {0x55, 0x308, 0xDC},  {0x55, 0x30A, 0x16E},
+    {0x59, 0x301, 0xDD},  {0x59, 0x308, 0x178}, {0x5A, 0x301, 0x179},
+    {0x5A, 0x307, 0x17B}, {0x5A, 0x30C, 0x17D}, {0x61, 0x300, 0xE0},
+    {0x61, 0x301, 0xE1},  {0x61, 0x302, 0xE2},  {0x61, 0x303, 0xE3},
+    {0x61, 0x308, 0xE4},  {0x61, 0x30A, 0xE5},  {0x63, 0x301, 0x107},
+    {0x63, 0x30C, 0x10D}, {0x63, 0x327, 0xE7},  {0x64, 0x30C, 0x10F},
+    {0x65, 0x300, 0xE8},  {0x65, 0x301, 0xE9},  {0x65, 0x302, 0xEA},
+    {0x65, 0x308, 0xEB},  {0x65, 0x30C, 0x11B}, {0x69, 0x300, 0xEC},
+    {0x69, 0x301, 0xED},  {0x69, 0x302, 0xEE},  {0x69, 0x308, 0xEF},
+    {0x6C, 0x301, 0x13A}, {0x6C, 0x30C, 0x13E}, {0x6E, 0x301, 0x144},
+    {0x6E, 0x303, 0xF1},  {0x6E, 0x30C, 0x148}, {0x6F, 0x300, 0xF2},
+    {0x6F, 0x301, 0xF3},  {0x6F, 0x302, 0xF4},  {0x6F, 0x303, 0xF5},
+    {0x6F, 0x308, 0xF6},  {0x72, 0x301, 0x155}, {0x72, 0x30C, 0x159},
+    {0x73, 0x301, 0x15B}, {0x73, 0x30C, 0x161}, {0x74, 0x30C, 0x165},
+    {0x75, 0x300, 0xF9},  {0x75, 0x301, 0xFA},  {0x75, 0x302, 0xFB},
+    {0x75, 0x308, 0xFC},  {0x75, 0x30A, 0x16F}, {0x79, 0x301, 0xFD},
+    {0x79, 0x308, 0xFF},  {0x7A, 0x301, 0x17A}, {0x7A, 0x307, 0x17C},
+    {0x7A, 0x30C, 0x17E},
+};
+
+std::uint32_t compose(std::uint32_t base, std::uint32_t mark) {
+    if (base > 0xFFFF || mark > 0xFFFF)
+        return 0;
+    const Composition key = {static_cast<std::uint16_t>(base),
+                             static_cast<std::uint16_t>(mark), 0};
+    const auto it = std::lower_bound(
+        std::begin(kCompositions), std::end(kCompositions), key,
+        [](const Composition& a, const Composition& b) {
+            return a.base != b.base ? a.base < b.base : a.mark < b.mark;
+        });
+    if (it == std::end(kCompositions) || it->base != base || it->mark != mark)
+        return 0;
+    return it->composed;
+}
+
+bool is_combining_mark(std::uint32_t cp) {
+    return cp >= 0x300 && cp <= 0x36F;
+}
+
+// Decodes one codepoint; malformed bytes come back as a single-byte advance
+// with cp set so they copy through untouched (normalization runs after
+// validate(), this just keeps it total).
+std::size_t decode(const unsigned char* s, std::size_t n, std::uint32_t& cp) {
+    const unsigned char c = s[0];
+    if (c < 0x80) {
+        cp = c;
+        return 1;
+    }
+    if (c >= 0xC2 && c < 0xE0 && n >= 2 && (s[1] & 0xC0) == 0x80) {
+        cp = (static_cast<std::uint32_t>(c & 0x1F) << 6) | (s[1] & 0x3F);
+        return 2;
+    }
+    if (c >= 0xE0 && c < 0xF0 && n >= 3 && (s[1] & 0xC0) == 0x80 &&
+        (s[2] & 0xC0) == 0x80) {
+        cp = (static_cast<std::uint32_t>(c & 0x0F) << 12) |
+             (static_cast<std::uint32_t>(s[1] & 0x3F) << 6) | (s[2] & 0x3F);
+        return 3;
+    }
+    if (c >= 0xF0 && c < 0xF5 && n >= 4 && (s[1] & 0xC0) == 0x80 &&
+        (s[2] & 0xC0) == 0x80 && (s[3] & 0xC0) == 0x80) {
+        cp = (static_cast<std::uint32_t>(c & 0x07) << 18) |
+             (static_cast<std::uint32_t>(s[1] & 0x3F) << 12) |
+             (static_cast<std::uint32_t>(s[2] & 0x3F) << 6) | (s[3] & 0x3F);
+        return 4;
+    }
+    cp = c;
+    return 1;
+}
+
+void encode(std::uint32_t cp, std::string& out) {
+    if (cp < 0x80) {
+        out.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+// First combining-mark lead byte in `s`, or npos. Marks in U+0300..U+036F
+// encode as 0xCC 0x80..0xBF / 0xCD 0x80..0xAF, so the xmlscan two-needle
+// sweep finds candidates and the second byte settles it (0xCD also leads
+// Greek from U+0370 on, which is not a mark).
+std::size_t find_mark(std::string_view s) {
+    std::size_t from = 0;
+    while (true) {
+        const std::size_t at = xmlscan::find_any2(
+            s, from, static_cast<char>(0xCC), static_cast<char>(0xCD));
+        if (at == std::string_view::npos || at + 1 >= s.size())
+            return std::string_view::npos;
+        const unsigned char lead = static_cast<unsigned char>(s[at]);
+        const unsigned char next = static_cast<unsigned char>(s[at + 1]);
+        if (next >= 0x80 && next <= (lead == 0xCC ? 0xBF : 0xAF))
+            return at;
+        from = at + 1;
+    }
+}
+
+} // namespace
+
+bool validate(std::string_view s) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(s.data());
+#ifdef INTAKE_X86
+    if (have_avx2())
+        return validate_avx2(p, s.size());
+    // Pre-AVX2: movemask skips the ASCII runs, scalar checks the rest.
+    const unsigned char* end = p + s.size();
+    while (p != end) {
+        p = skip_ascii_sse2(p, end);
+        if (p == end)
+            break;
+        const std::size_t len =
+            check_one(p, static_cast<std::size_t>(end - p));
+        if (len == 0)
+            return false;
+        p += len;
+    }
+    return true;
+#else
+    return scan_scalar(p, s.size()) == std::string_view::npos;
+#endif
+}
+
+std::size_t find_invalid(std::string_view s) {
+    return scan_scalar(reinterpret_cast<const unsigned char*>(s.data()),
+                       s.size());
+}
+
+bool normalize_nfc(std::string_view s, std::string& out) {
+    const std::size_t mark_at = find_mark(s);
+    if (mark_at == std::string_view::npos)
+        return false; // no combining marks: already NFC for our scope
+
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(s.data());
+    // Back up to the start of the codepoint carrying the first mark.
+    std::size_t base_at = mark_at;
+    if (base_at > 0) {
+        --base_at;
+        while (base_at > 0 && (p[base_at] & 0xC0) == 0x80)
+            --base_at;
+    }
+
+    out.assign(s.substr(0, base_at));
+    out.reserve(s.size());
+    bool changed = false;
+    std::size_t i = base_at;
+    while (i < s.size()) {
+        std::uint32_t cp;
+        i += decode(p + i, s.size() - i, cp);
+        // Fold following marks into the base while the table allows it;
+        // a mark outside the table ends the fold and copies through.
+        while (i < s.size()) {
+            std::uint32_t mark;
+            const std::size_t len = decode(p + i, s.size() - i, mark);
+            if (!is_combining_mark(mark))
+                break;
+            const std::uint32_t composed = compose(cp, mark);
+            if (composed == 0)
+                break;
+            cp = composed;
+            i += len;
+            changed = true;
+        }
+        encode(cp, out);
+    }
+    return changed;
+}
+
+} // namespace intake::utf8
@@ -0,0 +1,229 @@
+#include "intake/validator.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+
+#include "intake/trace.hpp"
+
+namespace fs = std::filesystem;
+
+namespace intake {
+
+namespace {
+
+// Shared state of one fork's walk. Directory tasks fan out through the pool
+// and count themselves in `outstanding`; the submitting thread waits on the
+// latch instead of blocking a pool worker.
+struct ForkScan {
+    std::atomic<std::uint64_t> files_scanned{0};
+    std::atomic<bool> has_srcs_dir{false};
+    std::atomic<bool> has_srcs_content{false};
+    std::atomic<bool> has_root_canvas{false};
+    std::atomic<bool> has_pitch_pdf{false};
+
+    std::mutex mu;
+    std::vector<ValidationIssue> issues;
+
+    std::atomic<std::size_t> outstanding{0};
+    std::mutex done_mu;
+    std::condition_variable done_cv;
+
+    void task_done() {
+        if (outstanding.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lk(done_mu);
+            done_cv.notify_all();
+        }
+    }
+
+    // Helps drain the pool while waiting so a worker that owns a fork task
+    // cannot deadlock behind its own sub-walks.
+    void wait(ThreadPool& pool) {
+        while (outstanding.load(std::memory_order_acquire) != 0) {
+            if (pool.try_run_one())
+                continue;
+            std::unique_lock<std::mutex> lk(done_mu);
+            done_cv.wait_for(lk, std::chrono::milliseconds(1), [this] {
+                return outstanding.load(std::memory_order_acquire) == 0;
+            });
+        }
+    }
+
+    void add_issue(ValidationIssue::Code code, std::string path,
+                   std::string message) {
+        std::lock_guard<std::mutex> lk(mu);
+        issues.push_back({code, std::move(path), std::move(message)});
+    }
+};
+
+bool file_has_pdf_magic(const fs::path& p) {
+    int fd = ::open(p.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    char head[8];
+    const ssize_t n = ::read(fd, head, sizeof(head));
+    ::close(fd);
+    return n >= 5 &&
+           SubmissionValidator::looks_like_pdf(std::string_view(head, 5));
+}
+
+// Files the upstream template ships; they do not count as team content.
+bool is_template_placeholder(const fs::path& rel) {
+    return rel == "srcs/tmp_whatever" || rel == "pitch/tmp_pdf";
+}
+
+void walk_directory(ThreadPool& pool, const fs::path& root, const fs::path& dir,
+                    const std::shared_ptr<ForkScan>& scan);
+
+void scan_entry(ThreadPool& pool, const fs::path& root,
+                const fs::directory_entry& entry,
+                const std::shared_ptr<ForkScan>& scan) {
+    std::error_code ec;
+    if (entry.is_directory(ec)) {
+        if (entry.path().filename() == ".git")
+            return;
+        // Sub-walk as its own task so one fork's deep tree spreads across
+        // workers instead of serializing on the submitting task.
+        scan->outstanding.fetch_add(1, std::memory_order_relaxed);
+        pool.submit([&pool, root, path = entry.path(), scan] {
+            walk_directory(pool, root, path, scan);
+            scan->task_done();
+        });
+        return;
+    }
+    if (!entry.is_regular_file(ec))
+        return;
+
+    scan->files_scanned.fetch_add(1, std::memory_order_relaxed);
+    const fs::path rel = entry.path().lexically_relative(root);
+    if (is_template_placeholder(rel))
+        return;
+
+    const fs::path& first = *rel.begin();
+    if (first == "srcs") {
+        scan->has_srcs_content.store(true, std::memory_order_relaxed);
+    } else if (first == "pitch") {
+        if (rel.extension() == ".pdf") {
+            if (file_has_pdf_magic(entry.path()))
+                scan->has_pitch_pdf.store(true, std::memory_order_relaxed);
+            else
+                scan->add_issue(ValidationIssue::Code::NotAPdf, rel.string(),
+                                "pitch file has a .pdf name but is not a PDF");
+        }
+    } else if (rel == rel.filename() && rel.extension() == ".pdf") {
+        // Root-level PDF: the filled solution canvas.
+        if (file_has_pdf_magic(entry.path()))
+            scan->has_root_canvas.store(true, std::memory_order_relaxed);
+        else
+            scan->add_issue(ValidationIssue::Code::NotAPdf, rel.string(),
+                            "root canvas has a .pdf name but is not a PDF");
+    }
+}
+
+void walk_directory(ThreadPool& pool, const fs::path& root, const fs::path& dir,
+                    const std::shared_ptr<ForkScan>& scan) {
+    std::error_code ec;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end;
+         it.increment(ec))
+        scan_entry(pool, root, *it, scan);
+}
+
+} // namespace
+
+bool SubmissionValidator::looks_like_pdf(std::string_view head) {
+    return head.starts_with("%PDF-");
+}
+
+bool SubmissionValidator::branch_name_ok(std::string_view branch) {
+    // Step 2 asks teams to name the branch after the team, so the default
+    // branches are out, and we hold names to git-safe portable characters.
+    if (branch.empty() || branch == "main" || branch == "master")
+        return false;
+    if (branch.front() == '-' || branch.front() == '.' ||
+        branch.back() == '.' || branch.ends_with(".lock"))
+        return false;
+    for (char c : branch) {
+        const bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                        (c >= '0' && c <= '9') || c == '-' || c == '_' ||
+                        c == '.' || c == '/';
+        if (!ok)
+            return false;
+    }
+    return true;
+}
+
+ValidationReport SubmissionValidator::validate_fork(const ForkRef& fork) {
+    INTAKE_TRACE_SCOPE("validator.fork");
+    auto scan = std::make_shared<ForkScan>();
+    const fs::path root(fork.root);
+
+    std::error_code ec;
+    scan->has_srcs_dir.store(fs::is_directory(root / "srcs", ec),
+                             std::memory_order_relaxed);
+
+    scan->outstanding.store(1, std::memory_order_relaxed);
+    pool_.submit([this, root, scan] {
+        walk_directory(pool_, root, root, scan);
+        scan->task_done();
+    });
+    scan->wait(pool_);
+
+    ValidationReport report;
+    report.fork_root = fork.root;
+    report.branch = fork.branch;
+    report.files_scanned = scan->files_scanned.load(std::memory_order_relaxed);
+    report.issues = std::move(scan->issues);
+
+    if (!scan->has_srcs_content.load(std::memory_order_relaxed))
+        report.issues.push_back(
+            {ValidationIssue::Code::MissingSrcs, "srcs",
+             scan->has_srcs_dir.load(std::memory_order_relaxed)
+                 ? "srcs/ holds no solution files beyond the template placeholder"
+                 : "srcs/ directory is missing"});
+    if (!scan->has_root_canvas.load(std::memory_order_relaxed))
+        report.issues.push_back({ValidationIssue::Code::MissingCanvasPdf, ".",
+                                 "no filled solution canvas PDF at the repo root"});
+    if (!scan->has_pitch_pdf.load(std::memory_order_relaxed))
+        report.issues.push_back({ValidationIssue::Code::MissingPitchPdf, "pitch",
+                                 "no pitch PDF under pitch/"});
+    if (!branch_name_ok(fork.branch))
+        report.issues.push_back({ValidationIssue::Code::BadBranchName, "",
+                                 "branch must be a team name, not '" +
+                                     fork.branch + "'"});
+    return report;
+}
+
+std::vector<ValidationReport>
+SubmissionValidator::validate_batch(std::span<const ForkRef> forks) {
+    std::vector<ValidationReport> reports(forks.size());
+    std::atomic<std::size_t> remaining(forks.size());
+    std::mutex done_mu;
+    std::condition_variable done_cv;
+
+    for (std::size_t i = 0; i < forks.size(); ++i) {
+        pool_.submit([this, &forks, &reports, &remaining, &done_mu, &done_cv, i] {
+            reports[i] = validate_fork(forks[i]);
+            if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lk(done_mu);
+                done_cv.notify_all();
+            }
+        });
+    }
+    while (remaining.load(std::memory_order_acquire) != 0) {
+        if (pool_.try_run_one())
+            continue;
+        std::unique_lock<std::mutex> lk(done_mu);
+        done_cv.wait_for(lk, std::chrono::milliseconds(1), [&] {
+            return remaining.load(std::memory_order_acquire) == 0;
+        });
+    }
+    return reports;
+}
+
+} // namespace intake
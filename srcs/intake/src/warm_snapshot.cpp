@@ -0,0 +1,182 @@
+#include "intake/warm_snapshot.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace intake {
+
+namespace {
+
+// File layout (little-endian):
+//   FileHeader
+//   per index: u64 name_len, name, pad to 8, u64 blob_len, blob, pad to 8
+//   pending:   u64 count, per job u32 root_len, root, u32 branch_len, branch
+//
+// Index blobs are the FeedbackIndex serialize() layout and are never copied
+// at open — their pages load on first fault. The pending list is byte-packed
+// and copied out eagerly; it is a handful of paths, not warm data.
+
+constexpr char kMagic[8] = {'I', 'N', 'T', 'A', 'K', 'W', 'S', '1'};
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t index_count;
+    std::uint8_t digest[32];
+};
+static_assert(sizeof(FileHeader) == 48);
+
+std::size_t pad8(std::size_t n) { return (n + 7) & ~std::size_t{7}; }
+
+void append_padded(std::string& out, const void* data, std::size_t len) {
+    const std::uint64_t len64 = len;
+    out.append(reinterpret_cast<const char*>(&len64), 8);
+    out.append(static_cast<const char*>(data), len);
+    out.resize(pad8(out.size()), '\0');
+}
+
+void write_atomically(const std::string& path, const std::string& bytes) {
+    const std::string tmp = path + ".tmp";
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                    0644);
+    if (fd < 0)
+        throw std::runtime_error("warm snapshot: cannot write " + tmp);
+    const char* p = bytes.data();
+    std::size_t left = bytes.size();
+    while (left > 0) {
+        const ssize_t w = ::write(fd, p, left);
+        if (w < 0) {
+            if (errno == EINTR)
+                continue;
+            ::close(fd);
+            ::unlink(tmp.c_str());
+            throw std::runtime_error("warm snapshot: write failed");
+        }
+        p += w;
+        left -= static_cast<std::size_t>(w);
+    }
+    ::fdatasync(fd);
+    ::close(fd);
+    if (::rename(tmp.c_str(), path.c_str()) != 0) {
+        ::unlink(tmp.c_str());
+        throw std::runtime_error("warm snapshot: rename failed");
+    }
+}
+
+} // namespace
+
+void WarmSnapshot::save(const std::string& path, const ColumnarCache& cache,
+                        std::span<const NamedIndex> indexes,
+                        std::span<const ForkRef> pending) {
+    FileHeader h{};
+    std::memcpy(h.magic, kMagic, 8);
+    h.version = 1;
+    h.index_count = static_cast<std::uint32_t>(indexes.size());
+    std::memcpy(h.digest, cache.source_digest().bytes.data(), 32);
+
+    std::string bytes(reinterpret_cast<const char*>(&h), sizeof(h));
+    std::string blob;
+    for (const NamedIndex& named : indexes) {
+        append_padded(bytes, named.sheet.data(), named.sheet.size());
+        blob.clear();
+        named.index->serialize(blob);
+        append_padded(bytes, blob.data(), blob.size());
+    }
+
+    const std::uint64_t count = pending.size();
+    bytes.append(reinterpret_cast<const char*>(&count), 8);
+    for (const ForkRef& fork : pending) {
+        for (const std::string* s : {&fork.root, &fork.branch}) {
+            const std::uint32_t len = static_cast<std::uint32_t>(s->size());
+            bytes.append(reinterpret_cast<const char*>(&len), 4);
+            bytes.append(*s);
+        }
+    }
+    write_atomically(path, bytes);
+}
+
+std::optional<WarmSnapshot> WarmSnapshot::open(const std::string& path,
+                                               const ColumnarCache& cache) {
+    std::shared_ptr<MmapFile> file;
+    try {
+        file = std::make_shared<MmapFile>(path);
+    } catch (const std::exception&) {
+        return std::nullopt; // no snapshot yet: cold start
+    }
+    const char* base = reinterpret_cast<const char*>(file->data());
+    const std::size_t size = file->size();
+
+    FileHeader h;
+    if (size < sizeof(h))
+        return std::nullopt;
+    std::memcpy(&h, base, sizeof(h));
+    if (std::memcmp(h.magic, kMagic, 8) != 0 || h.version != 1)
+        return std::nullopt;
+    if (std::memcmp(h.digest, cache.source_digest().bytes.data(), 32) != 0)
+        return std::nullopt; // workbook changed while we were down
+
+    WarmSnapshot snap;
+    snap.file_ = file;
+    std::size_t at = sizeof(h);
+    auto slice = [&](std::uint64_t& len) -> const char* {
+        if (at + 8 > size)
+            return nullptr;
+        std::memcpy(&len, base + at, 8);
+        at += 8;
+        if (at + len > size)
+            return nullptr;
+        const char* p = base + at;
+        at = pad8(at + len);
+        return p;
+    };
+    try {
+        for (std::uint32_t i = 0; i < h.index_count; ++i) {
+            std::uint64_t name_len, blob_len;
+            const char* name = slice(name_len);
+            if (!name)
+                return std::nullopt;
+            const char* blob = slice(blob_len);
+            if (!blob)
+                return std::nullopt;
+            snap.indexes_.emplace_back(
+                std::string(name, name_len),
+                FeedbackIndex(cache, blob, blob_len));
+        }
+    } catch (const std::exception&) {
+        return std::nullopt; // stale or corrupt index blob: rebuild
+    }
+
+    if (at + 8 > size)
+        return std::nullopt;
+    std::uint64_t count;
+    std::memcpy(&count, base + at, 8);
+    at += 8;
+    for (std::uint64_t i = 0; i < count; ++i) {
+        ForkRef fork;
+        for (std::string* s : {&fork.root, &fork.branch}) {
+            if (at + 4 > size)
+                return std::nullopt;
+            std::uint32_t len;
+            std::memcpy(&len, base + at, 4);
+            at += 4;
+            if (at + len > size)
+                return std::nullopt;
+            s->assign(base + at, len);
+            at += len;
+        }
+        snap.pending_.push_back(std::move(fork));
+    }
+    return snap;
+}
+
+const FeedbackIndex* WarmSnapshot::index(std::string_view sheet) const {
+    for (const auto& [name, index] : indexes_)
+        if (name == sheet)
+            return &index;
+    return nullptr;
+}
+
+} // namespace intake
@@ -0,0 +1,368 @@
+#include "intake/xlsx_reader.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#include "intake/trace.hpp"
+#include "intake/xml_scan.hpp"
+
+namespace intake {
+
+namespace {
+
+// Minimal forward-only XML helpers. The worksheet parts we scan are
+// machine-generated SpreadsheetML with a fixed shape, so a full parser is
+// unnecessary weight on the hot path.
+
+// Finds the next element whose name matches `tag` ("<c " / "<c>" / "<c/>").
+// Returns the position of '<' or npos.
+std::size_t find_tag(std::string_view xml, std::size_t from,
+                     std::string_view tag) {
+    while (true) {
+        std::size_t pos = xmlscan::find_byte(xml, from, '<');
+        if (pos == std::string_view::npos)
+            return std::string_view::npos;
+        std::size_t name_end = pos + 1 + tag.size();
+        if (name_end < xml.size() && xml.compare(pos + 1, tag.size(), tag) == 0) {
+            const char c = xml[name_end];
+            if (c == ' ' || c == '>' || c == '/' || c == '\t')
+                return pos;
+        }
+        from = pos + 1;
+        if (from >= xml.size())
+            return std::string_view::npos;
+    }
+}
+
+// Extracts an attribute value from the tag starting at `tag_pos`. Returns an
+// empty view when the attribute is absent.
+std::string_view attr_value(std::string_view xml, std::size_t tag_pos,
+                            std::string_view name) {
+    std::size_t end = xmlscan::find_byte(xml, tag_pos, '>');
+    if (end == std::string_view::npos)
+        return {};
+    std::string_view tag = xml.substr(tag_pos, end - tag_pos);
+    std::string needle;
+    needle.reserve(name.size() + 3);
+    needle += ' ';
+    needle += name;
+    needle += "=\"";
+    std::size_t at = tag.find(needle);
+    if (at == std::string_view::npos)
+        return {};
+    std::size_t start = at + needle.size();
+    std::size_t close = tag.find('"', start);
+    if (close == std::string_view::npos)
+        return {};
+    return tag.substr(start, close - start);
+}
+
+bool tag_is_self_closing(std::string_view xml, std::size_t tag_pos) {
+    std::size_t end = xmlscan::find_byte(xml, tag_pos, '>');
+    return end != std::string_view::npos && end > tag_pos &&
+           xml[end - 1] == '/';
+}
+
+// Unescapes the five XML entities plus numeric character references into
+// `out`. Only called for strings that actually contain '&'.
+void unescape_into(std::string_view s, std::string& out) {
+    out.clear();
+    out.reserve(s.size());
+    std::size_t i = 0;
+    while (i < s.size()) {
+        if (s[i] != '&') {
+            out.push_back(s[i++]);
+            continue;
+        }
+        std::size_t semi = s.find(';', i);
+        if (semi == std::string_view::npos) {
+            out.push_back(s[i++]);
+            continue;
+        }
+        std::string_view ent = s.substr(i + 1, semi - i - 1);
+        if (ent == "amp")
+            out.push_back('&');
+        else if (ent == "lt")
+            out.push_back('<');
+        else if (ent == "gt")
+            out.push_back('>');
+        else if (ent == "quot")
+            out.push_back('"');
+        else if (ent == "apos")
+            out.push_back('\'');
+        else if (!ent.empty() && ent[0] == '#') {
+            // Decimal or hex character reference; encode as UTF-8.
+            std::uint32_t cp = 0;
+            if (ent.size() > 1 && (ent[1] == 'x' || ent[1] == 'X'))
+                cp = static_cast<std::uint32_t>(
+                    std::strtoul(std::string(ent.substr(2)).c_str(), nullptr, 16));
+            else
+                cp = static_cast<std::uint32_t>(
+                    std::strtoul(std::string(ent.substr(1)).c_str(), nullptr, 10));
+            if (cp < 0x80) {
+                out.push_back(static_cast<char>(cp));
+            } else if (cp < 0x800) {
+                out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+                out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+            } else if (cp < 0x10000) {
+                out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+                out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+            } else {
+                out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+                out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+            }
+        } else {
+            out.append(s.substr(i, semi - i + 1));
+        }
+        i = semi + 1;
+    }
+}
+
+} // namespace
+
+double CellView::number() const {
+    if (text.empty())
+        return 0.0;
+    // Cell text views are not NUL-terminated; strtod needs a bounded copy
+    // only in the rare long-number case, so stack-buffer the common one.
+    char buf[64];
+    const std::size_t n = text.size() < sizeof(buf) - 1 ? text.size() : sizeof(buf) - 1;
+    memcpy(buf, text.data(), n);
+    buf[n] = '\0';
+    return std::strtod(buf, nullptr);
+}
+
+std::uint32_t column_index(std::string_view cell_ref) {
+    std::uint32_t col = 0;
+    for (char c : cell_ref) {
+        if (c < 'A' || c > 'Z')
+            break;
+        col = col * 26 + static_cast<std::uint32_t>(c - 'A' + 1);
+    }
+    return col == 0 ? 0 : col - 1;
+}
+
+XlsxReader::XlsxReader(const std::string& path)
+    : file_(path), zip_(file_) {
+    load_workbook_metadata();
+    load_shared_strings();
+}
+
+void XlsxReader::load_workbook_metadata() {
+    std::vector<unsigned char> buf;
+    std::string_view workbook = zip_.read("xl/workbook.xml", buf);
+
+    // Pass 1: sheet name -> relationship id, in workbook order.
+    std::vector<std::string> rel_ids;
+    std::size_t pos = 0;
+    while ((pos = find_tag(workbook, pos, "sheet")) != std::string_view::npos) {
+        std::string_view name = attr_value(workbook, pos, "name");
+        std::string_view rid = attr_value(workbook, pos, "r:id");
+        if (!name.empty() && !rid.empty()) {
+            std::string unescaped;
+            if (name.find('&') != std::string_view::npos) {
+                unescape_into(name, unescaped);
+                sheet_names_.push_back(unescaped);
+            } else {
+                sheet_names_.emplace_back(name);
+            }
+            rel_ids.emplace_back(rid);
+        }
+        ++pos;
+    }
+
+    // Pass 2: relationship id -> part path from the workbook rels.
+    std::vector<unsigned char> rels_buf;
+    std::string_view rels = zip_.read("xl/_rels/workbook.xml.rels", rels_buf);
+    sheet_parts_.resize(sheet_names_.size());
+    pos = 0;
+    while ((pos = find_tag(rels, pos, "Relationship")) != std::string_view::npos) {
+        std::string_view id = attr_value(rels, pos, "Id");
+        std::string_view target = attr_value(rels, pos, "Target");
+        for (std::size_t i = 0; i < rel_ids.size(); ++i) {
+            if (rel_ids[i] == id) {
+                sheet_parts_[i] = target.starts_with("/")
+                                      ? std::string(target.substr(1))
+                                      : "xl/" + std::string(target);
+            }
+        }
+        ++pos;
+    }
+    for (std::size_t i = 0; i < sheet_parts_.size(); ++i)
+        if (sheet_parts_[i].empty())
+            throw std::runtime_error("xlsx: no part for sheet " + sheet_names_[i]);
+}
+
+void XlsxReader::load_shared_strings() {
+    INTAKE_TRACE_SCOPE("xlsx.shared_strings");
+    if (zip_.find("xl/sharedStrings.xml") == nullptr)
+        return; // workbook with no string cells
+    std::string_view xml = zip_.read("xl/sharedStrings.xml", shared_strings_xml_);
+
+    std::size_t pos = 0;
+    while ((pos = find_tag(xml, pos, "si")) != std::string_view::npos) {
+        std::size_t si_end = find_tag(xml, pos + 1, "/si");
+        if (si_end == std::string_view::npos)
+            si_end = xml.size();
+
+        // A <si> usually holds one <t>; rich-text runs hold several. The
+        // single-run case stays zero-copy; multi-run and escaped strings are
+        // materialized once into the reader's arena.
+        std::string_view first_run;
+        ArenaStringBuilder assembled(string_arena_);
+        int runs = 0;
+        std::size_t t = pos;
+        while ((t = find_tag(xml, t, "t")) != std::string_view::npos &&
+               t < si_end) {
+            if (tag_is_self_closing(xml, t)) {
+                ++t;
+                ++runs;
+                continue;
+            }
+            std::size_t open_end = xmlscan::find_byte(xml, t, '>');
+            std::size_t close = find_tag(xml, open_end, "/t");
+            if (open_end == std::string_view::npos ||
+                close == std::string_view::npos)
+                break;
+            std::string_view run = xml.substr(open_end + 1, close - open_end - 1);
+            if (runs == 0)
+                first_run = run;
+            else {
+                if (runs == 1)
+                    assembled.append(first_run);
+                assembled.append(run);
+            }
+            ++runs;
+            t = close + 1;
+        }
+
+        if (runs <= 1 && xmlscan::find_byte(first_run, 0, '&') == std::string_view::npos) {
+            shared_strings_.push_back(first_run);
+        } else {
+            std::string_view raw = runs <= 1 ? first_run : assembled.view();
+            if (xmlscan::find_byte(raw, 0, '&') != std::string_view::npos) {
+                std::string out;
+                unescape_into(raw, out);
+                shared_strings_.push_back(string_arena_.copy(out));
+            } else {
+                // Multi-run assembly already lives in the arena.
+                shared_strings_.push_back(
+                    raw.data() == assembled.view().data()
+                        ? raw
+                        : string_arena_.copy(raw));
+            }
+        }
+        pos = si_end;
+    }
+}
+
+std::string_view XlsxReader::sheet_part(std::string_view sheet_name) const {
+    for (std::size_t i = 0; i < sheet_names_.size(); ++i)
+        if (sheet_names_[i] == sheet_name)
+            return sheet_parts_[i];
+    throw std::runtime_error("xlsx: no such sheet: " + std::string(sheet_name));
+}
+
+void XlsxReader::for_each_row(std::string_view sheet_name,
+                              const RowCallback& cb) {
+    INTAKE_TRACE_SCOPE("xlsx.sheet_scan");
+    std::string_view xml = zip_.read(sheet_part(sheet_name), sheet_xml_);
+
+    std::size_t pos = find_tag(xml, 0, "sheetData");
+    if (pos == std::string_view::npos)
+        return;
+
+    while ((pos = find_tag(xml, pos, "row")) != std::string_view::npos) {
+        std::string_view r = attr_value(xml, pos, "r");
+        std::uint32_t row_num = 0;
+        for (char c : r)
+            row_num = row_num * 10 + static_cast<std::uint32_t>(c - '0');
+
+        std::size_t row_end = find_tag(xml, pos + 1, "/row");
+        if (row_end == std::string_view::npos)
+            row_end = xml.size();
+
+        row_cells_.clear();
+        std::size_t c_pos = pos;
+        while ((c_pos = find_tag(xml, c_pos, "c")) != std::string_view::npos &&
+               c_pos < row_end) {
+            CellView cell;
+            cell.row = row_num;
+            cell.col = column_index(attr_value(xml, c_pos, "r"));
+            std::string_view t = attr_value(xml, c_pos, "t");
+
+            if (tag_is_self_closing(xml, c_pos)) {
+                ++c_pos;
+                continue; // empty cell
+            }
+            std::size_t c_end = find_tag(xml, c_pos + 1, "/c");
+            if (c_end == std::string_view::npos)
+                c_end = row_end;
+
+            std::string_view value;
+            std::size_t v = find_tag(xml, c_pos, "v");
+            if (v != std::string_view::npos && v < c_end &&
+                !tag_is_self_closing(xml, v)) {
+                std::size_t open_end = xmlscan::find_byte(xml, v, '>');
+                std::size_t close = find_tag(xml, open_end, "/v");
+                if (open_end != std::string_view::npos &&
+                    close != std::string_view::npos)
+                    value = xml.substr(open_end + 1, close - open_end - 1);
+            } else if (t == "inlineStr") {
+                std::size_t it = find_tag(xml, c_pos, "t");
+                if (it != std::string_view::npos && it < c_end &&
+                    !tag_is_self_closing(xml, it)) {
+                    std::size_t open_end = xmlscan::find_byte(xml, it, '>');
+                    std::size_t close = find_tag(xml, open_end, "/t");
+                    if (open_end != std::string_view::npos &&
+                        close != std::string_view::npos)
+                        value = xml.substr(open_end + 1, close - open_end - 1);
+                }
+            }
+
+            if (t == "s") {
+                cell.type = CellView::Type::SharedString;
+                std::size_t idx = 0;
+                for (char ch : value)
+                    idx = idx * 10 + static_cast<std::size_t>(ch - '0');
+                cell.text = idx < shared_strings_.size() ? shared_strings_[idx]
+                                                         : std::string_view{};
+            } else if (t == "inlineStr" || t == "str") {
+                cell.type = t == "str" ? CellView::Type::Formula
+                                       : CellView::Type::InlineString;
+                // Entity escapes are rare in cell text; when present the
+                // unescaped copy goes into the arena, like shared strings.
+                if (xmlscan::find_byte(value, 0, '&') !=
+                    std::string_view::npos) {
+                    std::string out;
+                    unescape_into(value, out);
+                    cell.text = string_arena_.copy(out);
+                } else {
+                    cell.text = value;
+                }
+            } else if (t == "b") {
+                cell.type = CellView::Type::Boolean;
+                cell.text = value;
+            } else if (t == "e") {
+                cell.type = CellView::Type::Error;
+                cell.text = value;
+            } else if (!value.empty()) {
+                cell.type = CellView::Type::Number;
+                cell.text = value;
+            }
+            if (cell.type != CellView::Type::Empty)
+                row_cells_.push_back(cell);
+            c_pos = c_end + 1;
+        }
+
+        if (!row_cells_.empty())
+            cb(row_num, row_cells_);
+        pos = row_end + 1;
+    }
+}
+
+} // namespace intake
@@ -0,0 +1,382 @@
+#include "intake/xlsx_writer.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+
+namespace intake {
+
+namespace {
+
+constexpr std::size_t kBuf = 64 * 1024; // deflate in/out buffer size
+
+void write_fully(int fd, const void* data, std::size_t n) {
+    const char* p = static_cast<const char*>(data);
+    while (n > 0) {
+        const ssize_t w = ::write(fd, p, n);
+        if (w < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::runtime_error("xlsx writer: write failed: " +
+                                     std::string(std::strerror(errno)));
+        }
+        p += w;
+        n -= static_cast<std::size_t>(w);
+    }
+}
+
+void put_u16(std::string& out, std::uint16_t v) {
+    out.append(reinterpret_cast<const char*>(&v), 2);
+}
+
+void put_u32(std::string& out, std::uint32_t v) {
+    out.append(reinterpret_cast<const char*>(&v), 4);
+}
+
+// Column index -> "A", "B", .. "AA" reference letters.
+void column_letters(std::uint32_t col, std::string& out) {
+    char buf[8];
+    int at = 8;
+    ++col;
+    while (col > 0) {
+        buf[--at] = static_cast<char>('A' + (col - 1) % 26);
+        col = (col - 1) / 26;
+    }
+    out.append(buf + at, static_cast<std::size_t>(8 - at));
+}
+
+void xml_escape_into(std::string& out, std::string_view s) {
+    for (char c : s) {
+        switch (c) {
+        case '&': out += "&amp;"; break;
+        case '<': out += "&lt;"; break;
+        case '>': out += "&gt;"; break;
+        case '"': out += "&quot;"; break;
+        default: out.push_back(c);
+        }
+    }
+}
+
+} // namespace
+
+// One deflated zip entry at a time; sizes and crc stream out behind the
+// data as a descriptor, and the central directory records collected here
+// are replayed by finish().
+struct XlsxWriter::Impl {
+    struct EntryRecord {
+        std::string name;
+        std::uint32_t crc = 0;
+        std::uint32_t compressed = 0;
+        std::uint32_t uncompressed = 0;
+        std::uint32_t offset = 0;
+    };
+
+    int fd = -1;
+    std::uint32_t offset = 0;
+    std::vector<EntryRecord> entries;
+
+    z_stream strm{};
+    bool entry_open = false;
+    std::string pending; // XML accumulates here until a buffer's worth
+
+    std::vector<std::string> sheet_names;
+    bool sheet_open = false;
+    std::uint32_t next_row = 1;
+    bool finished = false;
+
+    void write_raw(const void* data, std::size_t n) {
+        write_fully(fd, data, n);
+        offset += static_cast<std::uint32_t>(n);
+    }
+
+    void begin_entry(std::string_view name) {
+        EntryRecord rec;
+        rec.name = name;
+        rec.offset = offset;
+        entries.push_back(std::move(rec));
+
+        std::string head;
+        put_u32(head, 0x04034b50); // local file header
+        put_u16(head, 20);         // version needed
+        put_u16(head, 0x0808);     // bit 3: descriptor follows; bit 11: UTF-8
+        put_u16(head, 8);          // deflate
+        put_u16(head, 0);          // mod time
+        put_u16(head, 0);          // mod date
+        put_u32(head, 0);          // crc: in the descriptor
+        put_u32(head, 0);          // compressed size: in the descriptor
+        put_u32(head, 0);          // uncompressed size: in the descriptor
+        put_u16(head, static_cast<std::uint16_t>(name.size()));
+        put_u16(head, 0); // extra length
+        head.append(name);
+        write_raw(head.data(), head.size());
+
+        std::memset(&strm, 0, sizeof(strm));
+        if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8,
+                         Z_DEFAULT_STRATEGY) != Z_OK)
+            throw std::runtime_error("xlsx writer: deflateInit failed");
+        entry_open = true;
+    }
+
+    void entry_write(std::string_view data) {
+        EntryRecord& rec = entries.back();
+        rec.crc = static_cast<std::uint32_t>(
+            crc32(rec.crc, reinterpret_cast<const Bytef*>(data.data()),
+                  static_cast<uInt>(data.size())));
+        rec.uncompressed += static_cast<std::uint32_t>(data.size());
+
+        strm.next_in =
+            reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+        strm.avail_in = static_cast<uInt>(data.size());
+        unsigned char out[kBuf];
+        while (strm.avail_in > 0) {
+            strm.next_out = out;
+            strm.avail_out = kBuf;
+            if (deflate(&strm, Z_NO_FLUSH) != Z_OK)
+                throw std::runtime_error("xlsx writer: deflate failed");
+            const std::size_t got = kBuf - strm.avail_out;
+            if (got > 0) {
+                write_raw(out, got);
+                entries.back().compressed += static_cast<std::uint32_t>(got);
+            }
+        }
+    }
+
+    void flush_pending(std::size_t watermark) {
+        if (pending.size() >= watermark) {
+            entry_write(pending);
+            pending.clear();
+        }
+    }
+
+    void end_entry() {
+        flush_pending(0);
+        unsigned char out[kBuf];
+        int rc;
+        do {
+            strm.next_out = out;
+            strm.avail_out = kBuf;
+            rc = deflate(&strm, Z_FINISH);
+            if (rc != Z_OK && rc != Z_STREAM_END)
+                throw std::runtime_error("xlsx writer: deflate finish failed");
+            const std::size_t got = kBuf - strm.avail_out;
+            if (got > 0) {
+                write_raw(out, got);
+                entries.back().compressed += static_cast<std::uint32_t>(got);
+            }
+        } while (rc != Z_STREAM_END);
+        deflateEnd(&strm);
+
+        const EntryRecord& rec = entries.back();
+        std::string desc;
+        put_u32(desc, 0x08074b50); // data descriptor
+        put_u32(desc, rec.crc);
+        put_u32(desc, rec.compressed);
+        put_u32(desc, rec.uncompressed);
+        write_raw(desc.data(), desc.size());
+        entry_open = false;
+    }
+
+    // Whole small entry in one go (workbook-level parts).
+    void add_entry(std::string_view name, std::string_view content) {
+        begin_entry(name);
+        entry_write(content);
+        end_entry();
+    }
+
+    void central_directory() {
+        const std::uint32_t dir_offset = offset;
+        std::string dir;
+        for (const EntryRecord& rec : entries) {
+            put_u32(dir, 0x02014b50); // central directory header
+            put_u16(dir, 20);         // version made by
+            put_u16(dir, 20);         // version needed
+            put_u16(dir, 0x0808);
+            put_u16(dir, 8);
+            put_u16(dir, 0); // mod time
+            put_u16(dir, 0); // mod date
+            put_u32(dir, rec.crc);
+            put_u32(dir, rec.compressed);
+            put_u32(dir, rec.uncompressed);
+            put_u16(dir, static_cast<std::uint16_t>(rec.name.size()));
+            put_u16(dir, 0); // extra
+            put_u16(dir, 0); // comment
+            put_u16(dir, 0); // disk
+            put_u16(dir, 0); // internal attrs
+            put_u32(dir, 0); // external attrs
+            put_u32(dir, rec.offset);
+            dir.append(rec.name);
+        }
+        const std::uint32_t dir_size = static_cast<std::uint32_t>(dir.size());
+        put_u32(dir, 0x06054b50); // end of central directory
+        put_u16(dir, 0);          // disk
+        put_u16(dir, 0);          // directory disk
+        put_u16(dir, static_cast<std::uint16_t>(entries.size()));
+        put_u16(dir, static_cast<std::uint16_t>(entries.size()));
+        put_u32(dir, dir_size);
+        put_u32(dir, dir_offset);
+        put_u16(dir, 0); // comment
+        write_raw(dir.data(), dir.size());
+    }
+};
+
+XlsxWriter::XlsxWriter(const std::string& path) : impl_(new Impl) {
+    impl_->fd =
+        ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (impl_->fd < 0)
+        throw std::runtime_error("xlsx writer: cannot create " + path);
+}
+
+XlsxWriter::~XlsxWriter() {
+    try {
+        if (!impl_->finished)
+            finish();
+    } catch (...) {
+        // Destructor cleanup: leave a truncated file rather than throw.
+    }
+    if (impl_->fd >= 0)
+        ::close(impl_->fd);
+}
+
+void XlsxWriter::begin_sheet(std::string_view name) {
+    if (impl_->sheet_open)
+        end_sheet();
+    impl_->sheet_names.emplace_back(name);
+    impl_->begin_entry("xl/worksheets/sheet" +
+                       std::to_string(impl_->sheet_names.size()) + ".xml");
+    impl_->pending =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>"
+        "<worksheet xmlns=\"http://schemas.openxmlformats.org/"
+        "spreadsheetml/2006/main\"><sheetData>";
+    impl_->sheet_open = true;
+    impl_->next_row = 1;
+}
+
+void XlsxWriter::add_row(std::span<const Cell> cells) {
+    std::string& out = impl_->pending;
+    const std::uint32_t row = impl_->next_row++;
+    out += "<row r=\"";
+    out += std::to_string(row);
+    out += "\">";
+    for (std::uint32_t col = 0; col < cells.size(); ++col) {
+        const Cell& cell = cells[col];
+        if (cell.type == Cell::Type::Empty)
+            continue;
+        out += "<c r=\"";
+        column_letters(col, out);
+        out += std::to_string(row);
+        if (cell.type == Cell::Type::Number) {
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "%.17g", cell.number);
+            out += "\"><v>";
+            out += buf;
+            out += "</v></c>";
+        } else {
+            // Whitespace-edged text needs xml:space or consumers trim it.
+            const bool preserve =
+                !cell.text.empty() &&
+                (cell.text.front() == ' ' || cell.text.back() == ' ');
+            out += preserve ? "\" t=\"inlineStr\"><is><t xml:space=\"preserve\">"
+                            : "\" t=\"inlineStr\"><is><t>";
+            xml_escape_into(out, cell.text);
+            out += "</t></is></c>";
+        }
+    }
+    out += "</row>";
+    impl_->flush_pending(kBuf);
+}
+
+void XlsxWriter::end_sheet() {
+    impl_->pending += "</sheetData></worksheet>";
+    impl_->end_entry();
+    impl_->sheet_open = false;
+}
+
+void XlsxWriter::finish() {
+    if (impl_->sheet_open)
+        end_sheet();
+
+    std::string workbook =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>"
+        "<workbook xmlns=\"http://schemas.openxmlformats.org/"
+        "spreadsheetml/2006/main\" xmlns:r=\"http://schemas.openxmlformats."
+        "org/officeDocument/2006/relationships\"><sheets>";
+    std::string rels =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>"
+        "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/"
+        "2006/relationships\">";
+    std::string types =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>"
+        "<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/"
+        "content-types\"><Default Extension=\"rels\" ContentType=\"application"
+        "/vnd.openxmlformats-package.relationships+xml\"/><Default "
+        "Extension=\"xml\" ContentType=\"application/xml\"/><Override "
+        "PartName=\"/xl/workbook.xml\" ContentType=\"application/vnd."
+        "openxmlformats-officedocument.spreadsheetml.sheet.main+xml\"/>";
+    for (std::size_t i = 0; i < impl_->sheet_names.size(); ++i) {
+        const std::string id = std::to_string(i + 1);
+        workbook += "<sheet name=\"";
+        xml_escape_into(workbook, impl_->sheet_names[i]);
+        workbook += "\" sheetId=\"" + id + "\" r:id=\"rId" + id + "\"/>";
+        rels += "<Relationship Id=\"rId" + id +
+                "\" Type=\"http://schemas.openxmlformats.org/officeDocument/"
+                "2006/relationships/worksheet\" Target=\"worksheets/sheet" +
+                id + ".xml\"/>";
+        types += "<Override PartName=\"/xl/worksheets/sheet" + id +
+                 ".xml\" ContentType=\"application/vnd.openxmlformats-"
+                 "officedocument.spreadsheetml.worksheet+xml\"/>";
+    }
+    workbook += "</sheets></workbook>";
+    rels += "</Relationships>";
+    types += "</Types>";
+
+    impl_->add_entry("[Content_Types].xml", types);
+    impl_->add_entry(
+        "_rels/.rels",
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>"
+        "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/"
+        "2006/relationships\"><Relationship Id=\"rId1\" Type=\"http://"
+        "schemas.openxmlformats.org/officeDocument/2006/relationships/"
+        "officeDocument\" Target=\"xl/workbook.xml\"/></Relationships>");
+    impl_->add_entry("xl/workbook.xml", workbook);
+    impl_->add_entry("xl/_rels/workbook.xml.rels", rels);
+    impl_->central_directory();
+    impl_->finished = true;
+}
+
+void XlsxWriter::write_cache(const std::string& path,
+                             const ColumnarCache& cache) {
+    XlsxWriter writer(path);
+    std::vector<Cell> row;
+    for (const ColumnarCache::Sheet& sheet : cache.sheets()) {
+        writer.begin_sheet(sheet.name);
+        row.clear();
+        for (const ColumnarCache::Column& col : sheet.columns)
+            row.push_back(Cell::str(col.name));
+        writer.add_row(row);
+        for (std::uint64_t r = 0; r < sheet.rows; ++r) {
+            row.clear();
+            for (const ColumnarCache::Column& col : sheet.columns) {
+                if (col.type == ColumnarCache::ColumnType::Number) {
+                    const double v = col.numbers[r];
+                    row.push_back(std::isnan(v) ? Cell::empty()
+                                                : Cell::num(v));
+                } else {
+                    const std::uint32_t id = col.strings[r];
+                    row.push_back(id == ColumnarCache::kNoString
+                                      ? Cell::empty()
+                                      : Cell::str(cache.string_at(id)));
+                }
+            }
+            writer.add_row(row);
+        }
+        writer.end_sheet();
+    }
+    writer.finish();
+}
+
+} // namespace intake
@@ -0,0 +1,206 @@
+#include "intake/xml_scan.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define INTAKE_X86 1
+#endif
+
+namespace intake::xmlscan {
+
+namespace {
+
+const char* find_byte_scalar(const char* p, const char* end, char b) {
+    while (p != end && *p != b)
+        ++p;
+    return p;
+}
+
+const char* find_any2_scalar(const char* p, const char* end, char a, char b) {
+    while (p != end && *p != a && *p != b)
+        ++p;
+    return p;
+}
+
+bool is_structural(char c) {
+    return c == '<' || c == '>' || c == '"' || c == '&';
+}
+
+const char* find_structural_scalar(const char* p, const char* end) {
+    while (p != end && !is_structural(*p))
+        ++p;
+    return p;
+}
+
+#ifdef INTAKE_X86
+
+bool have_avx2() {
+    static const bool v = __builtin_cpu_supports("avx2");
+    return v;
+}
+
+__attribute__((target("avx2"))) const char*
+find_byte_avx2(const char* p, const char* end, char b) {
+    const __m256i needle = _mm256_set1_epi8(b);
+    while (end - p >= 32) {
+        const __m256i chunk =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const int mask =
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle));
+        if (mask != 0)
+            return p + __builtin_ctz(static_cast<unsigned>(mask));
+        p += 32;
+    }
+    return find_byte_scalar(p, end, b);
+}
+
+const char* find_byte_sse2(const char* p, const char* end, char b) {
+    const __m128i needle = _mm_set1_epi8(b);
+    while (end - p >= 16) {
+        const __m128i chunk =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle));
+        if (mask != 0)
+            return p + __builtin_ctz(static_cast<unsigned>(mask));
+        p += 16;
+    }
+    return find_byte_scalar(p, end, b);
+}
+
+__attribute__((target("avx2"))) const char*
+find_any2_avx2(const char* p, const char* end, char a, char b) {
+    const __m256i na = _mm256_set1_epi8(a);
+    const __m256i nb = _mm256_set1_epi8(b);
+    while (end - p >= 32) {
+        const __m256i chunk =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const __m256i hit = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, na),
+                                            _mm256_cmpeq_epi8(chunk, nb));
+        const int mask = _mm256_movemask_epi8(hit);
+        if (mask != 0)
+            return p + __builtin_ctz(static_cast<unsigned>(mask));
+        p += 32;
+    }
+    return find_any2_scalar(p, end, a, b);
+}
+
+const char* find_any2_sse2(const char* p, const char* end, char a, char b) {
+    const __m128i na = _mm_set1_epi8(a);
+    const __m128i nb = _mm_set1_epi8(b);
+    while (end - p >= 16) {
+        const __m128i chunk =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(chunk, na),
+                                         _mm_cmpeq_epi8(chunk, nb));
+        const int mask = _mm_movemask_epi8(hit);
+        if (mask != 0)
+            return p + __builtin_ctz(static_cast<unsigned>(mask));
+        p += 16;
+    }
+    return find_any2_scalar(p, end, a, b);
+}
+
+// Byte-class lookup: pshufb over the low nibble yields a class byte that is
+// checked against the high nibble, flagging '<' (0x3C), '>' (0x3E),
+// '"' (0x22) and '&' (0x26) in one shuffle. All four structurals have high
+// nibbles 2 or 3, so the table stores that nibble's expected value + marker.
+__attribute__((target("avx2"))) const char*
+find_structural_avx2(const char* p, const char* end) {
+    // low nibble -> bitmask of high nibbles (bit n set => high nibble n
+    // makes the byte structural).  0x22 '"' -> low 2, high 2; 0x26 '&' ->
+    // low 6, high 2; 0x3C '<' -> low C, high 3; 0x3E '>' -> low E, high 3.
+    const __m256i low_table = _mm256_setr_epi8(
+        0, 0, 1 << 2, 0, 0, 0, 1 << 2, 0, 0, 0, 0, 0, 1 << 3, 0, 1 << 3, 0,
+        0, 0, 1 << 2, 0, 0, 0, 1 << 2, 0, 0, 0, 0, 0, 1 << 3, 0, 1 << 3, 0);
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    while (end - p >= 32) {
+        const __m256i chunk =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const __m256i lo = _mm256_and_si256(chunk, low_mask);
+        const __m256i classes = _mm256_shuffle_epi8(low_table, lo);
+        // high nibble as a single bit: 1 << (c >> 4), via a second shuffle.
+        const __m256i hi =
+            _mm256_and_si256(_mm256_srli_epi16(chunk, 4), low_mask);
+        const __m256i hi_bits = _mm256_shuffle_epi8(
+            _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0,
+                             0, 0, 1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0,
+                             0, 0, 0, 0),
+            hi);
+        const __m256i hit = _mm256_cmpeq_epi8(
+            _mm256_and_si256(classes, hi_bits), _mm256_setzero_si256());
+        const int mask = ~_mm256_movemask_epi8(hit);
+        if (mask != 0)
+            return p + __builtin_ctz(static_cast<unsigned>(mask));
+        p += 32;
+    }
+    return find_structural_scalar(p, end);
+}
+
+const char* find_structural_sse2(const char* p, const char* end) {
+    const __m128i lt = _mm_set1_epi8('<');
+    const __m128i gt = _mm_set1_epi8('>');
+    const __m128i qt = _mm_set1_epi8('"');
+    const __m128i amp = _mm_set1_epi8('&');
+    while (end - p >= 16) {
+        const __m128i chunk =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i hit = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, lt), _mm_cmpeq_epi8(chunk, gt)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, qt),
+                         _mm_cmpeq_epi8(chunk, amp)));
+        const int mask = _mm_movemask_epi8(hit);
+        if (mask != 0)
+            return p + __builtin_ctz(static_cast<unsigned>(mask));
+        p += 16;
+    }
+    return find_structural_scalar(p, end);
+}
+
+#endif // INTAKE_X86
+
+} // namespace
+
+const char* find_byte(const char* p, const char* end, char b) {
+#ifdef INTAKE_X86
+    return have_avx2() ? find_byte_avx2(p, end, b) : find_byte_sse2(p, end, b);
+#else
+    return find_byte_scalar(p, end, b);
+#endif
+}
+
+const char* find_any2(const char* p, const char* end, char a, char b) {
+#ifdef INTAKE_X86
+    return have_avx2() ? find_any2_avx2(p, end, a, b)
+                       : find_any2_sse2(p, end, a, b);
+#else
+    return find_any2_scalar(p, end, a, b);
+#endif
+}
+
+const char* find_structural(const char* p, const char* end) {
+#ifdef INTAKE_X86
+    return have_avx2() ? find_structural_avx2(p, end)
+                       : find_structural_sse2(p, end);
+#else
+    return find_structural_scalar(p, end);
+#endif
+}
+
+bool parse_cell_ref(std::string_view ref, std::uint32_t& row,
+                    std::uint32_t& col) {
+    std::size_t i = 0;
+    std::uint32_t c = 0;
+    while (i < ref.size() && ref[i] >= 'A' && ref[i] <= 'Z')
+        c = c * 26 + static_cast<std::uint32_t>(ref[i++] - 'A' + 1);
+    if (c == 0 || i == ref.size())
+        return false;
+    std::uint32_t r = 0;
+    while (i < ref.size() && ref[i] >= '0' && ref[i] <= '9')
+        r = r * 10 + static_cast<std::uint32_t>(ref[i++] - '0');
+    if (i != ref.size() || r == 0)
+        return false;
+    row = r;
+    col = c - 1;
+    return true;
+}
+
+} // namespace intake::xmlscan
@@ -0,0 +1,128 @@
+#include "intake/zip_reader.hpp"
+
+#include <zlib.h>
+
+#include <cstring>
+#include <stdexcept>
+
+namespace intake {
+
+namespace {
+
+constexpr std::uint32_t kEocdSig = 0x06054b50;    // end of central directory
+constexpr std::uint32_t kCentralSig = 0x02014b50; // central directory entry
+constexpr std::uint32_t kLocalSig = 0x04034b50;   // local file header
+
+std::uint16_t rd16(const unsigned char* p) {
+    return static_cast<std::uint16_t>(p[0] | (p[1] << 8));
+}
+
+std::uint32_t rd32(const unsigned char* p) {
+    return static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8) |
+           (static_cast<std::uint32_t>(p[2]) << 16) |
+           (static_cast<std::uint32_t>(p[3]) << 24);
+}
+
+} // namespace
+
+ZipReader::ZipReader(const MmapFile& file) : file_(file) {
+    const unsigned char* base = file.data();
+    const std::size_t size = file.size();
+    if (size < 22)
+        throw std::runtime_error("zip: file too small");
+
+    // The end-of-central-directory record sits in the last 64 KiB + 22 bytes
+    // (the trailing comment has a 16-bit length). Scan backwards for it.
+    const std::size_t scan_limit = size >= 22 + 0xffff ? size - 22 - 0xffff : 0;
+    std::size_t eocd = size - 22;
+    while (true) {
+        if (rd32(base + eocd) == kEocdSig)
+            break;
+        if (eocd == scan_limit)
+            throw std::runtime_error("zip: end of central directory not found");
+        --eocd;
+    }
+
+    const std::uint16_t count = rd16(base + eocd + 10);
+    const std::uint32_t cd_size = rd32(base + eocd + 12);
+    const std::uint32_t cd_offset = rd32(base + eocd + 16);
+    if (static_cast<std::uint64_t>(cd_offset) + cd_size > size)
+        throw std::runtime_error("zip: central directory out of range");
+
+    entries_.reserve(count);
+    const unsigned char* p = base + cd_offset;
+    const unsigned char* cd_end = p + cd_size;
+    for (std::uint16_t i = 0; i < count; ++i) {
+        if (p + 46 > cd_end || rd32(p) != kCentralSig)
+            throw std::runtime_error("zip: bad central directory entry");
+        Entry e;
+        e.method = rd16(p + 10);
+        e.compressed_size = rd32(p + 20);
+        e.uncompressed_size = rd32(p + 24);
+        const std::uint16_t name_len = rd16(p + 28);
+        const std::uint16_t extra_len = rd16(p + 30);
+        const std::uint16_t comment_len = rd16(p + 32);
+        const std::uint32_t local_off = rd32(p + 42);
+        e.name = std::string_view(reinterpret_cast<const char*>(p + 46), name_len);
+
+        // Resolve the payload offset through the local header: its name/extra
+        // lengths can differ from the central directory's copies.
+        if (static_cast<std::uint64_t>(local_off) + 30 > size ||
+            rd32(base + local_off) != kLocalSig)
+            throw std::runtime_error("zip: bad local header");
+        const std::uint16_t l_name = rd16(base + local_off + 26);
+        const std::uint16_t l_extra = rd16(base + local_off + 28);
+        e.data_offset = static_cast<std::uint64_t>(local_off) + 30 + l_name + l_extra;
+        if (e.data_offset + e.compressed_size > size)
+            throw std::runtime_error("zip: entry payload out of range");
+
+        entries_.push_back(e);
+        p += 46 + name_len + extra_len + comment_len;
+    }
+}
+
+const ZipReader::Entry* ZipReader::find(std::string_view name) const {
+    for (const Entry& e : entries_)
+        if (e.name == name)
+            return &e;
+    return nullptr;
+}
+
+std::string_view ZipReader::read(const Entry& entry,
+                                 std::vector<unsigned char>& out) const {
+    const unsigned char* src = file_.data() + entry.data_offset;
+    if (entry.method == 0) {
+        // Stored: hand back a view straight into the mapping.
+        return std::string_view(reinterpret_cast<const char*>(src),
+                                entry.compressed_size);
+    }
+    if (entry.method != 8)
+        throw std::runtime_error("zip: unsupported compression method");
+
+    out.resize(entry.uncompressed_size);
+    z_stream zs{};
+    // -MAX_WBITS: raw deflate stream, no zlib header, as zip stores it.
+    if (inflateInit2(&zs, -MAX_WBITS) != Z_OK)
+        throw std::runtime_error("zip: inflateInit failed");
+    zs.next_in = const_cast<unsigned char*>(src);
+    zs.avail_in = static_cast<uInt>(entry.compressed_size);
+    zs.next_out = out.data();
+    zs.avail_out = static_cast<uInt>(out.size());
+    const int rc = inflate(&zs, Z_FINISH);
+    inflateEnd(&zs);
+    if (rc != Z_STREAM_END)
+        throw std::runtime_error("zip: inflate failed");
+    out.resize(out.size() - zs.avail_out);
+    return std::string_view(reinterpret_cast<const char*>(out.data()),
+                            out.size());
+}
+
+std::string_view ZipReader::read(std::string_view name,
+                                 std::vector<unsigned char>& out) const {
+    const Entry* e = find(name);
+    if (e == nullptr)
+        throw std::runtime_error("zip: entry not found: " + std::string(name));
+    return read(*e, out);
+}
+
+} // namespace intake
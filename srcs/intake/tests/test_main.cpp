@@ -0,0 +1,296 @@
+// Behavior tests for the pieces where a regression is silent until an event
+// is underway: the concurrency primitives everything else sits on, the
+// digest the blob store keys by, WAL crash recovery, and the PNG predictor
+// paths in the xref-stream decoder. Run via ctest (or the intake_tests
+// binary directly); any failure prints the check and the suite exits 1.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <zlib.h>
+
+#include "intake/blake2b.hpp"
+#include "intake/pdf_extractor.hpp"
+#include "intake/scheduler.hpp"
+#include "intake/score_store.hpp"
+#include "intake/thread_pool.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            std::printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);        \
+            ++failures;                                                        \
+        }                                                                      \
+    } while (0)
+
+// ---------------------------------------------------------------------------
+// ThreadPool: lost-wakeup stress. Many tiny submit/wait_idle cycles keep
+// workers on the wait-predicate edge exactly when submits land; before the
+// wake_mu_ barrier fix this hung within a few hundred rounds.
+
+void test_thread_pool() {
+    for (int round = 0; round < 500; ++round) {
+        intake::ThreadPool pool(4);
+        std::atomic<int> ran{0};
+        for (int i = 0; i < 8; ++i)
+            pool.submit([&] { ++ran; });
+        pool.wait_idle();
+        CHECK(ran == 8);
+        if (ran != 8)
+            return;
+    }
+    // Staggered single submits against a long-lived pool: every worker
+    // asleep, one task arrives.
+    intake::ThreadPool pool(4);
+    std::atomic<int> ran{0};
+    for (int i = 0; i < 10000; ++i) {
+        pool.submit([&] { ++ran; });
+        if (i % 7 == 0)
+            pool.wait_idle();
+    }
+    pool.wait_idle();
+    CHECK(ran == 10000);
+}
+
+// ---------------------------------------------------------------------------
+// Scheduler: submit_after's wiring window. Dependencies that complete while
+// edges are still being registered must neither fire the dependent early
+// nor fire it twice (the double fire called a cleared fn — SIGABRT).
+
+void test_scheduler() {
+    for (int round = 0; round < 200; ++round) {
+        intake::Scheduler sched(4);
+        std::atomic<int> dep_runs{0}, child_runs{0};
+        std::atomic<int> premature{0};
+        for (int i = 0; i < 100; ++i) {
+            intake::Scheduler::TaskId deps[4];
+            std::atomic<int>* done = new std::atomic<int>{0};
+            for (int d = 0; d < 4; ++d)
+                deps[d] = sched.submit([&, done] {
+                    ++*done;
+                    ++dep_runs;
+                });
+            sched.submit_after(deps, [&, done] {
+                if (done->load() != 4)
+                    ++premature;
+                ++child_runs;
+                delete done;
+            });
+        }
+        sched.wait_all();
+        CHECK(dep_runs == 400);
+        CHECK(child_runs == 100);
+        CHECK(premature == 0);
+        if (child_runs != 100 || premature != 0)
+            return;
+    }
+    // Chains whose dependency is always already complete at wiring time.
+    intake::Scheduler sched(2);
+    std::atomic<int> runs{0};
+    intake::Scheduler::TaskId prev = sched.submit([&] { ++runs; });
+    for (int i = 0; i < 2000; ++i) {
+        sched.wait(prev);
+        intake::Scheduler::TaskId deps[1] = {prev};
+        prev = sched.submit_after(deps, [&] { ++runs; });
+    }
+    sched.wait_all();
+    CHECK(runs == 2001);
+}
+
+// ---------------------------------------------------------------------------
+// BLAKE2b-256 against RFC 7693 parameters (verified with an independent
+// implementation), plus the incremental interface splitting at awkward
+// block boundaries.
+
+void test_blake2b() {
+    CHECK(intake::Blake2b::hash("").hex() ==
+          "0e5751c026e543b2e8ab2eb06099daa1d1e5df47778f7787faab45cdf12fe3a8");
+    CHECK(intake::Blake2b::hash("abc").hex() ==
+          "bddd813c634239723171ef3fee98579b94964e3bb1cb3e427262c8c068d52319");
+    std::string bytes;
+    for (int rep = 0; rep < 4; ++rep)
+        for (int c = 0; c < 256; ++c)
+            bytes.push_back(static_cast<char>(c));
+    CHECK(intake::Blake2b::hash(bytes).hex() ==
+          "f1551feeb252c7e60bb362205bd1ac2f70b145260a91d41e8c5d0a187549a5f2");
+    // Incremental = one-shot across block-edge split points (block is 128).
+    for (std::size_t split : {1u, 127u, 128u, 129u, 255u, 256u, 1000u}) {
+        intake::Blake2b inc;
+        inc.update(std::string_view(bytes).substr(0, split));
+        inc.update(std::string_view(bytes).substr(split));
+        CHECK(inc.finish() == intake::Blake2b::hash(bytes));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// ScoreStore: a torn WAL tail (crash mid-batch) must replay every whole
+// record and drop the partial one, not refuse to open or corrupt state.
+
+void test_wal_torn_tail() {
+    const std::string dir = "/tmp/intake_test_wal";
+    fs::remove_all(dir);
+    {
+        intake::ScoreStore store(dir);
+        for (int i = 0; i < 20; ++i)
+            store.append({"team" + std::to_string(i), "judge", "impact",
+                          double(i), std::uint64_t(i)});
+    }
+    // Simulate the crash: append half a record's worth of garbage.
+    {
+        std::ofstream wal(dir + "/scores.wal",
+                          std::ios::binary | std::ios::app);
+        const char torn[] = {0x40, 0x00, 0x00, 0x00, 0x11, 0x22};
+        wal.write(torn, sizeof(torn));
+    }
+    {
+        intake::ScoreStore store(dir);
+        CHECK(store.scores().size() == 20);
+        intake::Score s;
+        CHECK(store.latest("team7", "judge", "impact", s));
+        CHECK(s.value == 7.0);
+        // The tail was truncated, so appending resumes on a record edge.
+        store.append({"team7", "judge", "impact", 9.5, 99});
+    }
+    {
+        intake::ScoreStore store(dir);
+        intake::Score s;
+        CHECK(store.latest("team7", "judge", "impact", s));
+        CHECK(s.value == 9.5);
+        CHECK(store.scores().size() == 20);
+    }
+    fs::remove_all(dir);
+}
+
+// ---------------------------------------------------------------------------
+// PNG predictor paths. A minimal PDF whose xref stream is FlateDecode with
+// /Predictor 12 and every row filtered with a different PNG filter (None,
+// Sub, Up, Average, Paeth); a wrong predictor decodes to garbage offsets
+// and the whole document fails to parse.
+
+void png_filter_row(std::vector<unsigned char>& out, int filter,
+                    const unsigned char* cur, const unsigned char* prev,
+                    std::size_t columns) {
+    out.push_back(static_cast<unsigned char>(filter));
+    for (std::size_t i = 0; i < columns; ++i) {
+        const int raw = cur[i];
+        const int left = i > 0 ? cur[i - 1] : 0;
+        const int up = prev ? prev[i] : 0;
+        const int upleft = (prev && i > 0) ? prev[i - 1] : 0;
+        int pred = 0;
+        switch (filter) {
+        case 0: pred = 0; break;
+        case 1: pred = left; break;
+        case 2: pred = up; break;
+        case 3: pred = (left + up) >> 1; break;
+        case 4: {
+            const int p = left + up - upleft;
+            const int pa = std::abs(p - left), pb = std::abs(p - up),
+                      pc = std::abs(p - upleft);
+            pred = (pa <= pb && pa <= pc) ? left : (pb <= pc ? up : upleft);
+            break;
+        }
+        }
+        out.push_back(static_cast<unsigned char>(raw - pred));
+    }
+}
+
+std::string deflate_bytes(const std::vector<unsigned char>& in) {
+    std::string out(compressBound(in.size()), '\0');
+    uLongf out_len = out.size();
+    compress(reinterpret_cast<Bytef*>(out.data()), &out_len, in.data(),
+             in.size());
+    out.resize(out_len);
+    return out;
+}
+
+void test_png_predictor() {
+    // Body objects first; offsets recorded for the xref stream.
+    std::string pdf = "%PDF-1.5\n";
+    std::vector<std::size_t> offsets(7, 0);
+    const auto add = [&](int num, const std::string& body) {
+        offsets[num] = pdf.size();
+        pdf += std::to_string(num) + " 0 obj " + body + " endobj\n";
+    };
+    add(1, "<< /Type /Catalog /Pages 2 0 R >>");
+    add(2, "<< /Type /Pages /Kids [3 0 R] /Count 1 >>");
+    add(3, "<< /Type /Page /Parent 2 0 R /MediaBox [0 0 612 792] "
+           "/Resources << /Font << /F1 5 0 R >> >> /Contents 4 0 R >>");
+    const std::string content = "BT /F1 12 Tf (paeth ok) Tj ET";
+    add(4, "<< /Length " + std::to_string(content.size()) + " >> stream\n" +
+               content + "\nendstream");
+    add(5, "<< /Type /Font /Subtype /Type1 /BaseFont /Helvetica >>");
+
+    // Xref stream: /W [1 4 1], one row per object 0..6, each row under a
+    // different PNG filter so every predictor path executes.
+    const std::size_t columns = 6;
+    const std::size_t xref_off = pdf.size();
+    std::vector<unsigned char> rows;
+    std::vector<unsigned char> prev_row(columns, 0), row(columns);
+    for (int num = 0; num <= 6; ++num) {
+        const std::uint32_t off =
+            num == 0 ? 0
+                     : static_cast<std::uint32_t>(num == 6 ? xref_off
+                                                           : offsets[num]);
+        row[0] = num == 0 ? 0 : 1; // type: free / in use
+        row[1] = static_cast<unsigned char>(off >> 24);
+        row[2] = static_cast<unsigned char>(off >> 16);
+        row[3] = static_cast<unsigned char>(off >> 8);
+        row[4] = static_cast<unsigned char>(off);
+        row[5] = static_cast<unsigned char>(num == 0 ? 255 : 0); // gen
+        png_filter_row(rows, num % 5, row.data(),
+                       num == 0 ? nullptr : prev_row.data(), columns);
+        prev_row = row;
+    }
+    const std::string packed = deflate_bytes(rows);
+    pdf += "6 0 obj << /Type /XRef /Size 7 /Root 1 0 R /W [1 4 1] "
+           "/Filter /FlateDecode /DecodeParms << /Predictor 12 /Columns 6 >> "
+           "/Length " +
+           std::to_string(packed.size()) + " >> stream\n" + packed +
+           "\nendstream endobj\n";
+    pdf += "startxref\n" + std::to_string(xref_off) + "\n%%EOF\n";
+
+    const std::string path = "/tmp/intake_test_pred.pdf";
+    std::ofstream(path, std::ios::binary) << pdf;
+    intake::ThreadPool pool(2);
+    intake::PdfExtractor extractor(pool);
+    std::string text;
+    try {
+        extractor.extract_file(path, [&](std::uint32_t, std::string_view t) {
+            text.append(t);
+        });
+    } catch (const std::exception& e) {
+        // A broken predictor decodes garbage offsets and parsing throws.
+        std::printf("extract threw: %s\n", e.what());
+    }
+    CHECK(text.find("paeth ok") != std::string::npos);
+    fs::remove(path);
+}
+
+} // namespace
+
+int main() {
+    test_thread_pool();
+    test_scheduler();
+    test_blake2b();
+    test_wal_torn_tail();
+    test_png_predictor();
+    if (failures != 0) {
+        std::printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::puts("all checks passed");
+    return 0;
+}